@@ -0,0 +1,55 @@
+#include "convert.hh"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QFile>
+
+#include "logger.hh"
+#include "config.hh"
+#include "configsnapshot.hh"
+
+
+int convert(QCommandLineParser &parser, QCoreApplication &app) {
+  Q_UNUSED(app)
+
+  if (3 > parser.positionalArguments().size())
+    parser.showHelp(-1);
+
+  QString infile = parser.positionalArguments().at(1);
+  QString outfile = parser.positionalArguments().at(2);
+
+  // Read codeplug, snapshots are detected by content
+  Config config;
+  ErrorStack err;
+  if (ConfigSnapshot::isSnapshot(infile)) {
+    if (! config.readSnapshot(infile, err)) {
+      logError() << "Cannot read codeplug snapshot '" << infile << "': " << err.format();
+      return -1;
+    }
+  } else if (! config.readYAML(infile, err)) {
+    logError() << "Cannot read YAML codeplug '" << infile << "': " << err.format();
+    return -1;
+  }
+
+  // Write codeplug, format is determined by extension or flag
+  if (parser.isSet("yaml") || outfile.endsWith(".yaml") || outfile.endsWith(".yml")) {
+    QFile file(outfile);
+    if (! file.open(QIODevice::WriteOnly)) {
+      logError() << "Cannot write YAML file '" << outfile << "': " << file.errorString();
+      return -1;
+    }
+    QTextStream stream(&file);
+    if (! config.toYAML(stream, err)) {
+      logError() << "Cannot serialize codeplug to YAML file '" << outfile << "': " << err.format();
+      return -1;
+    }
+    stream.flush();
+    file.close();
+  } else if (! config.writeSnapshot(outfile, err)) {
+    logError() << "Cannot write codeplug snapshot '" << outfile << "': " << err.format();
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,9 @@
+#ifndef CONVERT_HH
+#define CONVERT_HH
+
+class QCommandLineParser;
+class QCoreApplication;
+
+int convert(QCommandLineParser &parser, QCoreApplication &app);
+
+#endif // CONVERT_HH
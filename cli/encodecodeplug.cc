@@ -4,23 +4,221 @@
 #include <QCommandLineParser>
 #include <QFile>
 #include <QFileInfo>
+#include <QDir>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QVector>
 
 #include "logger.hh"
 #include "config.hh"
+#include "channel.hh"
+#include "radioid.hh"
+#include "roamingzone.hh"
 #include "radioinfo.hh"
+#include "radiolimits.hh"
 #include "rd5r_codeplug.hh"
+#include "rd5r_limits.hh"
 #include "gd77_codeplug.hh"
+#include "gd77_limits.hh"
 #include "opengd77_codeplug.hh"
+#include "opengd77_limits.hh"
 #include "openrtx_codeplug.hh"
 #include "md390_codeplug.hh"
+#include "md390_limits.hh"
 #include "uv390_codeplug.hh"
+#include "uv390_limits.hh"
 #include "md2017_codeplug.hh"
+#include "md2017_limits.hh"
+#include "dm1701_codeplug.hh"
+#include "dm1701_limits.hh"
 #include "d868uv_codeplug.hh"
+#include "d868uv_limits.hh"
 #include "d878uv_codeplug.hh"
+#include "d878uv_limits.hh"
 #include "d878uv2_codeplug.hh"
+#include "d878uv2_limits.hh"
 #include "d578uv_codeplug.hh"
+#include "d578uv_limits.hh"
 #include "dmr6x2uv_codeplug.hh"
+#include "dmr6x2uv_limits.hh"
 #include "crc32.hh"
+#include "encodingcache.hh"
+
+
+/** Creates an empty codeplug for the given radio. Returns @c nullptr for unknown radios. */
+static Codeplug *
+createCodeplug(RadioInfo::Radio radio) {
+  switch (radio) {
+  case RadioInfo::OpenGD77: return new OpenGD77Codeplug();
+  case RadioInfo::OpenRTX: return new OpenRTXCodeplug();
+  case RadioInfo::RD5R: return new RD5RCodeplug();
+  case RadioInfo::GD77: return new GD77Codeplug();
+  case RadioInfo::MD390: return new MD390Codeplug();
+  case RadioInfo::UV390: return new UV390Codeplug();
+  case RadioInfo::MD2017: return new MD2017Codeplug();
+  case RadioInfo::DM1701: return new DM1701Codeplug();
+  case RadioInfo::D868UVE: return new D868UVCodeplug();
+  case RadioInfo::DMR6X2UV: return new DMR6X2UVCodeplug();
+  case RadioInfo::D878UV: return new D878UVCodeplug();
+  case RadioInfo::D878UVII: return new D878UV2Codeplug();
+  case RadioInfo::D578UV: return new D578UVCodeplug();
+  }
+  return nullptr;
+}
+
+/** Creates the limits for the given radio. Without a connected device, the radio variant is
+ * unknown. Hence the limits of the default variant are used. Returns @c nullptr if there are no
+ * limits for the radio. */
+static RadioLimits *
+createLimits(RadioInfo::Radio radio) {
+  switch (radio) {
+  case RadioInfo::OpenGD77: return new OpenGD77Limits();
+  case RadioInfo::OpenRTX: return nullptr;
+  case RadioInfo::RD5R: return new RD5RLimits();
+  case RadioInfo::GD77: return new GD77Limits();
+  case RadioInfo::MD390: return new MD390Limits({});
+  case RadioInfo::UV390: return new UV390Limits();
+  case RadioInfo::MD2017: return new MD2017Limits();
+  case RadioInfo::DM1701: return new DM1701Limits();
+  case RadioInfo::D868UVE:
+    return new D868UVLimits({ {136., 174.}, {400., 480.} }, { {136., 174.}, {400., 480.} }, "");
+  case RadioInfo::DMR6X2UV:
+    return new DMR6X2UVLimits({ {136., 174.}, {400., 480.} }, { {136., 174.}, {400., 480.} }, "");
+  case RadioInfo::D878UV:
+    return new D878UVLimits({ {136., 174.}, {400., 480.} }, { {136., 174.}, {400., 480.} }, "");
+  case RadioInfo::D878UVII:
+    return new D878UV2Limits({ {136., 174.}, {400., 480.} }, { {136., 174.}, {400., 480.} }, "");
+  case RadioInfo::D578UV:
+    return new D578UVLimits({ {136., 174.}, {400., 480.} }, { {136., 174.}, {400., 480.} }, "");
+  }
+  return nullptr;
+}
+
+
+/** The outcome of encoding the codeplug for a single radio. */
+struct EncodeResult {
+  /** Empty constructor. */
+  EncodeResult() : key(), filename(), cacheKey(), success(false), cached(false), elapsed(0), issues(), error() { }
+
+  /** The radio key. */
+  QString key;
+  /** The output file. */
+  QString filename;
+  /** The key of the codeplug within the cache, empty if the cache is not used. */
+  QString cacheKey;
+  /** If @c true, the codeplug was encoded and written. */
+  bool success;
+  /** If @c true, the codeplug was taken from the cache. */
+  bool cached;
+  /** Time spent for verification, encoding and writing in ms. */
+  qint64 elapsed;
+  /** The issues found during verification. */
+  QList<RadioLimitIssue> issues;
+  /** The error messages, if the target failed. */
+  QString error;
+};
+
+
+/** Verifies, encodes and writes the codeplug for a single radio. Several tasks may run
+ * concurrently on the same frozen configuration, each one creates its own codeplug. If a cache
+ * is given and holds the codeplug, it is copied from there instead of being encoded.
+ * @ingroup dmrconf */
+class EncodeTask: public QRunnable
+{
+public:
+  /** Constructor. */
+  EncodeTask(RadioInfo::Radio radio, Config *config, const Codeplug::Flags &flags, bool verify,
+             bool ignoreLimits, const EncodingCache *cache, EncodeResult &result)
+    : QRunnable(), _radio(radio), _config(config), _flags(flags), _verify(verify),
+      _ignoreLimits(ignoreLimits), _cache(cache), _result(result)
+  {
+    // pass...
+  }
+
+  void run() {
+    QElapsedTimer timer; timer.start();
+    _result.success = encode();
+    _result.elapsed = timer.elapsed();
+  }
+
+protected:
+  /** Performs the actual work. */
+  bool encode() {
+    ErrorStack err;
+
+    if (_verify) {
+      RadioLimits *limits = createLimits(_radio);
+      if (limits) {
+        RadioLimitContext ctx(_ignoreLimits);
+        limits->verifyConfig(_config, ctx);
+        delete limits;
+        for (int i=0; i<ctx.count(); i++)
+          _result.issues.append(ctx.message(i));
+        if (RadioLimitIssue::Critical == ctx.maxSeverity()) {
+          _result.error = "Codeplug does not fit into the radio.";
+          return false;
+        }
+      }
+    }
+
+    if (_cache && (! _result.cacheKey.isEmpty())) {
+      ErrorStack cacheErr;
+      if (_cache->lookup(_result.cacheKey, _result.filename, cacheErr)) {
+        _result.cached = true;
+        return true;
+      }
+      if (! cacheErr.isEmpty())
+        logWarn() << "Cannot use cached codeplug for " << _result.key << ": " << cacheErr.format();
+    }
+
+    Codeplug *codeplug = createCodeplug(_radio);
+    if (nullptr == codeplug) {
+      _result.error = "Unknown radio.";
+      return false;
+    }
+
+    if (! codeplug->encode(_config, _flags, err)) {
+      _result.error = "Cannot encode codeplug: " + err.format();
+      delete codeplug;
+      return false;
+    }
+
+    if (dynamic_cast<AnytoneCodeplug *>(codeplug))
+      codeplug->image(0).sort();
+
+    if (! codeplug->write(_result.filename, err)) {
+      _result.error = "Cannot write output codeplug file '" + _result.filename + "': " + err.format();
+      delete codeplug;
+      return false;
+    }
+
+    delete codeplug;
+
+    // A failing cache is not fatal, the codeplug got written anyway
+    if (_cache && (! _result.cacheKey.isEmpty())
+        && (! _cache->store(_result.cacheKey, _result.filename, err)))
+      logWarn() << "Cannot cache codeplug for " << _result.key << ": " << err.format();
+
+    return true;
+  }
+
+protected:
+  /** The radio to encode the codeplug for. */
+  RadioInfo::Radio _radio;
+  /** The frozen configuration, shared between all tasks. */
+  Config *_config;
+  /** The encoding flags. */
+  Codeplug::Flags _flags;
+  /** If @c true, the configuration gets verified against the radio limits first. */
+  bool _verify;
+  /** If @c true, frequency limits are ignored during verification. */
+  bool _ignoreLimits;
+  /** The cache of encoded codeplugs or @c nullptr. */
+  const EncodingCache *_cache;
+  /** The result, owned by the caller. */
+  EncodeResult &_result;
+};
 
 
 int encodeCodeplug(QCommandLineParser &parser, QCoreApplication &app) {
@@ -37,16 +235,40 @@ int encodeCodeplug(QCommandLineParser &parser, QCoreApplication &app) {
     return -1;
   }
 
-  if (! RadioInfo::hasRadioKey(parser.value("radio").toLower())) {
-    QStringList radios;
-    foreach (RadioInfo info, RadioInfo::allRadios())
-      radios.append(info.key());
-    logError() << "Unknown radio '" << parser.value("radio").toLower() << ".";
-    logError() << "Known radios " << radios.join(", ") << ".";
+  // Several radios may be given as a comma separated list
+  QList<RadioInfo> radios;
+  foreach (QString key, parser.value("radio").toLower().split(",")) {
+    if ((key = key.trimmed()).isEmpty())
+      continue;
+    if (! RadioInfo::hasRadioKey(key)) {
+      QStringList known;
+      foreach (RadioInfo info, RadioInfo::allRadios())
+        known.append(info.key());
+      logError() << "Unknown radio '" << key << ".";
+      logError() << "Known radios " << known.join(", ") << ".";
+      return -1;
+    }
+    RadioInfo info = RadioInfo::byKey(key);
+    bool duplicate = false;
+    foreach (RadioInfo other, radios)
+      duplicate |= (other.id() == info.id());
+    if (! duplicate)
+      radios.append(info);
+  }
+
+  if (radios.isEmpty()) {
+    logError() << "You have to specify the radio using the --radio option.";
     return -1;
   }
 
-  RadioInfo::Radio radio = RadioInfo::byKey(parser.value("radio").toLower()).id();
+  // If several radios are given or the output is a directory, one codeplug is written per radio
+  // into that directory.
+  QString output = parser.positionalArguments().at(2);
+  bool multiTarget = (1 < radios.size()) || QFileInfo(output).isDir();
+  if (multiTarget && (! QDir().mkpath(output))) {
+    logError() << "Cannot create output directory '" << output << "'.";
+    return -1;
+  }
 
   Codeplug::Flags flags;
   flags.updateCodePlug = false;
@@ -80,131 +302,94 @@ int encodeCodeplug(QCommandLineParser &parser, QCoreApplication &app) {
     return -1;
   }
 
-  if (RadioInfo::MD390 == radio) {
-    MD390Codeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::UV390 == radio) {
-    UV390Codeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
+  // Encoded codeplugs are cached by the hash of the configuration, radio, flags and version.
+  EncodingCache *cache = nullptr;
+  QByteArray configHash;
+  if (! parser.isSet("no-cache")) {
+    if (EncodingCache::hashConfig(&config, configHash, err)) {
+      cache = new EncodingCache(parser.value("cache-dir"));
+    } else {
+      logWarn() << "Cannot use codeplug cache: " << err.format();
+      err = ErrorStack();
     }
-  } else if (RadioInfo::MD2017 == radio) {
-    MD2017Codeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::RD5R == radio) {
-    RD5RCodeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::GD77 == radio) {
-    GD77Codeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::OpenGD77 == radio) {
-    OpenGD77Codeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::OpenRTX == radio) {
-    OpenRTXCodeplug codeplug;
-    codeplug.encode(&config, flags, err);
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::D868UVE == radio) {
-    D868UVCodeplug codeplug;
-    if(! codeplug.encode(&config, flags, err)) {
-      logError() << "Cannot encode codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-    codeplug.image(0).sort();
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::D878UV == radio) {
-    D878UVCodeplug codeplug;
-    if (! codeplug.encode(&config, flags, err)) {
-      logError() << "Cannot encode codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-    codeplug.image(0).sort();
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::D878UVII == radio) {
-    D878UV2Codeplug codeplug;
-    if (! codeplug.encode(&config, flags, err)) {
-      logError() << "Cannot encode codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-    codeplug.image(0).sort();
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
+  }
+
+  if (! multiTarget) {
+    EncodeResult result;
+    result.key = radios.first().key();
+    result.filename = output;
+    if (cache)
+      result.cacheKey = EncodingCache::key(configHash, result.key, flags);
+    EncodeTask task(radios.first().id(), &config, flags, false, false, cache, result);
+    task.run();
+    if (cache) {
+      cache->evict();
+      delete cache;
     }
-  } else if (RadioInfo::D578UV == radio) {
-    D578UVCodeplug codeplug;
-    if (! codeplug.encode(&config, flags, err)) {
+    if (! result.success) {
       logError() << "Cannot encode codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
+                 << "' for " << radios.first().name() << ": " << result.error;
       return -1;
     }
-    codeplug.image(0).sort();
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
-    }
-  } else if (RadioInfo::DMR6X2UV == radio) {
-    DMR6X2UVCodeplug codeplug;
-    if (! codeplug.encode(&config, flags, err)) {
-      logError() << "Cannot encode codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
+    if (result.cached)
+      logInfo() << "Written cached codeplug '" << result.filename << "'.";
+    return 0;
+  }
+
+  // All targets share a single frozen copy of the configuration, that is never modified.
+  Config *frozen = config.freeze(err);
+  if (nullptr == frozen) {
+    logError() << "Cannot prepare codeplug for encoding: " << err.format();
+    delete cache;
+    return -1;
+  }
+
+  // Create the shared singletons referenced by the encoders on the main thread, before any
+  // encoder runs.
+  SelectedChannel::get();
+  DefaultRadioID::get();
+  DefaultRoamingZone::get();
+
+  QVector<EncodeResult> results(radios.size());
+  QThreadPool pool;
+  QElapsedTimer timer; timer.start();
+  for (int i=0; i<radios.size(); i++) {
+    results[i].key = radios.at(i).key();
+    results[i].filename = QDir(output).filePath(radios.at(i).key() + ".dfu");
+    if (cache)
+      results[i].cacheKey = EncodingCache::key(configHash, results[i].key, flags);
+    pool.start(new EncodeTask(radios.at(i).id(), frozen, flags, true,
+                              parser.isSet("ignore-limits"), cache, results[i]));
+  }
+  pool.waitForDone();
+  qint64 total = timer.elapsed();
+  delete frozen;
+  if (cache) {
+    cache->evict();
+    delete cache;
+  }
+
+  // Report per-target results
+  int failed = 0;
+  foreach (const EncodeResult &result, results) {
+    foreach (const RadioLimitIssue &issue, result.issues) {
+      switch (issue.severity()) {
+      case RadioLimitIssue::Silent: logDebug() << result.key << ": " << issue.format(); break;
+      case RadioLimitIssue::Hint: logInfo() << result.key << ": " << issue.format(); break;
+      case RadioLimitIssue::Warning: logWarn() << result.key << ": " << issue.format(); break;
+      case RadioLimitIssue::Critical: logError() << result.key << ": " << issue.format(); break;
+      }
     }
-    codeplug.image(0).sort();
-    if (! codeplug.write(parser.positionalArguments().at(2), err)) {
-      logError() << "Cannot write output codeplug file '" << parser.positionalArguments().at(1)
-                 << "': " << err.format();
-      return -1;
+    if (result.success) {
+      logInfo() << result.key << ": Written " << (result.cached ? "cached " : "") << "'"
+                << result.filename << "' in " << result.elapsed << "ms.";
+    } else {
+      logError() << result.key << ": Failed after " << result.elapsed << "ms: " << result.error;
+      failed++;
     }
-  } else {
-    logError() << "Cannot encode codeplug: Unknown radio '" << parser.value("radio") << "'.";
-    return -1;
   }
+  logInfo() << "Encoded " << (results.size()-failed) << " of " << results.size()
+            << " codeplugs in " << total << "ms.";
 
-  return 0;
+  return (failed ? -1 : 0);
 }
@@ -14,6 +14,7 @@
 #include "encodecallsigndb.hh"
 #include "decodecodeplug.hh"
 #include "infofile.hh"
+#include "convert.hh"
 
 #include "uv390_codeplug.hh"
 
@@ -98,6 +99,19 @@ int main(int argc, char *argv[])
                      "auto-enable-roaming",
                      QCoreApplication::translate("main", "Automatically enables roaming if there is a "
                                                          "roaming zone used by any channel.")));
+  parser.addOption(QCommandLineOption(
+                     "resume",
+                     QCoreApplication::translate("main", "Resumes an interrupted transfer from the "
+                                                         "last verified block, if possible.")));
+  parser.addOption(QCommandLineOption(
+                     "no-cache",
+                     QCoreApplication::translate("main", "Disables the cache of encoded codeplugs. "
+                                                         "Every codeplug gets encoded again.")));
+  parser.addOption(QCommandLineOption(
+                     "cache-dir",
+                     QCoreApplication::translate("main", "Specifies the directory of the cache of "
+                                                         "encoded codeplugs."),
+                     QCoreApplication::translate("main", "DIR")));
   parser.addOption(QCommandLineOption(
                      "ignore-limits",
                      QCoreApplication::translate("main", "Disables some limit checks.")));
@@ -108,7 +122,7 @@ int main(int argc, char *argv[])
   parser.addPositionalArgument(
         "command", QCoreApplication::translate(
           "main", "Specifies the command to perform. Either detect, verify, read, write, "
-          "write-db, encode, encode-db, decode or info. Consult the man-page of dmrconf for a "
+          "write-db, encode, encode-db, decode, convert or info. Consult the man-page of dmrconf for a "
           "detailed description of these commands."),
         QCoreApplication::translate("main", "[command]"));
 
@@ -178,6 +192,8 @@ int main(int argc, char *argv[])
     return decodeCodeplug(parser, app);
   if ("info" == command)
     return infoFile(parser, app);
+  if ("convert" == command)
+    return convert(parser, app);
 
   parser.showHelp(-1);
   return -1;
@@ -31,6 +31,8 @@ int readCodeplug(QCommandLineParser &parser, QCoreApplication &app)
 
   QString filename = parser.positionalArguments().at(1);
 
+  radio->setResume(parser.isSet("resume"));
+
   showProgress();
   QObject::connect(radio, &Radio::downloadProgress, updateProgress);
 
@@ -70,6 +70,8 @@ int writeCallsignDB(QCommandLineParser &parser, QCoreApplication &app) {
     return -1;
   }
 
+  radio->setResume(parser.isSet("resume"));
+
   showProgress();
   QObject::connect(radio, &Radio::uploadProgress, updateProgress);
 
@@ -90,20 +90,20 @@ AnytoneCodeplug::ChannelElement::clear() {
 
 unsigned
 AnytoneCodeplug::ChannelElement::rxFrequency() const {
-  return ((unsigned)getBCD8_be(0x0000))*10;
+  return unsigned(get<Fields::RXFrequency>())*10;
 }
 void
 AnytoneCodeplug::ChannelElement::setRXFrequency(unsigned hz) {
-  setBCD8_be(0x0000, hz/10);
+  set<Fields::RXFrequency>(hz/10);
 }
 
 unsigned
 AnytoneCodeplug::ChannelElement::txOffset() const {
-  return ((unsigned)getBCD8_be(0x0004))*10;
+  return unsigned(get<Fields::TXOffset>())*10;
 }
 void
 AnytoneCodeplug::ChannelElement::setTXOffset(unsigned hz) {
-  setBCD8_be(0x0004, hz/10);
+  set<Fields::TXOffset>(hz/10);
 }
 
 unsigned
@@ -129,16 +129,16 @@ AnytoneCodeplug::ChannelElement::setTXFrequency(unsigned hz) {
 
 AnytoneCodeplug::ChannelElement::Mode
 AnytoneCodeplug::ChannelElement::mode() const {
-  return (Mode) getUInt2(0x0008, 0);
+  return (Mode) get<Fields::ChannelMode>();
 }
 void
 AnytoneCodeplug::ChannelElement::setMode(Mode mode) {
-  setUInt2(0x0008, 0, (unsigned)mode);
+  set<Fields::ChannelMode>((unsigned)mode);
 }
 
 Channel::Power
 AnytoneCodeplug::ChannelElement::power() const {
-  switch ((Power)getUInt2(0x0008, 2)) {
+  switch ((Power)get<Fields::PowerSetting>()) {
   case POWER_LOW: return Channel::Power::Low;
   case POWER_MIDDLE: return Channel::Power::Mid;
   case POWER_HIGH: return Channel::Power::High;
@@ -151,50 +151,50 @@ AnytoneCodeplug::ChannelElement::setPower(Channel::Power power) {
   switch (power) {
   case Channel::Power::Min:
   case Channel::Power::Low:
-    setUInt2(0x0008, 2, (unsigned)POWER_LOW);
+    set<Fields::PowerSetting>((unsigned)POWER_LOW);
     break;
   case Channel::Power::Mid:
-    setUInt2(0x0008, 2, (unsigned)POWER_MIDDLE);
+    set<Fields::PowerSetting>((unsigned)POWER_MIDDLE);
     break;
   case Channel::Power::High:
-    setUInt2(0x0008, 2, (unsigned)POWER_HIGH);
+    set<Fields::PowerSetting>((unsigned)POWER_HIGH);
     break;
   case Channel::Power::Max:
-    setUInt2(0x0008, 2, (unsigned)POWER_TURBO);
+    set<Fields::PowerSetting>((unsigned)POWER_TURBO);
     break;
   }
 }
 
 FMChannel::Bandwidth
 AnytoneCodeplug::ChannelElement::bandwidth() const {
-  if (getBit(0x0008, 4))
+  if (get<Fields::WideBandwidth>())
     return FMChannel::Bandwidth::Wide;
   return FMChannel::Bandwidth::Narrow;
 }
 void
 AnytoneCodeplug::ChannelElement::setBandwidth(FMChannel::Bandwidth bw) {
   switch (bw) {
-  case FMChannel::Bandwidth::Narrow: setBit(0x0008, 4, false); break;
-  case FMChannel::Bandwidth::Wide: setBit(0x0008, 4, true); break;
+  case FMChannel::Bandwidth::Narrow: set<Fields::WideBandwidth>(false); break;
+  case FMChannel::Bandwidth::Wide: set<Fields::WideBandwidth>(true); break;
   }
 }
 
 AnytoneCodeplug::ChannelElement::RepeaterMode
 AnytoneCodeplug::ChannelElement::repeaterMode() const {
-  return (RepeaterMode)getUInt2(0x0008, 6);
+  return (RepeaterMode)get<Fields::OffsetDirection>();
 }
 void
 AnytoneCodeplug::ChannelElement::setRepeaterMode(RepeaterMode mode) {
-  setUInt2(0x0008, 6, (unsigned)mode);
+  set<Fields::OffsetDirection>((unsigned)mode);
 }
 
 AnytoneCodeplug::ChannelElement::SignalingMode
 AnytoneCodeplug::ChannelElement::rxSignalingMode() const {
-  return (SignalingMode)getUInt2(0x0009, 0);
+  return (SignalingMode)get<Fields::RXSignaling>();
 }
 void
 AnytoneCodeplug::ChannelElement::setRXSignalingMode(SignalingMode mode) {
-  setUInt2(0x0009, 0, (unsigned)mode);
+  set<Fields::RXSignaling>((unsigned)mode);
 }
 
 Signaling::Code
@@ -222,11 +222,11 @@ AnytoneCodeplug::ChannelElement::setRXTone(Code code) {
 
 AnytoneCodeplug::ChannelElement::SignalingMode
 AnytoneCodeplug::ChannelElement::txSignalingMode() const {
-  return (SignalingMode)getUInt2(0x0009, 2);
+  return (SignalingMode)get<Fields::TXSignaling>();
 }
 void
 AnytoneCodeplug::ChannelElement::setTXSignalingMode(SignalingMode mode) {
-  setUInt2(0x0009, 2, (unsigned)mode);
+  set<Fields::TXSignaling>((unsigned)mode);
 }
 
 Signaling::Code
@@ -254,73 +254,73 @@ AnytoneCodeplug::ChannelElement::setTXTone(Code code) {
 
 bool
 AnytoneCodeplug::ChannelElement::ctcssPhaseReversal() const {
-  return getBit(0x0009, 4);
+  return get<Fields::CTCSSPhaseReversal>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableCTCSSPhaseReversal(bool enable) {
-  setBit(0x0009, 4, enable);
+  set<Fields::CTCSSPhaseReversal>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::rxOnly() const {
-  return getBit(0x0009, 5);
+  return get<Fields::RXOnly>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableRXOnly(bool enable) {
-  setBit(0x0009, 5, enable);
+  set<Fields::RXOnly>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::callConfirm() const {
-  return getBit(0x0009, 6);
+  return get<Fields::CallConfirm>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableCallConfirm(bool enable) {
-  setBit(0x0009, 6, enable);
+  set<Fields::CallConfirm>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::talkaround() const {
-  return getBit(0x0009, 7);
+  return get<Fields::Talkaround>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableTalkaround(bool enable) {
-  setBit(0x0009, 7, enable);
+  set<Fields::Talkaround>(enable);
 }
 
 bool
 AnytoneCodeplug::ChannelElement::txCTCSSIsCustom() const {
-  return CUSTOM_CTCSS_TONE == getUInt8(0x000a);
+  return CUSTOM_CTCSS_TONE == get<Fields::TXCTCSS>();
 }
 Signaling::Code
 AnytoneCodeplug::ChannelElement::txCTCSS() const {
-  return ctcss_num2code(getUInt8(0x000a));
+  return ctcss_num2code(get<Fields::TXCTCSS>());
 }
 void
 AnytoneCodeplug::ChannelElement::setTXCTCSS(Code tone) {
-  setUInt8(0x000a, ctcss_code2num(tone));
+  set<Fields::TXCTCSS>(ctcss_code2num(tone));
 }
 void
 AnytoneCodeplug::ChannelElement::enableTXCustomCTCSS() {
-  setUInt8(0x000a, CUSTOM_CTCSS_TONE);
+  set<Fields::TXCTCSS>(CUSTOM_CTCSS_TONE);
 }
 bool
 AnytoneCodeplug::ChannelElement::rxCTCSSIsCustom() const {
-  return CUSTOM_CTCSS_TONE == getUInt8(0x000b);
+  return CUSTOM_CTCSS_TONE == get<Fields::RXCTCSS>();
 }
 Signaling::Code
 AnytoneCodeplug::ChannelElement::rxCTCSS() const {
-  return ctcss_num2code(getUInt8(0x000b));
+  return ctcss_num2code(get<Fields::RXCTCSS>());
 }
 void
 AnytoneCodeplug::ChannelElement::setRXCTCSS(Code tone) {
-  setUInt8(0x000b, ctcss_code2num(tone));
+  set<Fields::RXCTCSS>(ctcss_code2num(tone));
 }
 void
 AnytoneCodeplug::ChannelElement::enableRXCustomCTCSS() {
-  setUInt8(0x000b, CUSTOM_CTCSS_TONE);
+  set<Fields::RXCTCSS>(CUSTOM_CTCSS_TONE);
 }
 
 Signaling::Code
 AnytoneCodeplug::ChannelElement::txDCS() const {
-  uint16_t code = getUInt16_le(0x000c);
+  uint16_t code = get<Fields::TXDCS>();
   if (512 > code)
     return Signaling::fromDCSNumber(dec_to_oct(code), false);
   return Signaling::fromDCSNumber(dec_to_oct(code-512), true);
@@ -328,16 +328,16 @@ AnytoneCodeplug::ChannelElement::txDCS() const {
 void
 AnytoneCodeplug::ChannelElement::setTXDCS(Code code) {
   if (Signaling::isDCSNormal(code))
-    setUInt16_le(0x000c, oct_to_dec(Signaling::toDCSNumber(code)));
+    set<Fields::TXDCS>(oct_to_dec(Signaling::toDCSNumber(code)));
   else if (Signaling::isDCSInverted(code))
-    setUInt16_le(0x000c, oct_to_dec(Signaling::toDCSNumber(code))+512);
+    set<Fields::TXDCS>(oct_to_dec(Signaling::toDCSNumber(code))+512);
   else
-    setUInt16_le(0x000c, 0);
+    set<Fields::TXDCS>(0);
 }
 
 Signaling::Code
 AnytoneCodeplug::ChannelElement::rxDCS() const {
-  uint16_t code = getUInt16_le(0x000e);
+  uint16_t code = get<Fields::RXDCS>();
   if (512 > code)
     return Signaling::fromDCSNumber(dec_to_oct(code), false);
   return Signaling::fromDCSNumber(dec_to_oct(code-512), true);
@@ -345,74 +345,74 @@ AnytoneCodeplug::ChannelElement::rxDCS() const {
 void
 AnytoneCodeplug::ChannelElement::setRXDCS(Code code) {
   if (Signaling::isDCSNormal(code))
-    setUInt16_le(0x000e, oct_to_dec(Signaling::toDCSNumber(code)));
+    set<Fields::RXDCS>(oct_to_dec(Signaling::toDCSNumber(code)));
   else if (Signaling::isDCSInverted(code))
-    setUInt16_le(0x000e, oct_to_dec(Signaling::toDCSNumber(code))+512);
+    set<Fields::RXDCS>(oct_to_dec(Signaling::toDCSNumber(code))+512);
   else
-    setUInt16_le(0x000e, 0);
+    set<Fields::RXDCS>(0);
 }
 
 double
 AnytoneCodeplug::ChannelElement::customCTCSSFrequency() const {
-  return ((double) getUInt16_le(0x0010))/10;
+  return ((double) get<Fields::CustomCTCSS>())/10;
 }
 void
 AnytoneCodeplug::ChannelElement::setCustomCTCSSFrequency(double hz) {
-  setUInt16_le(0x0010, hz*10);
+  set<Fields::CustomCTCSS>(hz*10);
 }
 
 unsigned
 AnytoneCodeplug::ChannelElement::twoToneDecodeIndex() const {
-  return getUInt16_le(0x0012);
+  return get<Fields::TwoToneDecodeIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setTwoToneDecodeIndex(unsigned idx) {
-  setUInt16_le(0x0012, idx);
+  set<Fields::TwoToneDecodeIndex>(idx);
 }
 
 unsigned
 AnytoneCodeplug::ChannelElement::contactIndex() const {
-  return getUInt32_le(0x0014);
+  return get<Fields::ContactIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setContactIndex(unsigned idx) {
-  return setUInt32_le(0x0014, idx);
+  set<Fields::ContactIndex>(idx);
 }
 
 unsigned
 AnytoneCodeplug::ChannelElement::radioIDIndex() const {
-  return getUInt8(0x0018);
+  return get<Fields::RadioIDIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setRadioIDIndex(unsigned idx) {
-  return setUInt8(0x0018, idx);
+  set<Fields::RadioIDIndex>(idx);
 }
 
 AnytoneFMChannelExtension::SquelchMode
 AnytoneCodeplug::ChannelElement::squelchMode() const {
-  return (AnytoneFMChannelExtension::SquelchMode)getUInt3(0x0019, 4);
+  return (AnytoneFMChannelExtension::SquelchMode)get<Fields::Squelch>();
 }
 void
 AnytoneCodeplug::ChannelElement::setSquelchMode(AnytoneFMChannelExtension::SquelchMode mode) {
-  setUInt3(0x0019, 4, (unsigned)mode);
+  set<Fields::Squelch>((unsigned)mode);
 }
 
 AnytoneCodeplug::ChannelElement::Admit
 AnytoneCodeplug::ChannelElement::admit() const {
-  return (Admit)getUInt2(0x001a, 0);
+  return (Admit)get<Fields::AdmitCriterion>();
 }
 void
 AnytoneCodeplug::ChannelElement::setAdmit(Admit admit) {
-  setUInt2(0x001a, 0, (unsigned)admit);
+  set<Fields::AdmitCriterion>((unsigned)admit);
 }
 
 AnytoneCodeplug::ChannelElement::OptSignaling
 AnytoneCodeplug::ChannelElement::optionalSignaling() const {
-  return (OptSignaling)getUInt2(0x001a, 4);
+  return (OptSignaling)get<Fields::OptionalSignaling>();
 }
 void
 AnytoneCodeplug::ChannelElement::setOptionalSignaling(OptSignaling sig) {
-  setUInt2(0x001a, 4, (unsigned)sig);
+  set<Fields::OptionalSignaling>((unsigned)sig);
 }
 
 bool
@@ -421,11 +421,11 @@ AnytoneCodeplug::ChannelElement::hasScanListIndex() const {
 }
 unsigned
 AnytoneCodeplug::ChannelElement::scanListIndex() const {
-  return getUInt8(0x001b);
+  return get<Fields::ScanListIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setScanListIndex(unsigned idx) {
-  setUInt8(0x001b, idx);
+  set<Fields::ScanListIndex>(idx);
 }
 void
 AnytoneCodeplug::ChannelElement::clearScanListIndex() {
@@ -438,11 +438,11 @@ AnytoneCodeplug::ChannelElement::hasGroupListIndex() const {
 }
 unsigned
 AnytoneCodeplug::ChannelElement::groupListIndex() const {
-  return getUInt8(0x001c);
+  return get<Fields::GroupListIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setGroupListIndex(unsigned idx) {
-  setUInt8(0x001c, idx);
+  set<Fields::GroupListIndex>(idx);
 }
 void
 AnytoneCodeplug::ChannelElement::clearGroupListIndex() {
@@ -451,99 +451,99 @@ AnytoneCodeplug::ChannelElement::clearGroupListIndex() {
 
 unsigned
 AnytoneCodeplug::ChannelElement::twoToneIDIndex() const {
-  return getUInt8(0x001d);
+  return get<Fields::TwoToneIDIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setTwoToneIDIndex(unsigned idx) {
-  setUInt8(0x001d, idx);
+  set<Fields::TwoToneIDIndex>(idx);
 }
 unsigned
 AnytoneCodeplug::ChannelElement::fiveToneIDIndex() const {
-  return getUInt8(0x001e);
+  return get<Fields::FiveToneIDIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setFiveToneIDIndex(unsigned idx) {
-  setUInt8(0x001e, idx);
+  set<Fields::FiveToneIDIndex>(idx);
 }
 unsigned
 AnytoneCodeplug::ChannelElement::dtmfIDIndex() const {
-  return getUInt8(0x001f);
+  return get<Fields::DTMFIDIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setDTMFIDIndex(unsigned idx) {
-  setUInt8(0x001f, idx);
+  set<Fields::DTMFIDIndex>(idx);
 }
 
 unsigned
 AnytoneCodeplug::ChannelElement::colorCode() const {
-  return getUInt8(0x0020);
+  return get<Fields::ColorCode>();
 }
 void
 AnytoneCodeplug::ChannelElement::setColorCode(unsigned code) {
-  setUInt8(0x0020, code);
+  set<Fields::ColorCode>(code);
 }
 
 DMRChannel::TimeSlot
 AnytoneCodeplug::ChannelElement::timeSlot() const {
-  if (false == getBit(0x0021, 0))
+  if (false == get<Fields::TimeSlot2>())
     return DMRChannel::TimeSlot::TS1;
   return DMRChannel::TimeSlot::TS2;
 }
 void
 AnytoneCodeplug::ChannelElement::setTimeSlot(DMRChannel::TimeSlot ts) {
   if (DMRChannel::TimeSlot::TS1 == ts)
-    setBit(0x0021, 0, false);
+    set<Fields::TimeSlot2>(false);
   else
-    setBit(0x0021, 0, true);
+    set<Fields::TimeSlot2>(true);
 }
 
 bool
 AnytoneCodeplug::ChannelElement::smsConfirm() const {
-  return getBit(0x0021, 1);
+  return get<Fields::SMSConfirm>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableSMSConfirm(bool enable) {
-  setBit(0x0021, 1, enable);
+  set<Fields::SMSConfirm>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::simplexTDMA() const {
-  return getBit(0x0021, 2);
+  return get<Fields::SimplexTDMA>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableSimplexTDMA(bool enable) {
-  setBit(0x0021, 2, enable);
+  set<Fields::SimplexTDMA>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::adaptiveTDMA() const {
-  return getBit(0x0021, 4);
+  return get<Fields::AdaptiveTDMA>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableAdaptiveTDMA(bool enable) {
-  setBit(0x0021, 4, enable);
+  set<Fields::AdaptiveTDMA>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::rxAPRS() const {
-  return getBit(0x0021, 5);
+  return get<Fields::RXAPRS>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableRXAPRS(bool enable) {
-  setBit(0x0021, 5, enable);
+  set<Fields::RXAPRS>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::enhancedEncryption() const {
-  return getBit(0x0021, 6);
+  return get<Fields::EnhancedEncryption>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableEnhancedEncryption(bool enable) {
-  setBit(0x0021, 6, enable);
+  set<Fields::EnhancedEncryption>(enable);
 }
 bool
 AnytoneCodeplug::ChannelElement::loneWorker() const {
-  return getBit(0x0021, 7);
+  return get<Fields::LoneWorker>();
 }
 void
 AnytoneCodeplug::ChannelElement::enableLoneWorker(bool enable) {
-  setBit(0x0021, 7, enable);
+  set<Fields::LoneWorker>(enable);
 }
 
 bool
@@ -552,11 +552,11 @@ AnytoneCodeplug::ChannelElement::hasEncryptionKeyIndex() const {
 }
 unsigned
 AnytoneCodeplug::ChannelElement::encryptionKeyIndex() const {
-  return getUInt8(0x0022);
+  return get<Fields::EncryptionKeyIndex>();
 }
 void
 AnytoneCodeplug::ChannelElement::setEncryptionKeyIndex(unsigned idx) {
-  setUInt8(0x0022, idx);
+  set<Fields::EncryptionKeyIndex>(idx);
 }
 void
 AnytoneCodeplug::ChannelElement::clearEncryptionKeyIndex() {
@@ -642,8 +642,8 @@ AnytoneCodeplug::ChannelElement::toChannelObj(Context &ctx) const {
   }
 
   ch->setName(name());
-  ch->setRXFrequency(rxFrequency()/1e6);
-  ch->setTXFrequency(txFrequency()/1e6);
+  ch->setRXFreq(Frequency::fromHz(rxFrequency()));
+  ch->setTXFreq(Frequency::fromHz(txFrequency()));
   ch->setPower(power());
   ch->setRXOnly(rxOnly());
 
@@ -709,8 +709,8 @@ AnytoneCodeplug::ChannelElement::fromChannelObj(const Channel *c, Context &ctx)
   // set channel name
   setName(c->name());
   // set rx and tx frequencies
-  setRXFrequency(c->rxFrequency()*1e6);
-  setTXFrequency(c->txFrequency()*1e6);
+  setRXFrequency(c->rxFreq().inHz());
+  setTXFrequency(c->txFreq().inHz());
   // set power
   if (c->defaultPower())
     setPower(ctx.config()->settings()->power());
@@ -894,25 +894,39 @@ AnytoneCodeplug::ContactElement::setAlertType(AnytoneContactExtension::AlertType
   setUInt8(0x0027, (unsigned)type);
 }
 
-DMRContact *
-AnytoneCodeplug::ContactElement::toContactObj(Context &ctx) const {
-  Q_UNUSED(ctx);
+AnytoneCodeplug::ContactElement::Record
+AnytoneCodeplug::ContactElement::toRecord() const {
+  Record record;
+  record.type = type();
+  record.name = name();
+  record.number = number();
+  record.alertType = alertType();
+  return record;
+}
 
+DMRContact *
+AnytoneCodeplug::ContactElement::createContact(const Record &record) {
   // Common settings
   DMRContact *cont = new DMRContact();
-  cont->setType(type());
-  cont->setName(name());
-  cont->setNumber(number());
-  cont->setRing(AnytoneContactExtension::AlertType::None != alertType());
+  cont->setType(record.type);
+  cont->setName(record.name);
+  cont->setNumber(record.number);
+  cont->setRing(AnytoneContactExtension::AlertType::None != record.alertType);
 
   // Create AnyTone specific extension
   AnytoneContactExtension *ext = new AnytoneContactExtension();
   cont->setAnytoneExtension(ext);
-  ext->setAlertType(alertType());
+  ext->setAlertType(record.alertType);
 
   return cont;
 }
 
+DMRContact *
+AnytoneCodeplug::ContactElement::toContactObj(Context &ctx) const {
+  Q_UNUSED(ctx);
+  return createContact(toRecord());
+}
+
 bool
 AnytoneCodeplug::ContactElement::fromContactObj(const DMRContact *contact, Context &ctx) {
   Q_UNUSED(ctx)
@@ -3915,6 +3929,9 @@ AnytoneCodeplug::~AnytoneCodeplug() {
 
 void
 AnytoneCodeplug::clear() {
+  // Memory gets reset, the next encoding must be complete
+  untrack();
+
   while (this->numImages())
     remImage(0);
 
@@ -3977,10 +3994,19 @@ AnytoneCodeplug::index(Config *config, Context &ctx, const ErrorStack &err) cons
 
 bool
 AnytoneCodeplug::encode(Config *config, const Flags &flags, const ErrorStack &err) {
-  Context ctx(config);
+  // If the last encoding of this config is tracked, only encode the modified items again
+  if (canEncodeModified(config, flags)) {
+    if (! encodeModified(err)) {
+      errMsg(err) << "Cannot encode anytone codeplug.";
+      return false;
+    }
+    return true;
+  }
 
-  if (! index(config, ctx, err)) {
+  Context *ctx = new Context(config);
+  if (! index(config, *ctx, err)) {
     errMsg(err) << "Cannot encode anytone codeplug.";
+    delete ctx;
     return false;
   }
 
@@ -3992,15 +4018,26 @@ AnytoneCodeplug::encode(Config *config, const Flags &flags, const ErrorStack &er
     this->setBitmaps(config);
     // Then allocate elements
     this->allocateUpdated();
+    this->allocateKept();
     this->allocateForEncoding();
   }
 
-  // Then encode everything.
-  return this->encodeElements(flags, ctx, err);
+  // Then encode everything, recording the elements produced by each item.
+  beginTracking(config, flags);
+  if (! this->encodeElements(flags, *ctx, err)) {
+    untrack();
+    delete ctx;
+    return false;
+  }
+  endTracking(ctx);
+
+  return true;
 }
 
 bool
 AnytoneCodeplug::decode(Config *config, const ErrorStack &err) {
+  // Notify about changes once decoding is complete
+  Config::Transaction transaction(config);
   // Maps code-plug indices to objects
   Context ctx(config);
   return this->decodeElements(ctx, err);
@@ -72,6 +72,86 @@ public:
       FiveTone = 3                ///< Use 5-tone.
     };
 
+    /** Compile-time layout of the fields of the channel element, common to all AnyTone devices. */
+    struct Fields {
+      /** The channel element is 0x40 bytes large. */
+      typedef CodeplugField::Layout<0x0040> Layout;
+      /** RX frequency in 10Hz, 8 BCD digits. */
+      typedef Layout::BCD8_be<0x0000> RXFrequency;
+      /** TX frequency offset in 10Hz, 8 BCD digits. */
+      typedef Layout::BCD8_be<0x0004> TXOffset;
+      /** Channel mode, see @c Mode. */
+      typedef Layout::UInt<0x0008, 0, 2> ChannelMode;
+      /** Power setting, see @c Power. */
+      typedef Layout::UInt<0x0008, 2, 2> PowerSetting;
+      /** Wide bandwidth flag. */
+      typedef Layout::Flag<0x0008, 4> WideBandwidth;
+      /** Direction of the TX offset, see @c RepeaterMode. */
+      typedef Layout::UInt<0x0008, 6, 2> OffsetDirection;
+      /** RX signaling mode, see @c SignalingMode. */
+      typedef Layout::UInt<0x0009, 0, 2> RXSignaling;
+      /** TX signaling mode, see @c SignalingMode. */
+      typedef Layout::UInt<0x0009, 2, 2> TXSignaling;
+      /** CTCSS phase reversal flag. */
+      typedef Layout::Flag<0x0009, 4> CTCSSPhaseReversal;
+      /** RX only flag. */
+      typedef Layout::Flag<0x0009, 5> RXOnly;
+      /** Call confirm flag. */
+      typedef Layout::Flag<0x0009, 6> CallConfirm;
+      /** Talkaround flag. */
+      typedef Layout::Flag<0x0009, 7> Talkaround;
+      /** TX CTCSS tone index. */
+      typedef Layout::UInt8<0x000a> TXCTCSS;
+      /** RX CTCSS tone index. */
+      typedef Layout::UInt8<0x000b> RXCTCSS;
+      /** TX DCS code, +512 if inverted. */
+      typedef Layout::UInt16_le<0x000c> TXDCS;
+      /** RX DCS code, +512 if inverted. */
+      typedef Layout::UInt16_le<0x000e> RXDCS;
+      /** Custom CTCSS frequency in 0.1Hz. */
+      typedef Layout::UInt16_le<0x0010> CustomCTCSS;
+      /** 2-tone decode index. */
+      typedef Layout::UInt16_le<0x0012> TwoToneDecodeIndex;
+      /** Contact index. */
+      typedef Layout::UInt32_le<0x0014> ContactIndex;
+      /** Radio ID index. */
+      typedef Layout::UInt8<0x0018> RadioIDIndex;
+      /** Squelch mode. */
+      typedef Layout::UInt<0x0019, 4, 3> Squelch;
+      /** Admit criterion, see @c Admit. */
+      typedef Layout::UInt<0x001a, 0, 2> AdmitCriterion;
+      /** Optional signaling, see @c OptSignaling. */
+      typedef Layout::UInt<0x001a, 4, 2> OptionalSignaling;
+      /** Scan list index, 0xff=none. */
+      typedef Layout::UInt8<0x001b> ScanListIndex;
+      /** Group list index, 0xff=none. */
+      typedef Layout::UInt8<0x001c> GroupListIndex;
+      /** 2-tone ID index. */
+      typedef Layout::UInt8<0x001d> TwoToneIDIndex;
+      /** 5-tone ID index. */
+      typedef Layout::UInt8<0x001e> FiveToneIDIndex;
+      /** DTMF ID index. */
+      typedef Layout::UInt8<0x001f> DTMFIDIndex;
+      /** Color code. */
+      typedef Layout::UInt8<0x0020> ColorCode;
+      /** Time slot 2 flag. */
+      typedef Layout::Flag<0x0021, 0> TimeSlot2;
+      /** SMS confirm flag. */
+      typedef Layout::Flag<0x0021, 1> SMSConfirm;
+      /** Simplex TDMA flag. */
+      typedef Layout::Flag<0x0021, 2> SimplexTDMA;
+      /** Adaptive TDMA flag. */
+      typedef Layout::Flag<0x0021, 4> AdaptiveTDMA;
+      /** RX APRS flag. */
+      typedef Layout::Flag<0x0021, 5> RXAPRS;
+      /** Enhanced encryption flag. */
+      typedef Layout::Flag<0x0021, 6> EnhancedEncryption;
+      /** Lone worker flag. */
+      typedef Layout::Flag<0x0021, 7> LoneWorker;
+      /** Encryption key index, 0xff=none. */
+      typedef Layout::UInt8<0x0022> EncryptionKeyIndex;
+    };
+
   protected:
     /** Hidden constructor. */
     ChannelElement(uint8_t *ptr, unsigned size);
@@ -351,6 +431,26 @@ public:
     /** Sets the alert type. */
     virtual void setAlertType(AnytoneContactExtension::AlertType type);
 
+    /** The decoded settings of a contact. */
+    struct Record {
+      /** The contact type. */
+      DMRContact::Type type;
+      /** The name of the contact. */
+      QString name;
+      /** The contact number. */
+      unsigned number;
+      /** The alert type. */
+      AnytoneContactExtension::AlertType alertType;
+    };
+
+    /** Decodes this contact into a record. No objects are created, hence several contacts may be
+     * decoded concurrently.
+     * @since 0.11.3 */
+    virtual Record toRecord() const;
+    /** Assembles a @c DigitalContact from a decoded contact.
+     * @since 0.11.3 */
+    static DMRContact *createContact(const Record &record);
+
     /** Assembles a @c DigitalContact from this contact. */
     virtual DMRContact *toContactObj(Context &ctx) const;
     /** Constructs this contact from the give @c DigitalContact. */
@@ -2050,13 +2150,21 @@ protected:
   /** Sets all bitmaps for the given config. */
   virtual void setBitmaps(Config *config) = 0;
 
-  /** Allocate all code-plug elements that must be written back to the device to maintain a working
-   * codeplug. These elements might be updated during encoding. */
+  /** Allocate all code-plug elements that are partially updated during encoding. When updating the
+   * codeplug on the device, these elements must be read first and written back afterwards. */
   virtual void allocateUpdated() = 0;
+  /** Allocate all code-plug elements that are not touched by encoding but are needed for a
+   * complete codeplug (e.g., 5-tone, 2-tone, DTMF and alarm settings). When updating the codeplug
+   * on the device, these elements need neither be read nor written. They only get allocated, when
+   * the codeplug is generated from scratch.
+   * @since 0.11.3 */
+  virtual void allocateKept() = 0;
   /** Allocate all code-plug elements that must be downloaded for decoding. All code-plug elements
    * within the radio that are not represented within the common Config are omitted. */
   virtual void allocateForDecoding() = 0;
-  /** Allocate all code-plug elements that are defined through the common Config. */
+  /** Allocate all code-plug elements that are defined through the common Config. These elements
+   * get overwritten entirely during encoding, hence they need not to be read when updating the
+   * codeplug on the device. */
   virtual void allocateForEncoding() = 0;
 
   /** Encodes the given config (via context) to the binary codeplug. */
@@ -6,12 +6,12 @@ AnytoneLimits::AnytoneLimits(const QString &hardwareRevision, const QString &sup
   // pass...
 }
 
-bool
-AnytoneLimits::verifyConfig(const Config *config, RadioLimitContext &context) const {
-  bool success = RadioLimits::verifyConfig(config, context);
+void
+AnytoneLimits::verifyRadio(RadioLimitContext &context) const {
+  RadioLimits::verifyRadio(context);
 
   if (_hardwareRevision.isEmpty())
-    return success;
+    return;
 
   if (_supportedRevision < _hardwareRevision) {
     auto &msg = context.newMessage(RadioLimitIssue::Warning);
@@ -23,6 +23,4 @@ AnytoneLimits::verifyConfig(const Config *config, RadioLimitContext &context) co
     msg = tr("You are likely using an older hardware reversion (%1) than supported (%2) by qdmr. "
              "The codeplug might be incompatible.").arg(_hardwareRevision, _supportedRevision);
   }
-
-  return success;
 }
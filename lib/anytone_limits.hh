@@ -21,7 +21,7 @@ protected:
                 QObject *parent=nullptr);
 
 public:
-  bool verifyConfig(const Config *config, RadioLimitContext &context) const;
+  void verifyRadio(RadioLimitContext &context) const;
 
 protected:
   /** Holds the hardware revision of the radio. */
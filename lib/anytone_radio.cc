@@ -3,13 +3,19 @@
 #include "d868uv.hh"
 #include "config.hh"
 #include "logger.hh"
+#include "transfercheckpoint.hh"
+#include "codeplugcache.hh"
 
 #define RBSIZE 16
 #define WBSIZE 16
 
+// Number of elements and max. bytes per element to verify the codeplug cache against the device
+#define CACHE_SAMPLES     4
+#define CACHE_SAMPLE_SIZE 0x400
 
-AnytoneRadio::AnytoneRadio(const QString &name, AnytoneInterface *device, QObject *parent)
-  : Radio(parent), _name(name), _dev(device), _codeplugFlags(), _config(nullptr),
+
+AnytoneRadio::AnytoneRadio(const QString &name, RadioInterface *device, QObject *parent)
+  : Radio(parent), _name(name), _dev(device), _codeplugFlags(), _config(),
     _codeplug(nullptr), _callsigns(nullptr)
 {
   // Check if device is open
@@ -24,10 +30,11 @@ AnytoneRadio::~AnytoneRadio() {
     _dev->reboot();
     _dev->close();
   }
-  if (_dev) {
-    _dev->deleteLater();
-    _dev = nullptr;
-  }
+  if (QObject *dev = dynamic_cast<QObject *>(_dev))
+    dev->deleteLater();
+  else if (_dev)
+    delete _dev;
+  _dev = nullptr;
 }
 
 const QString &
@@ -35,6 +42,15 @@ AnytoneRadio::name() const {
   return _name;
 }
 
+QString
+AnytoneRadio::variant() const {
+  AnytoneInterface *dev = dynamic_cast<AnytoneInterface *>(_dev);
+  AnytoneInterface::RadioVariant info;
+  if ((nullptr == dev) || (! dev->getInfo(info)))
+    return QString();
+  return QString("%1/%2").arg(info.version).arg(int(info.bands));
+}
+
 const Codeplug &
 AnytoneRadio::codeplug() const {
   return *_codeplug;
@@ -59,8 +75,10 @@ AnytoneRadio::startDownload(bool blocking, const ErrorStack &err) {
   }
 
   // If non-blocking -> move device to this thread
-  if (_dev && _dev->isOpen())
-    _dev->moveToThread(this);
+  if (_dev && _dev->isOpen()) {
+    if (QObject *dev = dynamic_cast<QObject *>(_dev))
+      dev->moveToThread(this);
+  }
   start();
 
   return true;
@@ -71,7 +89,9 @@ AnytoneRadio::startUpload(Config *config, bool blocking, const Codeplug::Flags &
   if (StatusIdle != _task)
     return false;
 
-  if (! (_config = config))
+  // Encode from a frozen copy, the config may still be edited while uploading.
+  _config = QSharedPointer<Config>((config ? config->freeze(err) : nullptr), &QObject::deleteLater);
+  if (_config.isNull())
     return false;
 
   _task = StatusUpload;
@@ -84,8 +104,10 @@ AnytoneRadio::startUpload(Config *config, bool blocking, const Codeplug::Flags &
   }
 
   // If non-blocking -> move device to this thread
-  if (_dev && _dev->isOpen())
-    _dev->moveToThread(this);
+  if (_dev && _dev->isOpen()) {
+    if (QObject *dev = dynamic_cast<QObject *>(_dev))
+      dev->moveToThread(this);
+  }
   start();
 
   return true;
@@ -107,8 +129,10 @@ AnytoneRadio::startUploadCallsignDB(UserDatabase *db, bool blocking, const Calls
   }
 
   // If non-blocking -> move device to this thread
-  if (_dev && _dev->isOpen())
-    _dev->moveToThread(this);
+  if (_dev && _dev->isOpen()) {
+    if (QObject *dev = dynamic_cast<QObject *>(_dev))
+      dev->moveToThread(this);
+  }
   start();
 
   return true;
@@ -136,7 +160,7 @@ AnytoneRadio::run() {
     _dev->close();
     _task = StatusIdle;
     emit downloadFinished(this, _codeplug);
-    _config = nullptr;
+    _config.reset();
   } else if (StatusUpload == _task) {
     if ((nullptr==_dev) || (! _dev->isOpen())) {
       _task = StatusError;
@@ -228,6 +252,11 @@ AnytoneRadio::download() {
     emit downloadProgress(float(n*100)/_codeplug->image(0).numElements());
   }
 
+  // Remember what was read from the device
+  ErrorStack err;
+  if (! CodeplugCache(name()).store(*_codeplug, err))
+    logWarn() << "Cannot update codeplug cache: " << err.format();
+
   return true;
 }
 
@@ -239,39 +268,50 @@ AnytoneRadio::upload() {
   }
 
   // Download bitmaps first
-  size_t nbitmaps = _codeplug->numImages();
-  for (int n=0; n<_codeplug->image(0).numElements(); n++) {
+  int nbitmaps = _codeplug->image(0).numElements();
+  for (int n=0; n<nbitmaps; n++) {
     unsigned addr = _codeplug->image(0).element(n).address();
     unsigned size = _codeplug->image(0).element(n).data().size();
     if (! _dev->read(0, addr, _codeplug->data(addr), size, _errorStack)) {
       errMsg(_errorStack) << "Cannot read codeplug for update.";
       return false;
     }
-    emit uploadProgress(float(n*25)/_codeplug->image(0).numElements());
+    emit uploadProgress(float(n*25)/nbitmaps);
   }
 
-  // Allocate all memory sections that must be read first
-  // and written back to the device more or less untouched
+  // Allocate all memory sections that get patched during encoding, these must be read first.
+  // Sections not touched by encoding (see allocateKept) are neither read nor written, hence they
+  // remain as they are on the device. Sections overwritten entirely (see allocateForEncoding) are
+  // allocated after reading.
   _codeplug->allocateUpdated();
 
-  // Download new memory sections for update
-  for (int n=nbitmaps; n<_codeplug->image(0).numElements(); n++) {
-    unsigned addr = _codeplug->image(0).element(n).address();
-    unsigned size = _codeplug->image(0).element(n).data().size();
-    if (! _dev->read(0, addr, _codeplug->data(addr), size, _errorStack)) {
-      errMsg(_errorStack) << "Cannot read codeplug for update.";
-      return false;
+  // If the bitmaps and some samples of the device memory match the codeplug cached during the last
+  // transfer, use the cached memory sections instead of reading them again.
+  CodeplugCache cache(name());
+  if (cache.matches(*_codeplug, 0, nbitmaps) &&
+      cache.verify(_dev, *_codeplug, nbitmaps, CACHE_SAMPLES, CACHE_SAMPLE_SIZE) &&
+      cache.restore(*_codeplug, nbitmaps)) {
+    logInfo() << "Use cached codeplug for update.";
+  } else {
+    // Download new memory sections for update
+    for (int n=nbitmaps; n<_codeplug->image(0).numElements(); n++) {
+      unsigned addr = _codeplug->image(0).element(n).address();
+      unsigned size = _codeplug->image(0).element(n).data().size();
+      if (! _dev->read(0, addr, _codeplug->data(addr), size, _errorStack)) {
+        errMsg(_errorStack) << "Cannot read codeplug for update.";
+        return false;
+      }
+      emit uploadProgress(25+float(n*25)/_codeplug->image(0).numElements());
     }
-    emit uploadProgress(25+float(n*25)/_codeplug->image(0).numElements());
   }
 
   // Update bitmaps for all elements representing the common Config
-  _codeplug->setBitmaps(_config);
+  _codeplug->setBitmaps(_config.data());
   // Allocate all memory elements representing the common config
   _codeplug->allocateForEncoding();
 
   // Update binary codeplug from config
-  if (! _codeplug->encode(_config, _codeplugFlags, _errorStack)) {
+  if (! _codeplug->encode(_config.data(), _codeplugFlags, _errorStack)) {
     errMsg(_errorStack) << "Cannot encode codeplug.";
     return false;
   }
@@ -290,6 +330,11 @@ AnytoneRadio::upload() {
     emit uploadProgress(50+float(n*50)/_codeplug->image(0).numElements());
   }
 
+  // Remember what was written to the device
+  ErrorStack err;
+  if (! cache.store(*_codeplug, err))
+    logWarn() << "Cannot update codeplug cache: " << err.format();
+
   return true;
 }
 
@@ -301,14 +346,29 @@ AnytoneRadio::uploadCallsigns() {
 
   size_t totalBlocks = _callsigns->memSize()/WBSIZE;
   size_t blkWritten  = 0;
+
+  // Resume from last verified block, if the same DB was uploaded to the same radio before
+  int n0 = 0; unsigned i0 = 0;
+  TransferCheckpoint checkpoint(name(), TransferCheckpoint::Operation::UploadCallsigns, *_callsigns);
+  if (_resume && checkpoint.restore() && (int(checkpoint.element()) < _callsigns->image(0).numElements())) {
+    n0 = checkpoint.element(); i0 = checkpoint.offset()/WBSIZE;
+    for (int n=0; n<n0; n++)
+      blkWritten += _callsigns->image(0).element(n).data().size()/WBSIZE;
+    blkWritten += i0;
+    logInfo() << "Resume callsign db upload at element " << n0 << ", block " << i0 << ".";
+  }
+
   // Upload all elements back to the device
-  for (int n=0; n<_callsigns->image(0).numElements(); n++) {
+  for (int n=n0; n<_callsigns->image(0).numElements(); n++, i0=0) {
     unsigned addr = _callsigns->image(0).element(n).address();
     unsigned size = _callsigns->image(0).element(n).data().size();
     unsigned nblks = size/WBSIZE;
-    for (unsigned i=0; i<nblks; i++) {
+    for (unsigned i=i0; i<nblks; i++) {
       if (! _dev->write(0, addr+i*WBSIZE, _callsigns->data(addr)+i*WBSIZE, WBSIZE, _errorStack)) {
         errMsg(_errorStack) << "Cannot write callsign db.";
+        checkpoint.update(n, i*WBSIZE);
+        if (checkpoint.isValid() && checkpoint.save(_errorStack))
+          errMsg(_errorStack) << "Upload can be resumed at element " << n << ", block " << i << ".";
         _task = StatusError;
         return false;
       }
@@ -317,5 +377,6 @@ AnytoneRadio::uploadCallsigns() {
     }
   }
 
+  checkpoint.remove();
   return true;
 }
@@ -10,6 +10,7 @@
 #ifndef __ANYTONE_RADIO_HH__
 #define __ANYTONE_RADIO_HH__
 
+#include <QSharedPointer>
 #include "radio.hh"
 #include "anytone_interface.hh"
 #include "anytone_codeplug.hh"
@@ -35,14 +36,20 @@ class AnytoneRadio: public Radio
   Q_OBJECT
 
 protected:
-  /** Do not construct this class directly. */
-  explicit AnytoneRadio(const QString &name, AnytoneInterface *device=nullptr, QObject *parent=nullptr);
+  /** Do not construct this class directly.
+   * @param name Specifies the name of the radio.
+   * @param device Specifies the interface to the radio. Usually an instance of
+   *        @c AnytoneInterface, but any @c RadioInterface that is also a @c QObject (e.g.,
+   *        @c SimulatedRadioInterface) can be used.
+   * @param parent Specifies the QObject parent. */
+  explicit AnytoneRadio(const QString &name, RadioInterface *device=nullptr, QObject *parent=nullptr);
 
 public:
   /** Destructor. */
   virtual ~AnytoneRadio();
 
   const QString &name() const;
+  QString variant() const;
   const Codeplug &codeplug() const;
   Codeplug &codeplug();
 
@@ -74,12 +81,12 @@ protected:
   /** The device identifier. */
   QString _name;
   /** The interface to the radio. */
-  AnytoneInterface *_dev;
+  RadioInterface *_dev;
   /** If @c true, the codeplug on the radio gets updated upon upload. If @c false, it gets
    * overridden. */
   Codeplug::Flags _codeplugFlags;
   /** The generic configuration. */
-  Config *_config;
+  QSharedPointer<Config> _config;
   /** A weak reference to the user-database. */
   UserDatabase *_userDB;
   /** The actual binary codeplug representation. */
@@ -0,0 +1,55 @@
+#include "bitmapiterator.hh"
+#include <QtEndian>
+#include <QtAlgorithms>
+
+
+BitmapIterator::BitmapIterator(const uint8_t *bitmap, unsigned size, bool inverted)
+  : _bitmap(bitmap), _size(size), _inverted(inverted), _word(0), _bits(0), _index(size)
+{
+  if (nullptr == _bitmap)
+    return;
+  _bits = load(0);
+  next();
+}
+
+void
+BitmapIterator::next() {
+  unsigned numWords = (_size+63)/64;
+  // Skip empty words
+  while ((0 == _bits) && ((_word+1) < numWords))
+    _bits = load(++_word);
+  if (0 == _bits) {
+    _index = _size;
+    return;
+  }
+  _index = _word*64 + qCountTrailingZeroBits(_bits);
+  // Clear lowest set bit
+  _bits &= (_bits-1);
+}
+
+uint64_t
+BitmapIterator::load(unsigned word) const {
+  unsigned offset = word*64, bytes = (_size-offset+7)/8;
+  uint64_t bits = 0;
+  if (8 <= bytes) {
+    bits = qFromLittleEndian<quint64>(_bitmap+offset/8);
+  } else {
+    for (unsigned i=0; i<bytes; i++)
+      bits |= uint64_t(_bitmap[offset/8+i]) << (8*i);
+  }
+  if (_inverted)
+    bits = ~bits;
+  // Mask entries beyond the size of the bitmap
+  if (64 > (_size-offset))
+    bits &= (uint64_t(1) << (_size-offset))-1;
+  return bits;
+}
+
+unsigned
+BitmapIterator::count(const uint8_t *bitmap, unsigned size, bool inverted) {
+  BitmapIterator iter(bitmap, size, inverted);
+  unsigned count = 0;
+  for (unsigned w=0; w<(size+63)/64; w++)
+    count += qPopulationCount(quint64(iter.load(w)));
+  return count;
+}
@@ -0,0 +1,60 @@
+#ifndef BITMAPITERATOR_HH
+#define BITMAPITERATOR_HH
+
+#include <cinttypes>
+#include <cstddef>
+
+/** Iterates over the enabled entries of a bitmap as used by many codeplugs to mark the valid
+ * entries of a table (channels, contacts, etc.). Entry @c i is bit @c i%8 of byte @c i/8.
+ *
+ * The bitmap is scanned 64 bits at a time and the next entry is found by counting the trailing
+ * zeros. Hence the iteration costs time proportional to the number of enabled entries and not to
+ * the size of the table. Some bitmaps mark enabled entries with a cleared bit, these are handled
+ * by inverting the bitmap.
+ *
+ * @code
+ * for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+ *   ChannelElement ch(data(CHANNEL_BANK_0 + ... + i.index()*CHANNEL_SIZE));
+ * }
+ * @endcode
+ *
+ * @ingroup util */
+class BitmapIterator
+{
+public:
+  /** Constructs an iterator pointing to the first enabled entry.
+   * @param bitmap Specifies the bitmap.
+   * @param size Specifies the number of entries (bits) in the bitmap.
+   * @param inverted If @c true, an entry is enabled if its bit is cleared. */
+  BitmapIterator(const uint8_t *bitmap, unsigned size, bool inverted=false);
+
+  /** Returns @c true if the iterator points to an enabled entry. */
+  inline bool isValid() const { return _index < _size; }
+  /** Returns the index of the current entry. */
+  inline unsigned index() const { return _index; }
+  /** Advances to the next enabled entry. */
+  void next();
+
+  /** Returns the number of enabled entries in the given bitmap. */
+  static unsigned count(const uint8_t *bitmap, unsigned size, bool inverted=false);
+
+protected:
+  /** Loads the word (64 entries) at the given word-index. Bits beyond the size are cleared. */
+  uint64_t load(unsigned word) const;
+
+protected:
+  /** The bitmap. */
+  const uint8_t *_bitmap;
+  /** The number of entries. */
+  unsigned _size;
+  /** If @c true, cleared bits mark the enabled entries. */
+  bool _inverted;
+  /** The current word-index. */
+  unsigned _word;
+  /** The remaining enabled entries of the current word. */
+  uint64_t _bits;
+  /** The current entry index, @c _size if there are no more entries. */
+  unsigned _index;
+};
+
+#endif // BITMAPITERATOR_HH
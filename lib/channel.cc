@@ -13,6 +13,7 @@
 #include <QDialogButtonBox>
 #include <QDoubleValidator>
 #include <QIntValidator>
+#include <QMutex>
 #include <cmath>
 #include "application.hh"
 #include <QCompleter>
@@ -26,7 +27,7 @@
  * Implementation of Channel
  * ********************************************************************************************* */
 Channel::Channel(QObject *parent)
-  : ConfigObject("ch", parent), _rxFreq(0), _txFreq(0), _defaultPower(true),
+  : ConfigObject("ch", parent), _rxFreq(), _txFreq(), _defaultPower(true),
     _power(Power::Low), _txTimeOut(std::numeric_limits<unsigned>::max()), _rxOnly(false),
     _vox(std::numeric_limits<unsigned>::max()), _scanlist(), _openGD77ChannelExtension(nullptr),
     _tytChannelExtension(nullptr)
@@ -64,7 +65,7 @@ Channel::copy(const ConfigItem &other) {
 void
 Channel::clear() {
   ConfigObject::clear();
-  _rxFreq = 0; _txFreq = 0;
+  _rxFreq = Frequency(); _txFreq = Frequency();
   setDefaultPower();
   setDefaultTimeout();
   _rxOnly = false;
@@ -80,21 +81,39 @@ Channel::clear() {
 
 double
 Channel::rxFrequency() const {
-  return _rxFreq;
+  return _rxFreq.inMHz();
 }
 bool
 Channel::setRXFrequency(double freq) {
+  return setRXFreq(Frequency::fromMHz(freq));
+}
+
+double
+Channel::txFrequency() const {
+  return _txFreq.inMHz();
+}
+bool
+Channel::setTXFrequency(double freq) {
+  return setTXFreq(Frequency::fromMHz(freq));
+}
+
+Frequency
+Channel::rxFreq() const {
+  return _rxFreq;
+}
+bool
+Channel::setRXFreq(Frequency freq) {
   _rxFreq = freq;
   emit modified(this);
   return true;
 }
 
-double
-Channel::txFrequency() const {
+Frequency
+Channel::txFreq() const {
   return _txFreq;
 }
 bool
-Channel::setTXFrequency(double freq) {
+Channel::setTXFreq(Frequency freq) {
   _txFreq = freq;
   emit modified(this);
   return true;
@@ -949,6 +968,9 @@ SelectedChannel::clone() const {
 
 SelectedChannel *
 SelectedChannel::get() {
+  // Encoders running concurrently may request the instance at the same time.
+  static QMutex mutex;
+  QMutexLocker locker(&mutex);
   if (nullptr == SelectedChannel::_instance)
     SelectedChannel::_instance = new SelectedChannel();
   return SelectedChannel::_instance;
@@ -982,31 +1004,26 @@ ChannelList::channel(int idx) const {
 
 DMRChannel *
 ChannelList::findDMRChannel(double rx, double tx, DMRChannel::TimeSlot ts, unsigned cc) const {
-  for (int i=0; i<count(); i++) {
-    if (! _items[i]->is<DMRChannel>())
-      continue;
-    /// @bug I should certainly change the frequency handling to integer values!
-    if ( (1e-6<std::abs(channel(i)->txFrequency()-tx)) ||
-         (1e-6<std::abs(channel(i)->rxFrequency()-rx)) )
-      continue;
-    DMRChannel *digi = channel(i)->as<DMRChannel>();
-    if (digi->timeSlot() != ts)
-      continue;
-    if (digi->colorCode() != cc)
-      continue;
-    return digi;
-  }
+  return findDMRChannel(Frequency::fromMHz(rx), Frequency::fromMHz(tx), ts, cc);
+}
+
+DMRChannel *
+ChannelList::findDMRChannel(Frequency rx, Frequency tx, DMRChannel::TimeSlot ts, unsigned cc) const {
+  DMRKey key = {rx, tx, ts, cc};
+  if (ConfigObject *obj = first(_dmrIndex.values(key)))
+    return obj->as<DMRChannel>();
   return nullptr;
 }
 
 FMChannel *
 ChannelList::findFMChannelByTxFreq(double freq) const {
-  for (int i=0; i<count(); i++) {
-    if (! channel(i)->is<FMChannel>())
-      continue;
-    if (1e-5 > std::abs(channel(i)->txFrequency()-freq))
-      return channel(i)->as<FMChannel>();
-  }
+  return findFMChannelByTxFreq(Frequency::fromMHz(freq));
+}
+
+FMChannel *
+ChannelList::findFMChannelByTxFreq(Frequency freq) const {
+  if (ConfigObject *obj = first(_fmIndex.values(freq)))
+    return obj->as<FMChannel>();
   return nullptr;
 }
 
@@ -1035,3 +1052,42 @@ ChannelList::allocateChild(const YAML::Node &node, ConfigItem::Context &ctx, con
   return nullptr;
 }
 
+void
+ChannelList::insertItem(int row, ConfigObject *obj) {
+  ConfigObjectList::insertItem(row, obj);
+  indexChannel(obj);
+}
+
+void
+ChannelList::removeItem(int row) {
+  unindexChannel(_items.at(row));
+  ConfigObjectList::removeItem(row);
+}
+
+void
+ChannelList::updateItem(int row) {
+  // Frequencies, time slot or color code may have changed
+  unindexChannel(_items.at(row));
+  indexChannel(_items.at(row));
+}
+
+void
+ChannelList::indexChannel(ConfigObject *obj) {
+  if (DMRChannel *dmr = obj->as<DMRChannel>()) {
+    DMRKey key = {dmr->rxFreq(), dmr->txFreq(), dmr->timeSlot(), dmr->colorCode()};
+    _dmrIndex.insert(key, obj);
+    _dmrKeys.insert(obj, key);
+  } else if (FMChannel *fm = obj->as<FMChannel>()) {
+    _fmIndex.insert(fm->txFreq(), obj);
+    _fmKeys.insert(obj, fm->txFreq());
+  }
+}
+
+void
+ChannelList::unindexChannel(ConfigObject *obj) {
+  // Only uses the pointer, the object may already be destroyed.
+  if (_dmrKeys.contains(obj))
+    _dmrIndex.remove(_dmrKeys.take(obj), obj);
+  else if (_fmKeys.contains(obj))
+    _fmIndex.remove(_fmKeys.take(obj), obj);
+}
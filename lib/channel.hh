@@ -7,6 +7,7 @@
 #include "configobject.hh"
 #include "configreference.hh"
 #include "signaling.hh"
+#include "frequency.hh"
 #include "tyt_extensions.hh"
 #include "opengd77_extension.hh"
 #include "anytone_extension.hh"
@@ -85,6 +86,19 @@ public:
   /** (Re-)Sets the TX frequency of the channel in MHz. */
   bool setTXFrequency(double freq);
 
+  /** Returns the exact RX frequency of the channel.
+   * @since 0.11.3 */
+  Frequency rxFreq() const;
+  /** (Re-)Sets the RX frequency of the channel.
+   * @since 0.11.3 */
+  bool setRXFreq(Frequency freq);
+  /** Returns the exact TX frequency of the channel.
+   * @since 0.11.3 */
+  Frequency txFreq() const;
+  /** (Re-)Sets the TX frequency of the channel.
+   * @since 0.11.3 */
+  bool setTXFreq(Frequency freq);
+
   /** Returns @c true if the channel uses the global default power setting. */
   bool defaultPower() const;
   /** Returns the power setting of the channel if the channel does not use the default power. */
@@ -158,10 +172,10 @@ protected slots:
   void onReferenceModified();
 
 protected:
-  /** The RX frequency in MHz. */
-  double _rxFreq;
-  /** The TX frequency in MHz. */
-  double _txFreq;
+  /** The RX frequency. */
+  Frequency _rxFreq;
+  /** The TX frequency. */
+  Frequency _txFreq;
   /** If @c true, the channel uses the global power setting. */
   bool _defaultPower;
   /** The transmit power setting. */
@@ -537,6 +551,11 @@ protected:
  * This class also implements the QAbstractTableModel and can therefore be displayed using a
  * default QTableView instance.
  *
+ * The list keeps hash indices of all digital channels by their frequencies, time slot and color
+ * code and of all analog channels by their TX frequency. These get updated whenever channels are
+ * added, removed or modified. Hence @c findDMRChannel and @c findFMChannelByTxFreq do not need to
+ * scan the list.
+ *
  * @ingroup conf */
 class ChannelList: public ConfigObjectList
 {
@@ -550,13 +569,62 @@ public:
 
   /** Gets the channel at the specified index. */
   Channel *channel(int idx) const;
-  /** Finds a digital channel with the given frequencies, time slot and color code. */
+  /** Finds a digital channel with the given frequencies (in MHz), time slot and color code. */
   DMRChannel *findDMRChannel(double rx, double tx, DMRChannel::TimeSlot ts, unsigned cc) const;
-  /** Finds an analog channel with the given frequency. */
+  /** Finds a digital channel with exactly the given frequencies, time slot and color code.
+   * @since 0.11.3 */
+  DMRChannel *findDMRChannel(Frequency rx, Frequency tx, DMRChannel::TimeSlot ts, unsigned cc) const;
+  /** Finds an analog channel with the given frequency (in MHz). */
   FMChannel *findFMChannelByTxFreq(double freq) const;
+  /** Finds an analog channel with exactly the given TX frequency.
+   * @since 0.11.3 */
+  FMChannel *findFMChannelByTxFreq(Frequency freq) const;
 
 public:
   ConfigItem *allocateChild(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorStack &err=ErrorStack());
+
+protected:
+  void insertItem(int row, ConfigObject *obj);
+  void removeItem(int row);
+  void updateItem(int row);
+
+  /** Adds the given channel to the indices. */
+  void indexChannel(ConfigObject *obj);
+  /** Removes the given channel from the indices. The channel may already be destroyed. */
+  void unindexChannel(ConfigObject *obj);
+
+protected:
+  /** Key of the index of digital channels. */
+  struct DMRKey {
+    /** The RX frequency. */
+    Frequency rx;
+    /** The TX frequency. */
+    Frequency tx;
+    /** The time slot. */
+    DMRChannel::TimeSlot timeSlot;
+    /** The color code. */
+    unsigned colorCode;
+
+    /** Comparison operator. */
+    inline bool operator==(const DMRKey &other) const {
+      return (rx == other.rx) && (tx == other.tx) && (timeSlot == other.timeSlot)
+          && (colorCode == other.colorCode);
+    }
+    /** Hashes the key. */
+    friend inline uint qHash(const DMRKey &key, uint seed=0) {
+      return qHash(key.rx, seed) ^ qHash(key.tx, seed+1) ^ qHash((uint(key.timeSlot)<<4) | key.colorCode, seed);
+    }
+  };
+
+  /** Maps frequencies, time slot and color code to the digital channels. */
+  QMultiHash<DMRKey, ConfigObject *> _dmrIndex;
+  /** Maps each indexed digital channel to its key. Allows for removing channels from the index,
+   * even if the key has changed or the channel was destroyed. */
+  QHash<const ConfigObject *, DMRKey> _dmrKeys;
+  /** Maps TX frequencies to the analog channels. */
+  QMultiHash<Frequency, ConfigObject *> _fmIndex;
+  /** Maps each indexed analog channel to its TX frequency. */
+  QHash<const ConfigObject *, Frequency> _fmKeys;
 };
 
 
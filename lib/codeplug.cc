@@ -2,14 +2,17 @@
 #include "config.hh"
 #include <QtEndian>
 #include "logger.hh"
+#include "utils.hh"
 #include "roamingchannel.hh"
+#include "commercial_extension.hh"
 
 
 /* ********************************************************************************************* *
  * Implementation of CodePlug::Flags
  * ********************************************************************************************* */
 Codeplug::Flags::Flags()
-  : updateCodePlug(true), autoEnableGPS(false), autoEnableRoaming(false)
+  : updateCodePlug(true), autoEnableGPS(false), autoEnableRoaming(false),
+    concurrentEncoding(true)
 {
   // pass...
 }
@@ -440,8 +443,7 @@ Codeplug::Element::getBCD4_be(unsigned offset) const {
     return 0;
   }
 
-  uint32_t val = getUInt16_be(offset);
-  return (val & 0xf) + ((val>>4) & 0xf)*10 + ((val>>8) & 0xf)*100 + ((val>>12) & 0xf)*1000;
+  return CodeplugField::fromBCD(getUInt16_be(offset));
 }
 void
 Codeplug::Element::setBCD4_be(unsigned offset, uint16_t val) {
@@ -450,11 +452,7 @@ Codeplug::Element::setBCD4_be(unsigned offset, uint16_t val) {
     return;
   }
 
-  uint32_t a  = (val / 1000) % 10;
-  uint32_t b  = (val /  100) % 10;
-  uint32_t c  = (val /   10) % 10;
-  uint32_t d  = (val /    1) % 10;
-  setUInt16_be(offset, (a << 12) + (b << 8) + (c << 4) + d);
+  setUInt16_be(offset, CodeplugField::toBCD(val % 10000));
 }
 uint16_t
 Codeplug::Element::getBCD4_le(unsigned offset) const {
@@ -463,8 +461,7 @@ Codeplug::Element::getBCD4_le(unsigned offset) const {
     return 0;
   }
 
-  uint32_t val = getUInt16_le(offset);
-  return (val & 0xf) + ((val>>4) & 0xf)*10 + ((val>>8) & 0xf)*100 + ((val>>12) & 0xf)*1000;
+  return CodeplugField::fromBCD(getUInt16_le(offset));
 }
 void
 Codeplug::Element::setBCD4_le(unsigned offset, uint16_t val) {
@@ -473,11 +470,7 @@ Codeplug::Element::setBCD4_le(unsigned offset, uint16_t val) {
     return;
   }
 
-  uint32_t a  = (val / 1000) % 10;
-  uint32_t b  = (val /  100) % 10;
-  uint32_t c  = (val /   10) % 10;
-  uint32_t d  = (val /    1) % 10;
-  setUInt16_le(offset, (a << 12) + (b << 8) + (c << 4) + d);
+  setUInt16_le(offset, CodeplugField::toBCD(val % 10000));
 }
 
 uint32_t
@@ -487,10 +480,7 @@ Codeplug::Element::getBCD8_be(unsigned offset) const {
     return 0;
   }
 
-  uint32_t val = getUInt32_be(offset);
-  return (val & 0xf) + ((val>>4) & 0xf)*10 + ((val>>8) & 0xf)*100 + ((val>>12) & 0xf)*1000 +
-      ((val>>16) & 0xf)*10000 + ((val>>20) & 0xf)*100000 + ((val>>24) & 0xf)*1000000 +
-      ((val>>28) & 0xf)*10000000;
+  return CodeplugField::fromBCD(getUInt32_be(offset));
 }
 void
 Codeplug::Element::setBCD8_be(unsigned offset, uint32_t val) {
@@ -499,15 +489,7 @@ Codeplug::Element::setBCD8_be(unsigned offset, uint32_t val) {
     return;
   }
 
-  uint32_t a  = (val / 10000000) % 10;
-  uint32_t b  = (val /  1000000) % 10;
-  uint32_t c  = (val /   100000) % 10;
-  uint32_t d  = (val /    10000) % 10;
-  uint32_t e  = (val /     1000) % 10;
-  uint32_t f  = (val /      100) % 10;
-  uint32_t g  = (val /       10) % 10;
-  uint32_t h  = (val /        1) % 10;
-  setUInt32_be(offset, (a << 28) + (b << 24) + (c << 20) + (d << 16) + (e << 12) + (f << 8) + (g << 4) + h);
+  setUInt32_be(offset, CodeplugField::toBCD(val));
 }
 uint32_t
 Codeplug::Element::getBCD8_le(unsigned offset) const {
@@ -516,10 +498,7 @@ Codeplug::Element::getBCD8_le(unsigned offset) const {
     return 0;
   }
 
-  uint32_t val = getUInt32_le(offset);
-  return (val & 0xf) + ((val>>4) & 0xf)*10 + ((val>>8) & 0xf)*100 + ((val>>12) & 0xf)*1000 +
-      ((val>>16) & 0xf)*10000 + ((val>>20) & 0xf)*100000 + ((val>>24) & 0xf)*1000000 +
-      ((val>>28) & 0xf)*10000000;
+  return CodeplugField::fromBCD(getUInt32_le(offset));
 }
 void
 Codeplug::Element::setBCD8_le(unsigned offset, uint32_t val) {
@@ -528,55 +507,34 @@ Codeplug::Element::setBCD8_le(unsigned offset, uint32_t val) {
     return;
   }
 
-  uint32_t a  = (val / 10000000) % 10;
-  uint32_t b  = (val /  1000000) % 10;
-  uint32_t c  = (val /   100000) % 10;
-  uint32_t d  = (val /    10000) % 10;
-  uint32_t e  = (val /     1000) % 10;
-  uint32_t f  = (val /      100) % 10;
-  uint32_t g  = (val /       10) % 10;
-  uint32_t h  = (val /        1) % 10;
-  setUInt32_le(offset, (a << 28) + (b << 24) + (c << 20) + (d << 16) + (e << 12) + (f << 8) + (g << 4) + h);
+  setUInt32_le(offset, CodeplugField::toBCD(val));
 }
 
 QString
 Codeplug::Element::readASCII(unsigned offset, unsigned maxlen, uint8_t eos) const {
-  QString txt;
-  uint8_t *ptr = (uint8_t *)(_data+offset);
-  for (unsigned i=0; (i<maxlen)&&(ptr[i])&&(eos!=ptr[i]); i++) {
-    txt.append(QChar::fromLatin1(ptr[i]));
-  }
-  return txt;
+  return decode_ascii(_data+offset, maxlen, eos);
 }
 void
 Codeplug::Element::writeASCII(unsigned offset, const QString &txt, unsigned maxlen, uint8_t eos) {
-  uint8_t *ptr = (uint8_t *)(_data+offset);
-  for (unsigned i=0; i<maxlen; i++) {
-    if (i < unsigned(txt.length()))
-      ptr[i] = txt.at(i).toLatin1();
-    else
-      ptr[i] = eos;
-  }
+  encode_ascii(_data+offset, txt, maxlen, eos);
 }
 
 QString
 Codeplug::Element::readUnicode(unsigned offset, unsigned maxlen, uint16_t eos) const {
-  QString txt;
-  uint16_t *ptr = (uint16_t *)(_data+offset);
-  for (unsigned i=0; (i<maxlen)&&(eos!=ptr[i]); i++) {
-    txt.append(QChar(ptr[i]));
-  }
-  return txt;
+  return decode_unicode((const uint16_t *)(_data+offset), maxlen, eos);
 }
 void
 Codeplug::Element::writeUnicode(unsigned offset, const QString &txt, unsigned maxlen, uint16_t eos) {
-  uint16_t *ptr = (uint16_t *)(_data+offset);
-  for (unsigned i=0; i<maxlen; i++) {
-    if (i < unsigned(txt.length()))
-      ptr[i] = txt.at(i).unicode();
-    else
-      ptr[i] = eos;
+  encode_unicode((uint16_t *)(_data+offset), txt, maxlen, eos);
+}
+
+bool
+Codeplug::Element::checkField(size_t offset, size_t end) const {
+  if (end > _size) {
+    logFatal() << "Cannot access field at " << QString::number(offset, 16) << ": Overflow.";
+    return false;
   }
+  return true;
 }
 
 
@@ -584,7 +542,7 @@ Codeplug::Element::writeUnicode(unsigned offset, const QString &txt, unsigned ma
  * Implementation of CodePlug::Context
  * ********************************************************************************************* */
 Codeplug::Context::Context(Config *config)
-  : _config(config), _tables()
+  : _config(config), _tables(), _readOnly(false)
 {
   // Add tables for common elements
   addTable(&DMRRadioID::staticMetaObject);
@@ -622,23 +580,41 @@ Codeplug::Context::getTable(const QMetaObject *obj) {
   return getTable(obj->superClass());
 }
 
+const Codeplug::Context::Table &
+Codeplug::Context::getTable(const QMetaObject *obj) const {
+  QHash<QString, Table>::const_iterator table = _tables.constFind(obj->className());
+  if (_tables.constEnd() != table)
+    return *table;
+  return getTable(obj->superClass());
+}
+
 bool
 Codeplug::Context::addTable(const QMetaObject *obj) {
-  if (hasTable(obj))
+  if (_readOnly || hasTable(obj))
     return false;
   _tables.insert(obj->className(), Table());
   return true;
 }
 
+bool
+Codeplug::Context::isReadOnly() const {
+  return _readOnly;
+}
+
+void
+Codeplug::Context::setReadOnly(bool readOnly) {
+  _readOnly = readOnly;
+}
+
 ConfigItem *
-Codeplug::Context::obj(const QMetaObject *elementType, unsigned idx) {
+Codeplug::Context::obj(const QMetaObject *elementType, unsigned idx) const {
   if (! hasTable(elementType))
     return nullptr;
   return getTable(elementType).objects.value(idx, nullptr);
 }
 
 int
-Codeplug::Context::index(ConfigItem *obj) {
+Codeplug::Context::index(ConfigItem *obj) const {
   if (nullptr == obj)
     return -1;
   if (! hasTable(obj->metaObject()))
@@ -648,7 +624,7 @@ Codeplug::Context::index(ConfigItem *obj) {
 
 bool
 Codeplug::Context::add(ConfigItem *obj, unsigned idx) {
-  if (!hasTable(obj->metaObject()))
+  if (_readOnly || (!hasTable(obj->metaObject())))
     return false;
   if (getTable(obj->metaObject()).indices.contains(obj))
     return false;
@@ -660,15 +636,254 @@ Codeplug::Context::add(ConfigItem *obj, unsigned idx) {
 }
 
 
+/* ********************************************************************************************* *
+ * Implementation of CodePlug::Allocator
+ * ********************************************************************************************* */
+Codeplug::Allocator::Allocator(Codeplug *codeplug, unsigned img)
+  : _codeplug(codeplug), _image(img), _start(0), _end(0)
+{
+  // pass...
+}
+
+Codeplug::Allocator::~Allocator() {
+  flush();
+}
+
+void
+Codeplug::Allocator::add(uint32_t addr, uint32_t size) {
+  // Already part of the pending run (e.g., several entries sharing a block)
+  if ((_start <= addr) && ((addr+size) <= _end))
+    return;
+  // Extends the pending run
+  if ((_start != _end) && (addr == _end) && (nullptr == _codeplug->data(addr, _image))) {
+    _end += size;
+    return;
+  }
+  flush();
+  if (nullptr != _codeplug->data(addr, _image))
+    return;
+  _start = addr; _end = addr+size;
+}
+
+void
+Codeplug::Allocator::flush() {
+  if (_start == _end)
+    return;
+  _codeplug->image(_image).addElement(_start, _end-_start);
+  _start = _end = 0;
+}
+
+
+/* ********************************************************************************************* *
+ * Implementation of SectionEncoder
+ * ********************************************************************************************* */
+/** Encodes a single section of the codeplug. Used by @c Codeplug::encodeSections. */
+class SectionEncoder: public QRunnable
+{
+public:
+  /** Constructor. The errors and result are owned by the caller. */
+  SectionEncoder(const std::function<bool(const ErrorStack &)> &section, ErrorStack &err, bool &result)
+    : QRunnable(), _section(section), _err(err), _result(result)
+  {
+    // pass...
+  }
+
+  void run() {
+    _result = _section(_err);
+  }
+
+protected:
+  /** The section to encode. */
+  const std::function<bool(const ErrorStack &)> &_section;
+  /** The errors of this section. */
+  ErrorStack &_err;
+  /** The result of this section. */
+  bool &_result;
+};
+
+
 /* ********************************************************************************************* *
  * Implementation of CodePlug
  * ********************************************************************************************* */
 Codeplug::Codeplug(QObject *parent)
-  : DFUFile(parent)
+  : DFUFile(parent), _incremental(false), _tracking(false), _trackedConfig(), _trackedFlags(),
+    _trackedContext(nullptr), _elements(), _modifiedItems(), _elementsLock()
 {
 	// pass...
 }
 
 Codeplug::~Codeplug() {
-	// pass...
+  untrack();
+}
+
+void
+Codeplug::enableIncrementalEncoding(bool enable) {
+  _incremental = enable;
+  if (! _incremental)
+    untrack();
+}
+
+bool
+Codeplug::incrementalEncodingEnabled() const {
+  return _incremental;
+}
+
+bool
+Codeplug::encodeSections(const QVector<Section> &sections, const Flags &flags, Context &ctx,
+                         const ErrorStack &err)
+{
+  QVector<ErrorStack> errors(sections.size());
+  QVector<bool> results(sections.size(), false);
+
+  if (flags.concurrentEncoding && (1 < sections.size())) {
+    ctx.setReadOnly(true);
+    QThreadPool pool;
+    for (int i=0; i<sections.size(); i++)
+      pool.start(new SectionEncoder(sections[i], errors[i], results[i]));
+    pool.waitForDone();
+    ctx.setReadOnly(false);
+  } else {
+    for (int i=0; i<sections.size(); i++)
+      SectionEncoder(sections[i], errors[i], results[i]).run();
+  }
+
+  // Merge errors in order of the sections
+  bool success = true;
+  for (int i=0; i<sections.size(); i++) {
+    if (! results[i]) {
+      err.take(errors[i]);
+      success = false;
+    }
+  }
+  return success;
+}
+
+bool
+Codeplug::canEncodeModified(Config *config, const Flags &flags) const {
+  // The flags affecting the encoding must match
+  return _incremental && (nullptr != _trackedContext) && (config == _trackedConfig.data())
+      && (flags.updateCodePlug == _trackedFlags.updateCodePlug)
+      && (flags.autoEnableGPS == _trackedFlags.autoEnableGPS)
+      && (flags.autoEnableRoaming == _trackedFlags.autoEnableRoaming);
+}
+
+bool
+Codeplug::encodeModified(const ErrorStack &err) {
+  foreach (ConfigItem *item, _modifiedItems) {
+    foreach (const ElementEncoder &encode, _elements.value(item)) {
+      if (! encode(*_trackedContext, err)) {
+        errMsg(err) << "Cannot encode modified " << item->metaObject()->className() << ".";
+        untrack();
+        return false;
+      }
+    }
+  }
+  logDebug() << "Encoded " << _modifiedItems.size() << " modified items.";
+  _modifiedItems.clear();
+  return true;
+}
+
+void
+Codeplug::beginTracking(Config *config, const Flags &flags) {
+  untrack();
+  if (! _incremental)
+    return;
+  _tracking = true;
+  _trackedConfig = config;
+  _trackedFlags = flags;
+}
+
+void
+Codeplug::trackElement(ConfigItem *item, const ElementEncoder &encoder) {
+  if (! _tracking)
+    return;
+  QMutexLocker locker(&_elementsLock);
+  _elements[item].append(encoder);
+}
+
+void
+Codeplug::endTracking(Context *ctx) {
+  if ((! _tracking) || _trackedConfig.isNull()) {
+    untrack();
+    delete ctx;
+    return;
+  }
+
+  _tracking = false;
+  _trackedContext = ctx;
+
+  // Modifications of tracked items only require their elements to be encoded again
+  foreach (ConfigItem *item, _elements.keys())
+    connect(item, SIGNAL(modified(ConfigItem*)), this, SLOT(onTrackedItemModified()));
+
+  // Any other change requires a complete encoding
+  Config *config = _trackedConfig.data();
+  connect(config, SIGNAL(destroyed(QObject*)), this, SLOT(onTrackedConfigChanged()));
+  connect(config->settings(), SIGNAL(modified(ConfigItem*)), this, SLOT(onTrackedConfigChanged()));
+  connect(config->commercialExtension(), SIGNAL(modified(ConfigItem*)), this, SLOT(onTrackedConfigChanged()));
+  if (config->tytExtension())
+    connect(config->tytExtension(), SIGNAL(modified(ConfigItem*)), this, SLOT(onTrackedConfigChanged()));
+  foreach (AbstractConfigObjectList *list, config->lists()) {
+    connect(list, SIGNAL(elementAdded(int)), this, SLOT(onTrackedConfigChanged()));
+    connect(list, SIGNAL(elementRemoved(int)), this, SLOT(onTrackedConfigChanged()));
+    connect(list, SIGNAL(elementMoved(int,int)), this, SLOT(onTrackedConfigChanged()));
+    connect(list, SIGNAL(elementsReset()), this, SLOT(onTrackedConfigChanged()));
+    connect(list, SIGNAL(elementModified(int)), this, SLOT(onTrackedElementModified(int)));
+    connect(list, SIGNAL(elementsModified(int,int)), this, SLOT(onTrackedElementsModified(int,int)));
+  }
+}
+
+void
+Codeplug::untrack() {
+  if (! _trackedConfig.isNull()) {
+    Config *config = _trackedConfig.data();
+    disconnect(config, nullptr, this, nullptr);
+    disconnect(config->settings(), nullptr, this, nullptr);
+    disconnect(config->commercialExtension(), nullptr, this, nullptr);
+    if (config->tytExtension())
+      disconnect(config->tytExtension(), nullptr, this, nullptr);
+    foreach (AbstractConfigObjectList *list, config->lists())
+      disconnect(list, nullptr, this, nullptr);
+    foreach (ConfigItem *item, _elements.keys())
+      disconnect(item, nullptr, this, nullptr);
+  }
+
+  _tracking = false;
+  _trackedConfig.clear();
+  if (_trackedContext)
+    delete _trackedContext;
+  _trackedContext = nullptr;
+  _elements.clear();
+  _modifiedItems.clear();
+}
+
+void
+Codeplug::onTrackedItemModified() {
+  if (ConfigItem *item = qobject_cast<ConfigItem *>(sender()))
+    _modifiedItems.insert(item);
+}
+
+void
+Codeplug::onTrackedElementModified(int idx) {
+  onTrackedElementsModified(idx, idx);
+}
+
+void
+Codeplug::onTrackedElementsModified(int first, int last) {
+  AbstractConfigObjectList *list = qobject_cast<AbstractConfigObjectList *>(sender());
+  if (nullptr == list)
+    return;
+  // Modified tracked items are recorded by onTrackedItemModified
+  for (int i=first; i<=last; i++) {
+    if (! _elements.contains(list->get(i))) {
+      onTrackedConfigChanged();
+      return;
+    }
+  }
+}
+
+void
+Codeplug::onTrackedConfigChanged() {
+  logDebug() << "Tracked configuration changed, the next encoding will be complete.";
+  untrack();
 }
@@ -5,7 +5,18 @@
 #include "dfufile.hh"
 #include "userdatabase.hh"
 #include <QHash>
+#include <QVector>
+#include <QPair>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QPointer>
+#include <QMutex>
+#include <QSet>
+#include <functional>
+#include <algorithm>
 #include "config.hh"
+#include "codeplugfield.hh"
 
 //class Config;
 class ConfigItem;
@@ -34,6 +45,10 @@ public:
     /** If @c true enables automatic roaming when there is a roaming zone defined that is used by any
      * channel. This may cause automatic transmissions, hence the default is @c false. */
     bool autoEnableRoaming;
+    /** If @c true, independent sections of the codeplug (e.g., channels, contacts, zones) get
+     * encoded concurrently. The result is identical to the sequential encoding. Default @c true.
+     * @since 0.11.3 */
+    bool concurrentEncoding;
 
     /** Default constructor, enables code-plug update and disables automatic GPS/APRS and roaming. */
     Flags();
@@ -178,6 +193,31 @@ public:
      * The stored string gets padded with @c eos to @c maxlen. */
     void writeUnicode(unsigned offset, const QString &txt, unsigned maxlen, uint16_t eos=0x0000);
 
+    /** Reads the given field (see @c CodeplugField). The position of the field is checked at
+     * compile time, hence the access gets inlined without any branch. */
+    template <class Field>
+    inline typename Field::Type get() const {
+#ifdef CODEPLUG_FIELD_CHECKS
+      if (! checkField(Field::offset, Field::end))
+        return typename Field::Type();
+#endif
+      return Field::get(_data);
+    }
+    /** Stores the given field (see @c CodeplugField). */
+    template <class Field>
+    inline void set(typename Field::Type value) {
+#ifdef CODEPLUG_FIELD_CHECKS
+      if (! checkField(Field::offset, Field::end))
+        return;
+#endif
+      Field::set(_data, value);
+    }
+
+  protected:
+    /** Checks a field access against the actual size of the element at runtime. Only used if
+     * build with @c CODEPLUG_FIELD_CHECKS. */
+    bool checkField(size_t offset, size_t end) const;
+
   protected:
     /** Holds the pointer to the element. */
     uint8_t *_data;
@@ -202,31 +242,41 @@ public:
 
     /** Resolves the given index for the specifies element type.
      * @returns @c nullptr if the index is not defined or the type is unknown. */
-    ConfigItem *obj(const QMetaObject *elementType, unsigned idx);
+    ConfigItem *obj(const QMetaObject *elementType, unsigned idx) const;
     /** Returns the index for the given object.
      * @returns -1 if no index is associated with the object or its type is unknown. */
-    int index(ConfigItem *obj);
-    /** Associates the given object with the given index. */
+    int index(ConfigItem *obj) const;
+    /** Associates the given object with the given index.
+     * @returns @c false if the object or index is already defined or the context is read-only. */
     bool add(ConfigItem *obj, unsigned idx);
 
     /** Adds a table for the given type. */
     bool addTable(const QMetaObject *obj);
 
+    /** Returns @c true if the context is read-only.
+     * @since 0.11.3 */
+    bool isReadOnly() const;
+    /** Marks the context as read-only. While read-only, no objects or tables can be added. Hence
+     * the context may be accessed concurrently, e.g., while several sections of the codeplug get
+     * encoded at once.
+     * @since 0.11.3 */
+    void setReadOnly(bool readOnly);
+
     /** Returns the object associated by the given index and type. */
     template <class T>
-    T* get(unsigned idx) {
+    T* get(unsigned idx) const {
       return this->obj(&(T::staticMetaObject), idx)->template as<T>();
     }
 
     /** Returns @c true, if the given index is defined for the specified type. */
     template <class T>
-    bool has(unsigned idx) {
+    bool has(unsigned idx) const {
       return nullptr != this->obj(&(T::staticMetaObject), idx)->template as<T>();
     }
 
     /** Returns the number of elements for the specified type. */
     template <class T>
-    unsigned int count() {
+    unsigned int count() const {
       return getTable(&T::staticMetaObject).indices.size();
     }
 
@@ -245,22 +295,191 @@ public:
     bool hasTable(const QMetaObject *obj) const;
     /** Returns a reference to the table for the given type. */
     Table &getTable(const QMetaObject *obj);
+    /** Returns a const reference to the table for the given type. */
+    const Table &getTable(const QMetaObject *obj) const;
 
   protected:
     /** A weak reference to the config object. */
     Config *_config;
     /** Table of tables. */
     QHash<QString, Table> _tables;
+    /** If @c true, no objects or tables can be added. */
+    bool _readOnly;
+  };
+
+  /** Plans the allocation of many small elements, e.g., one per enabled channel.
+   *
+   * Adjacent elements are merged into a single contiguous element. Elements, that are already
+   * allocated, are skipped. Hence the number of elements and the cost of maintaining the address
+   * map scale with the number of runs of enabled entries rather than with the number of entries.
+   * Elements must be added with increasing addresses. The pending run gets allocated with the
+   * next non-adjacent element, on @c flush or once the allocator is destroyed.
+   * @since 0.11.3 */
+  class Allocator
+  {
+  public:
+    /** Constructs an allocator for the given image of the codeplug. */
+    explicit Allocator(Codeplug *codeplug, unsigned img=0);
+    /** Destructor, allocates the pending run. */
+    ~Allocator();
+
+    /** Adds an element of the given size at the given address. */
+    void add(uint32_t addr, uint32_t size);
+    /** Allocates the pending run. */
+    void flush();
+
+  protected:
+    /** The codeplug. */
+    Codeplug *_codeplug;
+    /** The image index. */
+    unsigned _image;
+    /** Start address of the pending run. */
+    uint32_t _start;
+    /** End address of the pending run, equals @c _start if there is none. */
+    uint32_t _end;
+  };
+
+  /** Decodes a consecutive range of table entries into records. Used by @c decodeRecords.
+   * @since 0.11.3 */
+  template <class Record>
+  class RecordDecoder: public QRunnable
+  {
+  public:
+    /** The decoded records together with their indices. */
+    typedef QVector<QPair<unsigned, Record>> Records;
+
+  public:
+    /** Constructs a decoder for the entries @c [first, last). The decoded records are appended to
+     * @c records. */
+    RecordDecoder(unsigned first, unsigned last, const std::function<bool(unsigned, Record &)> &decode,
+                  Records &records)
+      : QRunnable(), _first(first), _last(last), _decode(decode), _records(records)
+    {
+      // pass...
+    }
+
+    void run() {
+      for (unsigned i=_first; i<_last; i++) {
+        Record record;
+        if (_decode(i, record))
+          _records.append(qMakePair(i, record));
+      }
+    }
+
+  protected:
+    /** The first entry to decode. */
+    unsigned _first;
+    /** The entry after the last one to decode. */
+    unsigned _last;
+    /** The decoder of a single entry. */
+    const std::function<bool(unsigned, Record &)> &_decode;
+    /** The records, owned by the caller. */
+    Records &_records;
   };
 
 protected:
   /** Hidden default constructor. */
   explicit Codeplug(QObject *parent=nullptr);
 
+  /** Decodes the entries @c [0, count) of a table of the codeplug into plain records.
+   *
+   * Decoding is split into two phases. This method implements the first one: The entries are
+   * decoded concurrently into records by @c decode, which returns @c false for disabled or invalid
+   * entries. Hence @c decode must only read the codeplug via its const interface and must not
+   * create any objects. The second phase, that is the creation of the config objects from the
+   * records and their linking, is left to the caller and happens on the owning thread. The
+   * records are returned in ascending order of their indices. Hence the resulting configuration
+   * is identical to the one obtained by decoding the entries one by one.
+   * @since 0.11.3 */
+  template <class Record>
+  static QVector<QPair<unsigned, Record>>
+  decodeRecords(unsigned count, const std::function<bool(unsigned, Record &)> &decode) {
+    typedef typename RecordDecoder<Record>::Records Records;
+    // Small tables are not worth the overhead of the thread pool.
+    unsigned chunks = std::min(std::max(1, QThread::idealThreadCount()), int(count/256));
+    if (1 >= chunks) {
+      Records records;
+      RecordDecoder<Record>(0, count, decode, records).run();
+      return records;
+    }
+
+    QVector<Records> parts(chunks);
+    QThreadPool pool;
+    for (unsigned c=0; c<chunks; c++)
+      pool.start(new RecordDecoder<Record>((c*count)/chunks, ((c+1)*count)/chunks, decode, parts[c]));
+    pool.waitForDone();
+
+    Records records;
+    foreach (const Records &part, parts)
+      records.append(part);
+    return records;
+  }
+
+  /** Encodes a single section of the codeplug, see @c encodeSections. */
+  typedef std::function<bool(const ErrorStack &err)> Section;
+
+  /** Encodes the given sections of the codeplug.
+   *
+   * Once all objects are indexed and the memory is allocated, many sections of the codeplug (e.g.,
+   * channels, contacts, zones) are encoded into disjoint memory ranges. If
+   * @c Flags::concurrentEncoding is set, these sections are encoded concurrently on a thread pool.
+   * The context is read-only meanwhile. Hence the sections must only read the configuration and
+   * the context and must only write to their own memory. Each section collects its own errors.
+   * They are merged in the order of the sections, once all sections are encoded.
+   * @returns @c false if any section failed.
+   * @since 0.11.3 */
+  bool encodeSections(const QVector<Section> &sections, const Flags &flags, Context &ctx,
+                      const ErrorStack &err=ErrorStack());
+
+  /** Encodes the element(s) produced by a single item of the configuration again, see
+   * @c trackElement.
+   * @since 0.11.3 */
+  typedef std::function<bool(Context &ctx, const ErrorStack &err)> ElementEncoder;
+
+  /** Returns @c true if the last encoding of the given configuration with the given flags is
+   * tracked. Then, @c encodeModified can be used instead of encoding the configuration completely.
+   * @since 0.11.3 */
+  bool canEncodeModified(Config *config, const Flags &flags) const;
+  /** Encodes the elements of all items modified since the last encoding again.
+   * @since 0.11.3 */
+  bool encodeModified(const ErrorStack &err=ErrorStack());
+  /** Starts tracking the complete encoding of the given configuration, if the incremental encoding
+   * is enabled. Any previously tracked state is dropped.
+   * @since 0.11.3 */
+  void beginTracking(Config *config, const Flags &flags);
+  /** Records the encoder for an element produced by the given item. Several elements may be
+   * recorded for the same item. This method may be called concurrently from several sections (see
+   * @c encodeSections). It does nothing, if the encoding is not tracked.
+   * @since 0.11.3 */
+  void trackElement(ConfigItem *item, const ElementEncoder &encoder);
+  /** Completes tracking, once the configuration is encoded. Takes the ownership of the context
+   * used for encoding. From now on, the modifications of the configuration are recorded.
+   * @since 0.11.3 */
+  void endTracking(Context *ctx);
+  /** Drops the tracked state, the next encoding will be complete.
+   * @since 0.11.3 */
+  void untrack();
+
 public:
   /** Destructor. */
   virtual ~Codeplug();
 
+  /** Enables or disables the incremental encoding.
+   *
+   * If enabled, the codeplug keeps the configuration and the context of the last encoding, as well
+   * as the elements produced by each item of the configuration. It listens to the modifications of
+   * these items. Encoding the same configuration with the same flags again, only rewrites the
+   * elements of the modified items. The configuration is encoded completely, whenever the indices
+   * may have changed (i.e., an element was added, removed or moved) or an item was modified, whose
+   * elements are not tracked (e.g., the radio settings). Hence, the memory of the codeplug must not
+   * be modified otherwise between two encodings. Incremental encoding is disabled by default and
+   * only supported by some codeplugs.
+   * @since 0.11.3 */
+  void enableIncrementalEncoding(bool enable);
+  /** Returns @c true if the incremental encoding is enabled.
+   * @since 0.11.3 */
+  bool incrementalEncodingEnabled() const;
+
   /** Indexes all elements of the codeplug.
    * This method must be implemented by any device or vendor specific codeplug to map config
    * objects to indices used within the binary codeplug to address each element (e.g., channels,
@@ -273,6 +492,34 @@ public:
   /** Encodes a given abstract configuration (@c config) to the device specific binary code-plug.
    * This must be implemented by the device-specific codeplug. */
   virtual bool encode(Config *config, const Flags &flags=Flags(), const ErrorStack &err=ErrorStack()) = 0;
+
+protected slots:
+  /** Gets called, if a tracked item gets modified. */
+  void onTrackedItemModified();
+  /** Gets called, if an element of a list of the tracked configuration gets modified. */
+  void onTrackedElementModified(int idx);
+  /** Gets called, if some elements of a list of the tracked configuration got modified. */
+  void onTrackedElementsModified(int first, int last);
+  /** Gets called, if the tracked configuration changed such that it must be encoded completely. */
+  void onTrackedConfigChanged();
+
+protected:
+  /** If @c true, the encoding gets tracked. */
+  bool _incremental;
+  /** If @c true, a complete encoding is running and the elements get recorded. */
+  bool _tracking;
+  /** The tracked configuration. */
+  QPointer<Config> _trackedConfig;
+  /** The flags used for the tracked encoding. */
+  Flags _trackedFlags;
+  /** The context of the tracked encoding, owned by the codeplug. */
+  Context *_trackedContext;
+  /** The encoders of the elements produced by each item. */
+  QHash<ConfigItem *, QVector<ElementEncoder>> _elements;
+  /** Items modified since the last encoding. */
+  QSet<ConfigItem *> _modifiedItems;
+  /** Serializes the recording of elements from concurrently encoded sections. */
+  QMutex _elementsLock;
 };
 
 #endif // CODEPLUG_HH
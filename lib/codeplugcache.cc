@@ -0,0 +1,212 @@
+#include "codeplugcache.hh"
+#include "radiointerface.hh"
+#include "logger.hh"
+
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRegExp>
+#include <QFile>
+#include <QDir>
+#include <cstring>
+#include <algorithm>
+
+
+/* ********************************************************************************************* *
+ * Implementation of CodeplugCache
+ * ********************************************************************************************* */
+CodeplugCache::CodeplugCache(const QString &radio)
+  : _radio(radio), _image(), _valid()
+{
+  ErrorStack err;
+  if (QFile::exists(filename(".json")) && (! load(err)))
+    logWarn() << "Cannot load codeplug cache for '" << _radio << "': " << err.format();
+}
+
+bool
+CodeplugCache::isValid() const {
+  return _valid.contains(true);
+}
+
+bool
+CodeplugCache::read(uint32_t addr, uint8_t *data, uint32_t size) const {
+  if (0 == _image.numImages())
+    return false;
+
+  const DFUFile::Image &img = _image.image(0);
+  for (int i=0; i<img.numElements(); i++) {
+    const DFUFile::Element &el = img.element(i);
+    if ((! _valid.value(i, false)) || (addr < el.address())
+        || ((addr+size) > (el.address()+uint32_t(el.data().size()))))
+      continue;
+    memcpy(data, el.data().constData()+(addr-el.address()), size);
+    return true;
+  }
+
+  return false;
+}
+
+bool
+CodeplugCache::matches(const DFUFile &image, int first, int count) const {
+  for (int n=first; (n<(first+count)) && (n<image.image(0).numElements()); n++) {
+    const DFUFile::Element &el = image.image(0).element(n);
+    QByteArray cached(el.data().size(), 0);
+    if ((! read(el.address(), (uint8_t *)cached.data(), cached.size())) || (cached != el.data()))
+      return false;
+  }
+  return true;
+}
+
+bool
+CodeplugCache::verify(RadioInterface *dev, const DFUFile &image, int first, unsigned samples,
+                      unsigned blockSize, const ErrorStack &err) const
+{
+  if ((nullptr == dev) || (! isValid()) || (0 == blockSize))
+    return false;
+
+  // Split the elements into blocks, such that large elements get sampled at several positions
+  QVector<int> elements; QVector<uint32_t> offsets;
+  for (int n=first; n<image.image(0).numElements(); n++) {
+    for (uint32_t o=0; o<uint32_t(image.image(0).element(n).data().size()); o+=blockSize) {
+      elements.append(n); offsets.append(o);
+    }
+  }
+  int count = elements.size();
+  if (0 == count)
+    return true;
+  samples = std::max(1U, std::min(samples, unsigned(count)));
+
+  for (unsigned s=0; s<samples; s++) {
+    // Always sample the first blocks (usually settings), spread the remaining ones evenly
+    int b = (s < 2) ? int(s) : int((s*quint64(count-1))/(samples-1));
+    const DFUFile::Element &el = image.image(0).element(elements[b]);
+    uint32_t addr = el.address()+offsets[b];
+    uint32_t size = std::min(uint32_t(el.data().size())-offsets[b], blockSize);
+    QByteArray device(size, 0), cached(size, 0);
+    if (! read(addr, (uint8_t *)cached.data(), size)) {
+      logDebug() << "Codeplug cache does not cover block at 0x" << QString::number(addr, 16) << ".";
+      return false;
+    }
+    if (! dev->read(0, addr, (uint8_t *)device.data(), size, err)) {
+      errMsg(err) << "Cannot verify codeplug cache.";
+      return false;
+    }
+    if (device != cached) {
+      logInfo() << "Codeplug cache for '" << _radio << "' is outdated: Block at 0x"
+                << QString::number(addr, 16) << " differs from device.";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+CodeplugCache::restore(DFUFile &image, int first) const {
+  for (int n=first; n<image.image(0).numElements(); n++) {
+    DFUFile::Element &el = image.image(0).element(n);
+    if (! read(el.address(), (uint8_t *)el.data().data(), el.data().size()))
+      return false;
+  }
+  return true;
+}
+
+bool
+CodeplugCache::store(DFUFile &image, const ErrorStack &err) {
+  QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/cache";
+  QDir directory;
+  if ((! directory.exists(path)) && (! directory.mkpath(path))) {
+    errMsg(err) << "Cannot create path '" << path << "'.";
+    return false;
+  }
+
+  // Remove index first, an interrupted update then leaves no valid cache behind
+  QFile::remove(filename(".json"));
+  if (! image.write(filename(".dfu"), err)) {
+    errMsg(err) << "Cannot store codeplug cache for '" << _radio << "'.";
+    return false;
+  }
+
+  QJsonArray hashes;
+  for (int i=0; i<image.numImages(); i++) {
+    for (int j=0; j<image.image(i).numElements(); j++) {
+      QByteArray hash = QCryptographicHash::hash(image.image(i).element(j).data(), QCryptographicHash::Sha1);
+      hashes.append(QString::fromLatin1(hash.toHex()));
+    }
+  }
+
+  QJsonObject obj;
+  obj.insert("radio", _radio);
+  obj.insert("hashes", hashes);
+
+  QFile file(filename(".json"));
+  if (! file.open(QIODevice::WriteOnly)) {
+    errMsg(err) << "Cannot store codeplug cache index at '" << file.fileName()
+                << "': " << file.errorString() << ".";
+    return false;
+  }
+  file.write(QJsonDocument(obj).toJson());
+  file.close();
+
+  logDebug() << "Stored codeplug cache for '" << _radio << "' at '" << filename(".dfu") << "'.";
+  return load(err);
+}
+
+void
+CodeplugCache::clear() {
+  QFile::remove(filename(".json"));
+  QFile::remove(filename(".dfu"));
+  _valid.clear();
+  while (_image.numImages())
+    _image.remImage(0);
+}
+
+bool
+CodeplugCache::load(const ErrorStack &err) {
+  _valid.clear();
+
+  QFile file(filename(".json"));
+  if (! file.open(QIODevice::ReadOnly)) {
+    errMsg(err) << "Cannot open codeplug cache index '" << file.fileName()
+                << "': " << file.errorString() << ".";
+    return false;
+  }
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+  file.close();
+  if ((! doc.isObject()) || (_radio != doc.object().value("radio").toString())) {
+    errMsg(err) << "Invalid codeplug cache index '" << file.fileName() << "'.";
+    return false;
+  }
+
+  if (! _image.read(filename(".dfu"), err)) {
+    errMsg(err) << "Cannot read cached codeplug image.";
+    return false;
+  }
+
+  // Check hash of every element, only elements with matching hash are used
+  QJsonArray hashes = doc.object().value("hashes").toArray();
+  int idx = 0;
+  for (int i=0; i<_image.numImages(); i++) {
+    for (int j=0; j<_image.image(i).numElements(); j++, idx++) {
+      QByteArray hash = QCryptographicHash::hash(_image.image(i).element(j).data(), QCryptographicHash::Sha1);
+      bool valid = (hashes.at(idx).toString().toLatin1() == hash.toHex());
+      if (! valid)
+        logWarn() << "Codeplug cache for '" << _radio << "' corrupted: Hash mismatch for element "
+                  << j << " of image " << i << ".";
+      if (0 == i)
+        _valid.append(valid);
+    }
+  }
+
+  return true;
+}
+
+QString
+CodeplugCache::filename(const QString &ext) const {
+  QString radio = _radio.toLower();
+  radio.replace(QRegExp("[^a-z0-9]+"), "_");
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+      + "/cache/" + radio + ext;
+}
@@ -0,0 +1,77 @@
+#ifndef CODEPLUGCACHE_HH
+#define CODEPLUGCACHE_HH
+
+#include <QString>
+#include <QVector>
+
+#include "dfufile.hh"
+#include "errorstack.hh"
+
+class RadioInterface;
+
+
+/** Persistent on-disk cache of the last known binary codeplug image of a radio.
+ *
+ * Whenever a codeplug gets downloaded from or uploaded to a radio, the binary image is stored in
+ * the application data directory, together with a content hash for each element. On the next
+ * update-mode upload, the cached image can be used instead of reading all memory sections, that
+ * must be preserved, from the device again.
+ *
+ * As the radios do not expose a serial number, the cache is keyed by the radio name. Before the
+ * cached content is used, it must be verified against the device using @c verify. This re-reads a
+ * small sample of blocks, spread over the entire image, from the device. If any of these differs
+ * from the cached content, the device was changed (or another device of the same model is
+ * attached) and the caller must fall back to a full read.
+ *
+ * @ingroup rif */
+class CodeplugCache
+{
+public:
+  /** Constructs the cache for the specified radio and loads the cached image (if present). */
+  explicit CodeplugCache(const QString &radio);
+
+  /** Returns @c true if a cached image is present. */
+  bool isValid() const;
+
+  /** Copies the cached data for the specified memory region into @c data. Returns @c false, if
+   * the region is not completely held by a single valid cached element. */
+  bool read(uint32_t addr, uint8_t *data, uint32_t size) const;
+
+  /** Returns @c true if the content of @c count elements of @c image, starting at element
+   * @c first, matches the cached content. */
+  bool matches(const DFUFile &image, int first, int count) const;
+
+  /** Re-reads up to @c samples blocks of @c image (starting at element @c first) from the device
+   * and compares them with the cached content. Each element is split into blocks of
+   * @c blockSize bytes, hence large elements get sampled at several positions. The first blocks
+   * are always sampled, the remaining samples are spread evenly over all blocks.
+   * Returns @c true if all sampled blocks match. */
+  bool verify(RadioInterface *dev, const DFUFile &image, int first, unsigned samples,
+              unsigned blockSize, const ErrorStack &err=ErrorStack()) const;
+
+  /** Fills all elements of @c image, starting at element @c first, with the cached content.
+   * Returns @c false if any element is not covered by the cache. In this case, the content of
+   * the image is undefined. */
+  bool restore(DFUFile &image, int first=0) const;
+
+  /** Replaces the cached image with the given one and stores it. */
+  bool store(DFUFile &image, const ErrorStack &err=ErrorStack());
+  /** Deletes the cached image. */
+  void clear();
+
+protected:
+  /** Loads the cached image and checks the element hashes. */
+  bool load(const ErrorStack &err=ErrorStack());
+  /** Returns the path of the cache file with the given extension. */
+  QString filename(const QString &ext) const;
+
+protected:
+  /** The radio name. */
+  QString _radio;
+  /** The cached image. */
+  DFUFile _image;
+  /** For each element of the cached image, @c true if its hash matched. */
+  QVector<bool> _valid;
+};
+
+#endif // CODEPLUGCACHE_HH
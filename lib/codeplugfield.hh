@@ -0,0 +1,262 @@
+#ifndef CODEPLUGFIELD_HH
+#define CODEPLUGFIELD_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <QtEndian>
+
+/** Compile-time descriptions of the fields within codeplug elements.
+ *
+ * The generic accessors of @c Codeplug::Element take the offset and bit of a field as runtime
+ * arguments and check them against the element size on every access. Within the device specific
+ * elements, these offsets are constants anyway. A field descriptor encodes the position, width
+ * and encoding of a field as template arguments. Hence all masks and shifts are resolved at
+ * compile time and the loads and stores reduce to a few inlined instructions without any branch.
+ *
+ * The fields of an element are declared within a @c Layout of the element size, e.g.,
+ * @code
+ * typedef CodeplugField::Layout<0x0040> Layout;
+ * typedef Layout::Flag<0x0034, 0>       Ranging;
+ * typedef Layout::UInt8<0x0036>         APRSSystemIndex;
+ * @endcode
+ * A field exceeding the element size fails to compile. The fields are accessed via
+ * @c Codeplug::Element::get and @c Codeplug::Element::set. If qdmr is build with
+ * @c CODEPLUG_FIELD_CHECKS (the default for debug builds), these accessors additionally check
+ * every access against the actual size of the element at runtime.
+ *
+ * @since 0.11.3
+ * @ingroup util */
+namespace CodeplugField {
+
+/** A single bit at the given byte-offset. */
+template <size_t Offset, unsigned Bit>
+struct Flag {
+  static_assert(Bit < 8, "Bit index must be within a byte.");
+  /** The value type of the field. */
+  typedef bool Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+1;
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) {
+    return (data[Offset] >> Bit) & 1;
+  }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) {
+    data[Offset] = (data[Offset] & ~(1u << Bit)) | (uint8_t(value) << Bit);
+  }
+};
+
+/** A single bit at the given byte-offset, that is cleared if the option is enabled. */
+template <size_t Offset, unsigned Bit>
+struct InvertedFlag {
+  static_assert(Bit < 8, "Bit index must be within a byte.");
+  /** The value type of the field. */
+  typedef bool Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+1;
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) {
+    return !((data[Offset] >> Bit) & 1);
+  }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) {
+    data[Offset] = (data[Offset] & ~(1u << Bit)) | (uint8_t(!value) << Bit);
+  }
+};
+
+/** An unsigned integer of @c Width bits within a single byte, starting at the given bit. */
+template <size_t Offset, unsigned Bit, unsigned Width>
+struct UInt {
+  static_assert((0 < Width) && (8 >= (Bit+Width)), "Bit-field must be within a byte.");
+  /** The value type of the field. */
+  typedef uint8_t Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+1;
+  /** The mask of the field within the byte. */
+  static constexpr uint8_t mask = ((1u << Width)-1) << Bit;
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) {
+    return (data[Offset] & mask) >> Bit;
+  }
+  /** Writes the field. Excess bits of the value are ignored. */
+  static inline void set(uint8_t *data, Type value) {
+    data[Offset] = (data[Offset] & ~mask) | ((value << Bit) & mask);
+  }
+};
+
+/** An unsigned 8bit integer at the given byte-offset. */
+template <size_t Offset>
+struct UInt8 {
+  /** The value type of the field. */
+  typedef uint8_t Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+1;
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) { return data[Offset]; }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) { data[Offset] = value; }
+};
+
+/** An unsigned integer of type @c T in little-endian at the given byte-offset. The offset need
+ * not to be aligned. */
+template <size_t Offset, class T>
+struct UIntLE {
+  /** The value type of the field. */
+  typedef T Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+sizeof(T);
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) { return qFromLittleEndian<T>(data+Offset); }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) { qToLittleEndian<T>(value, data+Offset); }
+};
+
+/** An unsigned integer of type @c T in big-endian at the given byte-offset. The offset need
+ * not to be aligned. */
+template <size_t Offset, class T>
+struct UIntBE {
+  /** The value type of the field. */
+  typedef T Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+sizeof(T);
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) { return qFromBigEndian<T>(data+Offset); }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) { qToBigEndian<T>(value, data+Offset); }
+};
+
+/** Packs a value 0-99 into two BCD digits. */
+inline uint32_t
+toBCD2(uint32_t value) {
+  return ((value / 10) << 4) | (value % 10);
+}
+
+/** Packs the decimal digits of the given value into a BCD word. The digits are split pair-wise,
+ * hence only divisions by constants (multiplications) and no loops or branches are needed. Digits
+ * beyond 8 are ignored. */
+inline uint32_t
+toBCD(uint32_t value) {
+  uint32_t hi = (value / 10000) % 10000, lo = value % 10000;
+  return (toBCD2(hi / 100) << 24) | (toBCD2(hi % 100) << 16) | (toBCD2(lo / 100) << 8) | toBCD2(lo % 100);
+}
+
+/** Unpacks a BCD word into its decimal value by folding nibbles, bytes and half-words. */
+inline uint32_t
+fromBCD(uint32_t bcd) {
+  uint32_t v = (bcd & 0x0f0f0f0f) + ((bcd >> 4) & 0x0f0f0f0f)*10;
+  v = (v & 0x00ff00ff) + ((v >> 8) & 0x00ff00ff)*100;
+  return (v & 0xffff) + (v >> 16)*10000;
+}
+
+/** A BCD encoded value of @c 2*sizeof(T) digits in big-endian at the given byte-offset. */
+template <size_t Offset, class T>
+struct BCDBE {
+  /** The value type of the field. */
+  typedef T Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+sizeof(T);
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) {
+    return fromBCD(qFromBigEndian<T>(data+Offset));
+  }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) {
+    qToBigEndian<T>(toBCD(value), data+Offset);
+  }
+};
+
+/** A BCD encoded value of @c 2*sizeof(T) digits in little-endian at the given byte-offset. */
+template <size_t Offset, class T>
+struct BCDLE {
+  /** The value type of the field. */
+  typedef T Type;
+  /** Byte-offset of the field. */
+  static constexpr size_t offset = Offset;
+  /** Byte-offset of the first byte after the field. */
+  static constexpr size_t end = Offset+sizeof(T);
+
+  /** Reads the field. */
+  static inline Type get(const uint8_t *data) {
+    return fromBCD(qFromLittleEndian<T>(data+Offset));
+  }
+  /** Writes the field. */
+  static inline void set(uint8_t *data, Type value) {
+    qToLittleEndian<T>(toBCD(value), data+Offset);
+  }
+};
+
+/** Wraps a field and checks at compile time, that it is within an element of the given size. */
+template <size_t Size, class Field>
+struct Checked: public Field {
+  static_assert(Field::end <= Size, "Field exceeds the size of the element.");
+};
+
+/** Declares the fields of an element of the given size. Every field declared through the layout
+ * is checked against the element size at compile time. */
+template <size_t Size>
+struct Layout {
+  /** The size of the element. */
+  static constexpr size_t size = Size;
+
+  /** A single bit. */
+  template <size_t Offset, unsigned Bit>
+  using Flag = Checked<Size, CodeplugField::Flag<Offset, Bit>>;
+  /** A single inverted bit. */
+  template <size_t Offset, unsigned Bit>
+  using InvertedFlag = Checked<Size, CodeplugField::InvertedFlag<Offset, Bit>>;
+  /** A small unsigned integer within a byte. */
+  template <size_t Offset, unsigned Bit, unsigned Width>
+  using UInt = Checked<Size, CodeplugField::UInt<Offset, Bit, Width>>;
+  /** An unsigned byte. */
+  template <size_t Offset>
+  using UInt8 = Checked<Size, CodeplugField::UInt8<Offset>>;
+  /** A 16bit little-endian unsigned integer. */
+  template <size_t Offset>
+  using UInt16_le = Checked<Size, CodeplugField::UIntLE<Offset, uint16_t>>;
+  /** A 16bit big-endian unsigned integer. */
+  template <size_t Offset>
+  using UInt16_be = Checked<Size, CodeplugField::UIntBE<Offset, uint16_t>>;
+  /** A 32bit little-endian unsigned integer. */
+  template <size_t Offset>
+  using UInt32_le = Checked<Size, CodeplugField::UIntLE<Offset, uint32_t>>;
+  /** A 32bit big-endian unsigned integer. */
+  template <size_t Offset>
+  using UInt32_be = Checked<Size, CodeplugField::UIntBE<Offset, uint32_t>>;
+  /** A 4-digit BCD value in little-endian. */
+  template <size_t Offset>
+  using BCD4_le = Checked<Size, CodeplugField::BCDLE<Offset, uint16_t>>;
+  /** A 4-digit BCD value in big-endian. */
+  template <size_t Offset>
+  using BCD4_be = Checked<Size, CodeplugField::BCDBE<Offset, uint16_t>>;
+  /** A 8-digit BCD value in little-endian. */
+  template <size_t Offset>
+  using BCD8_le = Checked<Size, CodeplugField::BCDLE<Offset, uint32_t>>;
+  /** A 8-digit BCD value in big-endian. */
+  template <size_t Offset>
+  using BCD8_be = Checked<Size, CodeplugField::BCDBE<Offset, uint32_t>>;
+};
+
+}
+
+#endif // CODEPLUGFIELD_HH
@@ -6,6 +6,7 @@
 #include "encryptionextension.hh"
 #include "csvreader.hh"
 #include "userdatabase.hh"
+#include "configsnapshot.hh"
 #include "logger.hh"
 
 #include <QTextStream>
@@ -13,13 +14,90 @@
 #include <QFile>
 #include <QMetaProperty>
 #include <cmath>
+#include <ostream>
+
+/** Write-only stream buffer over a QTextStream.
+ * Allows yaml-cpp to emit the codeplug directly into the text stream, without assembling the
+ * complete document in memory first. Like <tt>QTextStream::operator<<(const char *)</tt>, the
+ * emitted bytes are passed as Latin-1 text. */
+class QTextStreamWriteBuffer: public std::streambuf
+{
+public:
+  /** Constructs a stream buffer writing into the given text stream. */
+  explicit QTextStreamWriteBuffer(QTextStream &stream)
+    : std::streambuf(), _stream(stream)
+  {
+    setp(_buffer, _buffer+sizeof(_buffer));
+  }
+
+  /** Destructor, flushes the buffer. */
+  virtual ~QTextStreamWriteBuffer() {
+    sync();
+  }
+
+protected:
+  int_type overflow(int_type c) {
+    sync();
+    if (! traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  int sync() {
+    if (pptr() > pbase())
+      _stream << QLatin1String(pbase(), int(pptr()-pbase()));
+    setp(_buffer, _buffer+sizeof(_buffer));
+    return 0;
+  }
+
+protected:
+  /** The stream to write into. */
+  QTextStream &_stream;
+  /** The write buffer. */
+  char _buffer[0x4000];
+};
+
+/** Emits the given list under the given key, one element at a time.
+ * This is equivalent to emitting the node created by @c ConfigObjectList::serialize. */
+inline bool emitList(YAML::Emitter &emitter, const char *key, ConfigObjectList *list,
+                     const ConfigItem::Context &context, const ErrorStack &err) {
+  emitter << YAML::Key << key << YAML::Value << YAML::BeginSeq;
+  for (int i=0; i<list->count(); i++) {
+    YAML::Node node = list->get(i)->serialize(context, err);
+    if (node.IsNull())
+      return false;
+    emitter << node;
+  }
+  emitter << YAML::EndSeq;
+  return true;
+}
+
+
+/* ********************************************************************************************* *
+ * Implementation of Config::Transaction
+ * ********************************************************************************************* */
+Config::Transaction::Transaction(Config *config)
+  : _config(config)
+{
+  if (_config)
+    _config->beginTransaction();
+}
+
+Config::Transaction::~Transaction() {
+  if (_config)
+    _config->commitTransaction();
+}
 
 
 /* ********************************************************************************************* *
  * Implementation of Config
  * ********************************************************************************************* */
 Config::Config(QObject *parent)
-  : ConfigItem(parent), _modified(false), _settings(new RadioSettings(this)),
+  : ConfigItem(parent), _modified(false), _transactions(0), _modifiedInTransaction(false),
+    _frozen(false),
+    _settings(new RadioSettings(this)),
     _radioIDs(new RadioIDList(this)), _contacts(new ContactList(this)),
     _rxGroupLists(new RXGroupLists(this)), _channels(new ChannelList(this)),
     _zones(new ZoneList(this)), _scanlists(new ScanLists(this)),
@@ -57,12 +135,23 @@ Config::Config(QObject *parent)
   connect(_roamingZones, SIGNAL(elementModified(int)), this, SLOT(onConfigModified()));
 
   connect(_commercialExtension, SIGNAL(modified(ConfigItem*)), this, SLOT(onConfigModified()));
+
+  // Reordering and coalesced notifications at the end of transactions
+  foreach (AbstractConfigObjectList *list, lists()) {
+    connect(list, SIGNAL(elementMoved(int,int)), this, SLOT(onConfigModified()));
+    connect(list, SIGNAL(elementsModified(int,int)), this, SLOT(onConfigModified()));
+    connect(list, SIGNAL(elementsReset()), this, SLOT(onConfigModified()));
+  }
 }
 
 bool
 Config::copy(const ConfigItem &other) {
   const Config *conf = other.as<Config>();
-  if ((nullptr==conf) || (! ConfigItem::copy(other)))
+  if (nullptr == conf)
+    return false;
+
+  Transaction transaction(this);
+  if (! ConfigItem::copy(other))
     return false;
 
   _settings->copy(*conf->settings());
@@ -98,20 +187,95 @@ Config::setModified(bool modified) {
   _modified = modified;
 }
 
+Config *
+Config::freeze(const ErrorStack &err) {
+  ConfigItem::Context context;
+  // Label all codeplug elements
+  if (! this->label(context, err))
+    return nullptr;
+  // Serialize into document tree
+  YAML::Node doc = serialize(context, err);
+  if (doc.IsNull())
+    return nullptr;
+
+  // Parse and link a new configuration, such that no object gets shared
+  Config *frozen = new Config();
+  bool ok = false;
+  {
+    Transaction transaction(frozen);
+    ConfigItem::Context frozenContext;
+    ok = frozen->parse(doc, frozenContext, err) && frozen->link(doc, frozenContext, err);
+  }
+  if (! ok) {
+    errMsg(err) << "Cannot create frozen copy of the configuration.";
+    delete frozen;
+    return nullptr;
+  }
+
+  frozen->_modified = false;
+  frozen->_frozen = true;
+  return frozen;
+}
+
+bool
+Config::isFrozen() const {
+  return _frozen;
+}
+
+void
+Config::beginTransaction() {
+  if (0 == _transactions++) {
+    foreach (AbstractConfigObjectList *list, lists())
+      list->beginUpdate();
+  }
+}
+
+void
+Config::commitTransaction() {
+  if (0 == _transactions)
+    return;
+  if (1 < _transactions) {
+    _transactions--;
+    return;
+  }
+
+  // Keep transaction open while lists emit their coalesced notifications
+  foreach (AbstractConfigObjectList *list, lists())
+    list->endUpdate();
+  _transactions = 0;
+
+  if (_modifiedInTransaction) {
+    _modifiedInTransaction = false;
+    emit modified(this);
+  }
+}
+
+bool
+Config::inTransaction() const {
+  return 0 != _transactions;
+}
+
+QList<AbstractConfigObjectList *>
+Config::lists() const {
+  return { _radioIDs, _contacts, _rxGroupLists, _channels, _zones, _scanlists, _gpsSystems,
+           _roamingChannels, _roamingZones };
+}
+
 bool
 Config::toYAML(QTextStream &stream, const ErrorStack &err) {
   ConfigItem::Context context;
   // Label all codeplug elements
   if (! this->label(context, err))
     return false;
-  // Serialize into YAML
-  YAML::Node doc = serialize(context, err);
-  if (doc.IsNull())
+  // Serialize into YAML, directly into the stream
+  QTextStreamWriteBuffer buffer(stream);
+  std::ostream out(&buffer);
+  YAML::Emitter emitter(out);
+  emitter << YAML::BeginDoc;
+  if (! emitYAML(emitter, context, err))
     return false;
-  // Print YAML
-  YAML::Emitter emitter;
-  emitter << YAML::BeginDoc << doc << YAML::EndDoc;
-  stream << emitter.c_str();
+  emitter << YAML::EndDoc;
+  out.flush();
   return true;
 }
 
@@ -167,6 +331,48 @@ Config::populate(YAML::Node &node, const Context &context, const ErrorStack &err
   return true;
 }
 
+bool
+Config::emitYAML(YAML::Emitter &emitter, const Context &context, const ErrorStack &err) {
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "version" << YAML::Value << VERSION_STRING;
+
+  YAML::Node settings = _settings->serialize(context, err);
+  if (settings.IsNull())
+    return false;
+  if (_radioIDs->defaultId() && context.contains(_radioIDs->defaultId()))
+    settings["defaultID"] = context.getId(_radioIDs->defaultId()).toStdString();
+  emitter << YAML::Key << "settings" << YAML::Value << settings;
+
+  if (! emitList(emitter, "radioIDs", _radioIDs, context, err))
+    return false;
+  if (! emitList(emitter, "contacts", _contacts, context, err))
+    return false;
+  if (! emitList(emitter, "groupLists", _rxGroupLists, context, err))
+    return false;
+  if (! emitList(emitter, "channels", _channels, context, err))
+    return false;
+  if (! emitList(emitter, "zones", _zones, context, err))
+    return false;
+  if (_scanlists->count() && (! emitList(emitter, "scanLists", _scanlists, context, err)))
+    return false;
+  if (_gpsSystems->count() && (! emitList(emitter, "positioning", _gpsSystems, context, err)))
+    return false;
+  if (_roamingChannels->count() && (! emitList(emitter, "roamingChannels", _roamingChannels, context, err)))
+    return false;
+  if (_roamingZones->count() && (! emitList(emitter, "roamingZones", _roamingZones, context, err)))
+    return false;
+
+  // Remaining (scriptable) properties, i.e., extensions
+  YAML::Node extensions;
+  if (! ConfigItem::populate(extensions, context, err))
+    return false;
+  for (YAML::const_iterator it=extensions.begin(); it!=extensions.end(); it++)
+    emitter << YAML::Key << it->first << YAML::Value << it->second;
+
+  emitter << YAML::EndMap;
+  return true;
+}
+
 RadioSettings *
 Config::settings() const {
   return _settings;
@@ -266,7 +472,10 @@ Config::clear() {
   _roamingChannels->clear();
   _roamingZones->clear();
 
-  emit modified(this);
+  if (_transactions)
+    _modifiedInTransaction = true;
+  else
+    emit modified(this);
 }
 
 const Config *
@@ -299,8 +508,13 @@ Config::setTyTExtension(TyTConfigExtension *ext) {
 
 void
 Config::onConfigModified() {
+  if (_frozen)
+    logError() << "Frozen configuration was modified. This is a bug.";
   _modified = true;
-  emit modified(this);
+  if (_transactions)
+    _modifiedInTransaction = true;
+  else
+    emit modified(this);
 }
 
 bool
@@ -315,7 +529,10 @@ Config::readCSV(const QString &filename, QString &errorMessage) {
 bool
 Config::readCSV(QTextStream &stream, QString &errorMessage)
 {
-  if (CSVReader::read(this, stream, errorMessage))
+  beginTransaction();
+  bool success = CSVReader::read(this, stream, errorMessage);
+  commitTransaction();
+  if (success)
     _modified = false;
   else
     return false;
@@ -345,6 +562,7 @@ Config::readYAML(const QString &filename, const ErrorStack &err) {
     return false;
   }
 
+  Transaction transaction(this);
   clear();
   ConfigItem::Context context;
 
@@ -357,6 +575,24 @@ Config::readYAML(const QString &filename, const ErrorStack &err) {
   return true;
 }
 
+bool
+Config::readSnapshot(const QString &filename, const ErrorStack &err) {
+  if (! ConfigSnapshot::read(filename, this, err)) {
+    errMsg(err) << "Cannot read codeplug snapshot from file '" << filename << "'.";
+    return false;
+  }
+  return true;
+}
+
+bool
+Config::writeSnapshot(const QString &filename, const ErrorStack &err) {
+  if (! ConfigSnapshot::write(this, filename, err)) {
+    errMsg(err) << "Cannot write codeplug snapshot to file '" << filename << "'.";
+    return false;
+  }
+  return true;
+}
+
 bool
 Config::parse(const YAML::Node &node, Context &ctx, const ErrorStack &err)
 {
@@ -68,6 +68,23 @@ class Config : public ConfigItem
 {
 	Q_OBJECT
 
+public:
+  /** Scoped transaction on a config, see @c Config::beginTransaction.
+   *
+   * The transaction gets committed once this object goes out of scope. */
+  class Transaction
+  {
+  public:
+    /** Begins a transaction on the given config. */
+    explicit Transaction(Config *config);
+    /** Commits the transaction. */
+    ~Transaction();
+
+  protected:
+    /** The config, the transaction was opened on. */
+    Config *_config;
+  };
+
   /** The global radio settings. */
   Q_PROPERTY(RadioSettings* settings READ settings SCRIPTABLE false)
   /** The list of radio IDs. */
@@ -106,6 +123,31 @@ public:
   /** Sets the modified flag. */
   void setModified(bool modified);
 
+  /** Creates a frozen copy of this configuration.
+   *
+   * Unlike @c clone, the copy is created by serializing and parsing the configuration. Hence all
+   * references within the copy point to objects of the copy and none of its objects is shared with
+   * this configuration. The frozen copy must not be modified. As it is never modified, it can be
+   * read concurrently from several threads, e.g., to encode and verify codeplugs for several radios
+   * while this configuration is still being edited. The caller takes the ownership of the copy.
+   * Returns @c nullptr on error. */
+  Config *freeze(const ErrorStack &err=ErrorStack());
+  /** Returns @c true if this configuration is a frozen copy, @see freeze. */
+  bool isFrozen() const;
+
+  /** Begins a transaction on the configuration.
+   *
+   * While a transaction is open, all lists of the configuration suppress their per-element
+   * change notifications and the @c modified signal of the configuration is deferred. On commit,
+   * each list emits a single coalesced notification (see @c AbstractConfigObjectList::beginUpdate)
+   * and the configuration emits @c modified once, if anything was changed. Use this for bulk
+   * changes like decoding or parsing codeplugs. Transactions can be nested. */
+  void beginTransaction();
+  /** Commits the current transaction. */
+  void commitTransaction();
+  /** Returns @c true if a transaction is open. */
+  bool inTransaction() const;
+
   /** Returns the radio wide settings. */
   RadioSettings *settings() const;
   /** Returns the list of radio IDs. */
@@ -126,6 +168,8 @@ public:
   RoamingChannelList *roamingChannels() const;
   /** Returns the list of roaming zones. */
   RoamingZoneList *roamingZones() const;
+  /** Returns all lists of the configuration. */
+  QList<AbstractConfigObjectList *> lists() const;
 
   /** Returns @c true if one of the digital channels has a roaming zone assigned. */
   bool requiresRoaming() const;
@@ -153,7 +197,9 @@ public:
   /** Imports a configuration from the given text stream in text format. */
   bool readCSV(QTextStream &stream, QString &errorMessage);
 
-  /** Imports a configuration from the given YAML file. */
+  /** Imports a configuration from the given YAML file.
+   * The file is loaded into a YAML node tree first. Then all objects are created from it by
+   * @c parse and the references between them are resolved by @c link. */
   bool readYAML(const QString &filename, const ErrorStack &err=ErrorStack());
 
   bool parse(const YAML::Node &node, Context &ctx, const ErrorStack &err=ErrorStack());
@@ -163,8 +209,19 @@ public:
   /** Serializes the configuration into the given stream as text. */
   bool toYAML(QTextStream &stream, const ErrorStack &err=ErrorStack());
 
+  /** Imports a configuration from the given binary snapshot file.
+   * @see ConfigSnapshot for details on the format. */
+  bool readSnapshot(const QString &filename, const ErrorStack &err=ErrorStack());
+  /** Saves the configuration as a binary snapshot into the given file.
+   * @see ConfigSnapshot for details on the format. */
+  bool writeSnapshot(const QString &filename, const ErrorStack &err=ErrorStack());
+
 protected:
   bool populate(YAML::Node &node, const Context &context, const ErrorStack &err=ErrorStack());
+  /** Serializes the labeled configuration into the given emitter.
+   * Produces the same output as emitting the node created by @c populate. However, only the
+   * YAML node of a single object is held in memory at a time. */
+  bool emitYAML(YAML::Emitter &emitter, const Context &context, const ErrorStack &err=ErrorStack());
 
 protected slots:
   /** Iternal callback. */
@@ -173,6 +230,12 @@ protected slots:
 protected:
   /** If @c true, the configuration was modified. */
   bool _modified;
+  /** Nesting depth of transactions. */
+  unsigned _transactions;
+  /** If @c true, the configuration was modified during the current transaction. */
+  bool _modifiedInTransaction;
+  /** If @c true, the configuration is a frozen copy and must not be modified. */
+  bool _frozen;
   /** Radio wide settings. */
   RadioSettings *_settings;
   /** The list of radio IDs. */
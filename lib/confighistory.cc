@@ -0,0 +1,563 @@
+#include "confighistory.hh"
+#include "config.hh"
+#include "logger.hh"
+
+#include <algorithm>
+
+#define HISTORY_DEFAULT_LIMIT       100
+#define HISTORY_MAX_COMMIT_DELAYS   3
+
+
+/* ********************************************************************************************* *
+ * Implementation of ConfigHistory
+ * ********************************************************************************************* */
+ConfigHistory::ConfigHistory(Config *config, QObject *parent)
+  : QObject(parent), _config(config), _context(), _state(), _order(), _detached(), _dirty(),
+    _current(), _commitTimer(), _commitDelays(0), _undo(), _redo(), _limit(HISTORY_DEFAULT_LIMIT),
+    _applying(false)
+{
+  _commitTimer.setSingleShot(true);
+  _commitTimer.setInterval(0);
+  connect(&_commitTimer, SIGNAL(timeout()), this, SLOT(onCommitTimeout()));
+
+  connect(_config->settings(), SIGNAL(modified(ConfigItem*)), this, SLOT(onItemModified(ConfigItem*)));
+  foreach (AbstractConfigObjectList *list, _config->lists()) {
+    connect(list, SIGNAL(elementAdded(int)), this, SLOT(onElementAdded(int)));
+    connect(list, SIGNAL(elementModified(int)), this, SLOT(onElementModified(int)));
+    connect(list, SIGNAL(elementRemoved(int)), this, SLOT(onElementRemoved(int)));
+    connect(list, SIGNAL(elementMoved(int,int)), this, SLOT(onElementMoved(int,int)));
+    connect(list, SIGNAL(elementsModified(int,int)), this, SLOT(onElementsModified(int,int)));
+    connect(list, SIGNAL(elementsReset()), this, SLOT(onElementsReset()));
+  }
+
+  reset();
+}
+
+bool
+ConfigHistory::canUndo() const {
+  return (! _undo.isEmpty()) || (! _current.isEmpty()) || (! _dirty.isEmpty());
+}
+
+bool
+ConfigHistory::canRedo() const {
+  return ! _redo.isEmpty();
+}
+
+unsigned
+ConfigHistory::limit() const {
+  return _limit;
+}
+
+void
+ConfigHistory::setLimit(unsigned limit) {
+  _limit = std::max(1U, limit);
+  while (unsigned(_undo.size()) > _limit)
+    _undo.removeFirst();
+}
+
+bool
+ConfigHistory::undo(const ErrorStack &err) {
+  commit();
+  if (_undo.isEmpty())
+    return false;
+
+  Step step = _undo.takeLast();
+  bool ok = apply(step, false, err);
+  _redo.append(step);
+
+  emit undoAvailable(canUndo());
+  emit redoAvailable(true);
+
+  if (! ok)
+    errMsg(err) << "Cannot undo last change completely.";
+  return ok;
+}
+
+bool
+ConfigHistory::redo(const ErrorStack &err) {
+  commit();
+  if (_redo.isEmpty())
+    return false;
+
+  Step step = _redo.takeLast();
+  bool ok = apply(step, true, err);
+  _undo.append(step);
+
+  emit undoAvailable(true);
+  emit redoAvailable(canRedo());
+
+  if (! ok)
+    errMsg(err) << "Cannot redo last change completely.";
+  return ok;
+}
+
+void
+ConfigHistory::commit() {
+  _commitTimer.stop();
+  _commitDelays = 0;
+  if (_current.isEmpty() && _dirty.isEmpty())
+    return;
+
+  Step step = _current;
+  _current.clear();
+
+  // Serialize modified items and record those, that actually changed
+  foreach (ConfigItem *item, _dirty) {
+    ErrorStack err;
+    YAML::Node node = serialize(item, err);
+    if ((! node) || node.IsNull()) {
+      logWarn() << "Cannot record modification of " << item->metaObject()->className()
+                << ": " << err.format();
+      continue;
+    }
+    if (_state.contains(item) && (! equal(_state[item], node))) {
+      ConfigObject *obj = item->as<ConfigObject>();
+      step.append({Change::Type::Modified, obj ? qobject_cast<ConfigObjectList *>(obj->parent()) : nullptr,
+                   obj ? nullptr : item, obj ? _context.getId(obj) : QString(), -1, -1,
+                   _state[item], node});
+    }
+    setState(item, node);
+  }
+  _dirty.clear();
+
+  // Objects added during batch updates are serialized once all of them are labeled
+  for (int i=0; i<step.size(); i++) {
+    if ((Change::Type::Added != step.at(i).type) || step.at(i).after)
+      continue;
+    if (ConfigObject *obj = _context.getObj(step.at(i).id))
+      step[i].after.reset(_state.value(obj));
+  }
+
+  if (step.isEmpty()) {
+    emit undoAvailable(canUndo());
+    return;
+  }
+
+  bool couldRedo = canRedo();
+  _undo.append(step);
+  while (unsigned(_undo.size()) > _limit)
+    _undo.removeFirst();
+  _redo.clear();
+
+  emit undoAvailable(true);
+  if (couldRedo)
+    emit redoAvailable(false);
+}
+
+void
+ConfigHistory::reset() {
+  _commitTimer.stop();
+  _commitDelays = 0;
+  _current.clear();
+  _dirty.clear();
+  _undo.clear();
+  _redo.clear();
+  _state.clear();
+  _order.clear();
+
+  foreach (ConfigObject *obj, _detached)
+    obj->deleteLater();
+  _detached.clear();
+
+  // Label all objects first, as references are serialized by ID
+  _context = ConfigItem::Context();
+  foreach (AbstractConfigObjectList *lst, _config->lists()) {
+    ConfigObjectList *list = qobject_cast<ConfigObjectList *>(lst);
+    if (nullptr == list)
+      continue;
+    updateOrder(list);
+    for (int i=0; i<list->count(); i++)
+      track(list->get(i));
+  }
+
+  // Then take the current version of each item
+  ErrorStack err;
+  setState(_config->settings(), serialize(_config->settings(), err));
+  foreach (ConfigObjectList *list, _order.keys()) {
+    foreach (ConfigObject *obj, _order[list])
+      setState(obj, serialize(obj, err));
+  }
+  if (! err.isEmpty())
+    logWarn() << "Cannot serialize configuration for history: " << err.format();
+
+  emit undoAvailable(false);
+  emit redoAvailable(false);
+}
+
+void
+ConfigHistory::track(ConfigObject *obj) {
+  if (! _context.contains(obj))
+    obj->label(_context);
+  connect(obj, SIGNAL(destroyed(QObject*)), this, SLOT(onObjectDeleted(QObject*)), Qt::UniqueConnection);
+}
+
+void
+ConfigHistory::record(const Change &change) {
+  bool couldUndo = canUndo();
+  _current.append(change);
+  if (! _commitTimer.isActive())
+    _commitTimer.start();
+  if (! couldUndo)
+    emit undoAvailable(true);
+}
+
+YAML::Node
+ConfigHistory::serialize(ConfigItem *item, const ErrorStack &err) {
+  return item->serialize(_context, err);
+}
+
+void
+ConfigHistory::setState(ConfigItem *item, const YAML::Node &node) {
+  // Rebind the node, assigning would overwrite the shared previous version.
+  _state[item].reset(node);
+}
+
+void
+ConfigHistory::updateOrder(ConfigObjectList *list) {
+  QVector<ConfigObject *> &order = _order[list];
+  order.resize(list->count());
+  for (int i=0; i<list->count(); i++)
+    order[i] = list->get(i);
+}
+
+bool
+ConfigHistory::deletionPending() const {
+  // Objects deleted by their list are still owned by it until the deferred deletion. Their
+  // references get cleared on deletion, which belongs to the same step.
+  foreach (const Change &change, _current) {
+    if (Change::Type::Removed != change.type)
+      continue;
+    ConfigObject *obj = _context.getObj(change.id);
+    if (obj && (change.list == obj->parent()) && (! change.list->has(obj)))
+      return true;
+  }
+  return false;
+}
+
+bool
+ConfigHistory::apply(const Step &step, bool forward, const ErrorStack &err) {
+  struct Content { ConfigItem *item; ConfigObjectList *list; YAML::Node node; };
+  QList<Content> contents;
+  QSet<ConfigObjectList *> lists;
+  ConfigItem::Context scratch;
+  bool ok = true;
+
+  _applying = true;
+  {
+    Config::Transaction transaction(_config);
+
+    // First, restore the structure of the lists
+    for (int i=0; i<step.size(); i++) {
+      const Change &change = step.at(forward ? i : (step.size()-1-i));
+      bool add = (forward && (Change::Type::Added == change.type)) ||
+          ((! forward) && (Change::Type::Removed == change.type));
+      bool remove = (forward && (Change::Type::Removed == change.type)) ||
+          ((! forward) && (Change::Type::Added == change.type));
+
+      if (Change::Type::Modified == change.type) {
+        ConfigItem *item = change.item ? change.item : _context.getObj(change.id);
+        if (nullptr == item) {
+          errMsg(err) << "Cannot restore object '" << change.id << "': Object was deleted.";
+          ok = false;
+          continue;
+        }
+        contents.append({item, change.list, forward ? change.after : change.before});
+      } else if (add) {
+        const YAML::Node &node = forward ? change.after : change.before;
+        ConfigObject *obj = materialize(change.id, node, change.list, scratch, err);
+        if (nullptr == obj) {
+          ok = false;
+          continue;
+        }
+        _detached.remove(obj);
+        if (! change.list->has(obj))
+          change.list->add(obj, std::min(change.index, change.list->count()));
+        if (node.IsMap())
+          contents.append({obj, change.list, node});
+        lists.insert(change.list);
+      } else if (remove) {
+        if (ConfigObject *obj = _context.getObj(change.id))
+          detach(obj, change.list);
+        lists.insert(change.list);
+      } else if (Change::Type::Moved == change.type) {
+        int from = forward ? change.index : change.other, to = forward ? change.other : change.index;
+        ConfigObject *obj = change.list->get(from);
+        if ((nullptr == obj) || (change.id != _context.getId(obj))) {
+          errMsg(err) << "Cannot move object '" << change.id << "': Not found at index " << from << ".";
+          ok = false;
+          continue;
+        }
+        change.list->take(obj);
+        change.list->add(obj, std::min(to, change.list->count()));
+        lists.insert(change.list);
+      }
+    }
+
+    // Then restore the content, once all referenced objects are present
+    foreach (const Content &content, contents)
+      ok = restore(content.item, content.list, content.node, err) && ok;
+  }
+
+  foreach (ConfigObjectList *list, lists)
+    updateOrder(list);
+  _applying = false;
+
+  return ok;
+}
+
+ConfigObject *
+ConfigHistory::materialize(const QString &id, const YAML::Node &node, ConfigObjectList *list,
+                           ConfigItem::Context &scratch, const ErrorStack &err)
+{
+  if (ConfigObject *obj = _context.getObj(id))
+    return obj;
+
+  // Object was deleted -> re-create it under the same ID
+  if ((! node) || (! node.IsMap())) {
+    errMsg(err) << "Cannot restore object '" << id << "': No recorded version.";
+    return nullptr;
+  }
+  ConfigItem *item = list->allocateChild(node, scratch, err);
+  ConfigObject *obj = item ? item->as<ConfigObject>() : nullptr;
+  if (nullptr == obj) {
+    errMsg(err) << "Cannot restore object '" << id << "'.";
+    if (item)
+      item->deleteLater();
+    return nullptr;
+  }
+
+  _context.add(id, obj);
+  track(obj);
+  return obj;
+}
+
+bool
+ConfigHistory::restore(ConfigItem *item, ConfigObjectList *list, const YAML::Node &node, const ErrorStack &err) {
+  // Parse a fresh instance and copy it, the same way edits are applied by the editor
+  ConfigItem::Context scratch;
+  ConfigItem *fresh = nullptr;
+  if (item->is<ConfigObject>()) {
+    if (list)
+      fresh = list->allocateChild(node, scratch, err);
+  } else if ((fresh = item->clone())) {
+    fresh->clear();
+  }
+
+  if (nullptr == fresh) {
+    errMsg(err) << "Cannot restore " << item->metaObject()->className() << ".";
+    return false;
+  }
+
+  if ((! fresh->parse(node, scratch, err)) || (! fresh->link(node, _context, err))
+      || (! item->copy(*fresh))) {
+    errMsg(err) << "Cannot restore " << item->metaObject()->className() << ".";
+    fresh->deleteLater();
+    return false;
+  }
+  fresh->deleteLater();
+
+  setState(item, node);
+  return true;
+}
+
+void
+ConfigHistory::detach(ConfigObject *obj, ConfigObjectList *list) {
+  list->take(obj);
+  obj->setParent(this);
+  _detached.insert(obj);
+}
+
+bool
+ConfigHistory::equal(const YAML::Node &a, const YAML::Node &b) {
+  if ((a.Type() != b.Type()) || (a.Tag() != b.Tag()))
+    return false;
+
+  switch (a.Type()) {
+  case YAML::NodeType::Scalar:
+    return a.Scalar() == b.Scalar();
+
+  case YAML::NodeType::Sequence: {
+    if (a.size() != b.size())
+      return false;
+    YAML::const_iterator ia=a.begin(), ib=b.begin();
+    for (; ia!=a.end(); ia++, ib++) {
+      if (! equal(*ia, *ib))
+        return false;
+    }
+  } return true;
+
+  case YAML::NodeType::Map: {
+    if (a.size() != b.size())
+      return false;
+    // Maps are serialized in property order, a different order is treated as a modification
+    YAML::const_iterator ia=a.begin(), ib=b.begin();
+    for (; ia!=a.end(); ia++, ib++) {
+      if ((ia->first.Scalar() != ib->first.Scalar()) || (! equal(ia->second, ib->second)))
+        return false;
+    }
+  } return true;
+
+  default:
+    break;
+  }
+
+  return true;
+}
+
+void
+ConfigHistory::onElementAdded(int idx) {
+  ConfigObjectList *list = qobject_cast<ConfigObjectList *>(sender());
+  if (_applying || (nullptr == list) || (nullptr == list->get(idx)))
+    return;
+
+  ConfigObject *obj = list->get(idx);
+  track(obj);
+  _order[list].insert(idx, obj);
+
+  // Referenced objects are usually present, otherwise the object is serialized on commit
+  ErrorStack err;
+  YAML::Node node = serialize(obj, err);
+  if (node && (! node.IsNull()))
+    setState(obj, node);
+  else
+    node.reset();
+  _dirty.insert(obj);
+
+  record({Change::Type::Added, list, nullptr, _context.getId(obj), idx, idx, YAML::Node(), node});
+}
+
+void
+ConfigHistory::onElementModified(int idx) {
+  ConfigObjectList *list = qobject_cast<ConfigObjectList *>(sender());
+  if (_applying || (nullptr == list) || (nullptr == list->get(idx)))
+    return;
+  onItemModified(list->get(idx));
+}
+
+void
+ConfigHistory::onElementRemoved(int idx) {
+  ConfigObjectList *list = qobject_cast<ConfigObjectList *>(sender());
+  if (_applying || (nullptr == list))
+    return;
+
+  QVector<ConfigObject *> &order = _order[list];
+  if (idx >= order.size()) {
+    logWarn() << "History out of sync with " << list->metaObject()->className() << ".";
+    updateOrder(list);
+    return;
+  }
+
+  // The object may already be destroyed, only its address is used here
+  ConfigObject *obj = order.takeAt(idx);
+  _dirty.remove(obj);
+  if (! _context.contains(obj))
+    return;
+
+  record({Change::Type::Removed, list, nullptr, _context.getId(obj), idx, idx,
+          _state.value(obj), YAML::Node()});
+}
+
+void
+ConfigHistory::onElementMoved(int from, int to) {
+  ConfigObjectList *list = qobject_cast<ConfigObjectList *>(sender());
+  if (_applying || (nullptr == list))
+    return;
+
+  QVector<ConfigObject *> &order = _order[list];
+  if ((from >= order.size()) || (to >= order.size())) {
+    updateOrder(list);
+    return;
+  }
+  ConfigObject *obj = order.takeAt(from);
+  order.insert(to, obj);
+
+  record({Change::Type::Moved, list, nullptr, _context.getId(obj), from, to,
+          YAML::Node(), YAML::Node()});
+}
+
+void
+ConfigHistory::onElementsModified(int first, int last) {
+  ConfigObjectList *list = qobject_cast<ConfigObjectList *>(sender());
+  if (_applying || (nullptr == list))
+    return;
+  for (int i=first; i<=last; i++) {
+    if (ConfigObject *obj = list->get(i))
+      onItemModified(obj);
+  }
+}
+
+void
+ConfigHistory::onElementsReset() {
+  ConfigObjectList *list = qobject_cast<ConfigObjectList *>(sender());
+  if (_applying || (nullptr == list))
+    return;
+
+  // Modifications are not reported during batch updates, hence all elements are checked on commit.
+  // The structural changes are derived from the mirrored order: Removed elements first ...
+  QVector<ConfigObject *> &order = _order[list];
+  for (int i=order.size()-1; i>=0; i--) {
+    ConfigObject *obj = order.at(i);
+    if (list->has(obj))
+      continue;
+    order.remove(i);
+    _dirty.remove(obj);
+    if (_context.contains(obj))
+      record({Change::Type::Removed, list, nullptr, _context.getId(obj), i, i,
+              _state.value(obj), YAML::Node()});
+  }
+
+  // ... then added and moved ones.
+  for (int i=0; i<list->count(); i++) {
+    ConfigObject *obj = list->get(i);
+    _dirty.insert(obj);
+    if ((i < order.size()) && (obj == order.at(i)))
+      continue;
+    int from = order.indexOf(obj, i);
+    if (0 > from) {
+      track(obj);
+      order.insert(i, obj);
+      record({Change::Type::Added, list, nullptr, _context.getId(obj), i, i,
+              YAML::Node(), YAML::Node()});
+    } else {
+      order.remove(from);
+      order.insert(i, obj);
+      record({Change::Type::Moved, list, nullptr, _context.getId(obj), from, i,
+              YAML::Node(), YAML::Node()});
+    }
+  }
+
+  if (! _commitTimer.isActive())
+    _commitTimer.start();
+}
+
+void
+ConfigHistory::onItemModified(ConfigItem *item) {
+  if (_applying || (nullptr == item))
+    return;
+
+  bool couldUndo = canUndo();
+  _dirty.insert(item);
+  if (! _commitTimer.isActive())
+    _commitTimer.start();
+  if (! couldUndo)
+    emit undoAvailable(true);
+}
+
+void
+ConfigHistory::onObjectDeleted(QObject *obj) {
+  // Use reinterpret cast here as the obj may already be destroyed and this all RTTI freed.
+  ConfigObject *cobj = reinterpret_cast<ConfigObject *>(obj);
+  _context.remove(cobj);
+  _state.remove(cobj);
+  _dirty.remove(cobj);
+  _detached.remove(cobj);
+}
+
+void
+ConfigHistory::onCommitTimeout() {
+  if (deletionPending() && (_commitDelays++ < HISTORY_MAX_COMMIT_DELAYS)) {
+    _commitTimer.start();
+    return;
+  }
+  commit();
+}
@@ -0,0 +1,179 @@
+#ifndef CONFIGHISTORY_HH
+#define CONFIGHISTORY_HH
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVector>
+#include <QTimer>
+#include <yaml-cpp/yaml.h>
+
+#include "configobject.hh"
+
+class Config;
+
+
+/** Records the modifications of a configuration to provide undo and redo.
+ *
+ * A complete copy of the configuration per edit step is far too expensive. Instead, the history
+ * keeps the serialized YAML node of every object of the configuration (the current version).
+ * Whenever an object is modified, added, removed or moved, only this object gets serialized again
+ * and the previous and new node are recorded as a change. All unchanged objects share their node
+ * between versions. Hence recording as well as undoing and redoing a step costs time and memory
+ * proportional to the size of the edit, not to the size of the configuration. Only the initial
+ * labeling in @c reset is proportional to the size of the configuration.
+ *
+ * Objects are identified by persistent IDs assigned by the history. This allows to restore deleted
+ * objects together with all references to them. All changes signaled until the control returns
+ * to the event loop are collected into a single step. Objects removed by undo or redo are not
+ * deleted but kept by the history until the next @c reset, such that they can be restored later.
+ *
+ * @ingroup conf */
+class ConfigHistory : public QObject
+{
+  Q_OBJECT
+
+protected:
+  /** A single recorded change of an object. */
+  struct Change {
+    /** Possible change types. */
+    enum class Type {
+      Modified, ///< The object was modified.
+      Added,    ///< The object was added to the list.
+      Removed,  ///< The object was removed from the list.
+      Moved     ///< The object was moved from @c index to @c other.
+    };
+
+    /** The type of the change. */
+    Type type;
+    /** The list of the object or @c nullptr for a modified item, that is not an object. */
+    ConfigObjectList *list;
+    /** The item, if not an object within a list. */
+    ConfigItem *item;
+    /** The ID of the object. */
+    QString id;
+    /** The list index of the object. */
+    int index;
+    /** The new index for moved objects. */
+    int other;
+    /** The node of the object before the change. */
+    YAML::Node before;
+    /** The node of the object after the change. */
+    YAML::Node after;
+  };
+
+  /** A step is a sequence of changes, that gets undone and redone at once. */
+  typedef QList<Change> Step;
+
+public:
+  /** Constructs the history for the given configuration. */
+  explicit ConfigHistory(Config *config, QObject *parent=nullptr);
+
+  /** Returns @c true if there is a step to undo. */
+  bool canUndo() const;
+  /** Returns @c true if there is a step to redo. */
+  bool canRedo() const;
+
+  /** Returns the maximum number of steps kept. */
+  unsigned limit() const;
+  /** Sets the maximum number of steps kept. */
+  void setLimit(unsigned limit);
+
+  /** Undoes the last step. */
+  bool undo(const ErrorStack &err=ErrorStack());
+  /** Redoes the last undone step. */
+  bool redo(const ErrorStack &err=ErrorStack());
+
+public slots:
+  /** Closes the current step. Usually, this happens automatically once the control returns to
+   * the event loop. */
+  void commit();
+  /** Discards all steps and takes the current configuration as the initial version.
+   * Must be called whenever the configuration was replaced (e.g., loaded or downloaded). */
+  void reset();
+
+signals:
+  /** Gets emitted if the undo availability changed. */
+  void undoAvailable(bool available);
+  /** Gets emitted if the redo availability changed. */
+  void redoAvailable(bool available);
+
+protected:
+  /** Starts tracking the given object. */
+  void track(ConfigObject *obj);
+  /** Appends the given change to the current step and schedules the commit. */
+  void record(const Change &change);
+  /** Serializes the given item. */
+  YAML::Node serialize(ConfigItem *item, const ErrorStack &err=ErrorStack());
+  /** Stores the given node as the current version of the item. */
+  void setState(ConfigItem *item, const YAML::Node &node);
+  /** Rebuilds the mirrored order of the given list. */
+  void updateOrder(ConfigObjectList *list);
+  /** Returns @c true, if an object removed in the current step is still waiting for deletion. */
+  bool deletionPending() const;
+
+  /** Applies the step forward (redo) or backward (undo). */
+  bool apply(const Step &step, bool forward, const ErrorStack &err=ErrorStack());
+  /** Returns the object with the given ID, re-creates it from the node if it was deleted. */
+  ConfigObject *materialize(const QString &id, const YAML::Node &node, ConfigObjectList *list,
+                            ConfigItem::Context &scratch, const ErrorStack &err=ErrorStack());
+  /** Restores the content of the item from the given node. */
+  bool restore(ConfigItem *item, ConfigObjectList *list, const YAML::Node &node,
+               const ErrorStack &err=ErrorStack());
+  /** Removes the given object from its list and keeps it. */
+  void detach(ConfigObject *obj, ConfigObjectList *list);
+
+  /** Returns @c true if both nodes are equal. */
+  static bool equal(const YAML::Node &a, const YAML::Node &b);
+
+protected slots:
+  /** Internal callback on added list elements. */
+  void onElementAdded(int idx);
+  /** Internal callback on modified list elements. */
+  void onElementModified(int idx);
+  /** Internal callback on removed list elements. */
+  void onElementRemoved(int idx);
+  /** Internal callback on moved list elements. */
+  void onElementMoved(int from, int to);
+  /** Internal callback on coalesced modifications. */
+  void onElementsModified(int first, int last);
+  /** Internal callback on coalesced structural changes. */
+  void onElementsReset();
+  /** Internal callback on modified items, that are not part of a list. */
+  void onItemModified(ConfigItem *item);
+  /** Internal callback on deleted objects. */
+  void onObjectDeleted(QObject *obj);
+  /** Internal callback to close the current step. */
+  void onCommitTimeout();
+
+protected:
+  /** The configuration. */
+  Config *_config;
+  /** Assigns persistent IDs to all objects. */
+  ConfigItem::Context _context;
+  /** The current version of every tracked item. */
+  QHash<ConfigItem *, YAML::Node> _state;
+  /** Mirrors the order of each list, needed to identify removed elements. */
+  QHash<ConfigObjectList *, QVector<ConfigObject *>> _order;
+  /** Objects removed by undo or redo. */
+  QSet<ConfigObject *> _detached;
+  /** Items modified during the current step. */
+  QSet<ConfigItem *> _dirty;
+  /** The current step. */
+  Step _current;
+  /** Closes the current step once the control returns to the event loop. */
+  QTimer _commitTimer;
+  /** Number of times, the commit was delayed waiting for deleted objects. */
+  unsigned _commitDelays;
+  /** The undo stack. */
+  QList<Step> _undo;
+  /** The redo stack. */
+  QList<Step> _redo;
+  /** Maximum number of steps. */
+  unsigned _limit;
+  /** If @c true, changes are applied by the history and not recorded. */
+  bool _applying;
+};
+
+#endif // CONFIGHISTORY_HH
@@ -4,6 +4,8 @@
 
 #include <QMetaProperty>
 #include <QMetaEnum>
+#include <QReadWriteLock>
+#include <algorithm>
 
 // Helper function to extract key names for a QMetaEnum
 inline QStringList enumKeys(const QMetaEnum &e) {
@@ -33,7 +35,7 @@ QHash<QString, QHash<ConfigObject *, QString>> ConfigObject::Context::_tagNames
     QHash<QString, QHash<ConfigObject *, QString>>();
 
 ConfigItem::Context::Context()
-  : _version(), _objects(), _ids()
+  : _version(), _objects(), _ids(), _nextIds()
 {
   // pass...
 }
@@ -80,6 +82,24 @@ ConfigItem::Context::add(const QString &id, ConfigObject *obj) {
   return true;
 }
 
+void
+ConfigItem::Context::remove(ConfigObject *obj) {
+  if (! _ids.contains(obj))
+    return;
+  _objects.remove(_ids.take(obj));
+}
+
+QString
+ConfigItem::Context::nextId(const QString &prefix) {
+  unsigned &n = _nextIds[prefix];
+  if (0 == n)
+    n = 1;
+  QString id = prefix + QString::number(n);
+  while (contains(id))
+    id = prefix + QString::number(++n);
+  return id;
+}
+
 bool
 ConfigItem::Context::hasTag(const QString &className, const QString &property, const QString &tag) {
   QString qname = className+"::"+property;
@@ -144,55 +164,60 @@ ConfigItem::copy(const ConfigItem &other) {
   // clear this instance
   this->clear();
 
-  // Iterate over all properties
-  const QMetaObject *meta = metaObject();
-  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
-    // This property
-    QMetaProperty prop = meta->property(p);
-    // the same property over at other
-    QMetaProperty oprop = other.metaObject()->property(p);
-
-    // Should never happen
-    if (! prop.isValid()) {
-      logWarn() << "Invalid property " << prop.name() << ". This should not happen.";
-      continue;
-    }
-
-    // true if the property is a basic type
-    bool isBasicType = ( prop.isEnumType() || (QVariant::Bool==prop.type()) ||
-                         (QVariant::Int==prop.type()) || (QVariant::UInt==prop.type()) ||
-                         (QVariant::Double==prop.type()) ||(QVariant::String==prop.type()));
-
-    // If a basic type -> simply copy value
-    if (isBasicType && prop.isWritable() && (prop.type()==oprop.type())) {
-      if (! prop.write(this, oprop.read(&other))) {
+  // Iterate over all properties, as other is of the same type, the same plan applies to both
+  foreach (const PropertyInfo &info, propertyPlan().properties) {
+    const QMetaProperty &prop = info.prop;
+    switch (info.kind) {
+    case PropertyKind::Enum:
+    case PropertyKind::Bool:
+    case PropertyKind::Int:
+    case PropertyKind::UInt:
+    case PropertyKind::Double:
+    case PropertyKind::String:
+      // If a basic type -> simply copy value
+      if (prop.isWritable() && (! prop.write(this, prop.read(&other)))) {
         logError() << "Cannot set property '" << prop.name() << "' of "
                    << this->metaObject()->className() << ".";
         return false;
       }
-    } else if (ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>()) {
-      if (! ref->copy(oprop.read(&other).value<ConfigObjectReference*>())) {
-        logError() << "Cannot copy object reference '" << prop.name() << "' of "
-                   << this->metaObject()->className() << ".";
-        return false;
+      break;
+
+    case PropertyKind::Reference:
+      if (ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>()) {
+        if (! ref->copy(prop.read(&other).value<ConfigObjectReference*>())) {
+          logError() << "Cannot copy object reference '" << prop.name() << "' of "
+                     << this->metaObject()->className() << ".";
+          return false;
+        }
       }
-    } else if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
-      if (! lst->copy(*oprop.read(&other).value<ConfigObjectList*>())) {
-        logError() << "Cannot copy object list '" << prop.name() << "' of "
-                   << this->metaObject()->className() << ".";
-        return false;
+      break;
+
+    case PropertyKind::List:
+      if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
+        if (! lst->copy(*prop.read(&other).value<ConfigObjectList*>())) {
+          logError() << "Cannot copy object list '" << prop.name() << "' of "
+                     << this->metaObject()->className() << ".";
+          return false;
+        }
       }
-    } else if (ConfigObjectRefList *lst = prop.read(this).value<ConfigObjectRefList *>()) {
-      if (! lst->copy(*oprop.read(&other).value<ConfigObjectRefList*>())) {
-        logError() << "Cannot copy reference list '" << prop.name() << "' of "
-                   << this->metaObject()->className() << ".";
-        return false;
+      break;
+
+    case PropertyKind::RefList:
+      if (ConfigObjectRefList *lst = prop.read(this).value<ConfigObjectRefList *>()) {
+        if (! lst->copy(*prop.read(&other).value<ConfigObjectRefList*>())) {
+          logError() << "Cannot copy reference list '" << prop.name() << "' of "
+                     << this->metaObject()->className() << ".";
+          return false;
+        }
       }
-    } else if (propIsInstance<ConfigItem>(prop)) {
+      break;
+
+    case PropertyKind::Item: {
+      ConfigItem *oitem = prop.read(&other).value<ConfigItem*>();
       // If the item is owned by this item
       if (prop.isWritable()) {
         // If the owned item is writeable -> clone if set in other
-        if (oprop.read(&other).isNull()) {
+        if (nullptr == oitem) {
           if (! prop.write(this, QVariant::fromValue<ConfigItem*>(nullptr))) {
             logError() << "Cannot delete item '" << prop.name() << "' of "
                        << this->metaObject()->className() << ".";
@@ -200,9 +225,9 @@ ConfigItem::copy(const ConfigItem &other) {
           }
         } else {
           // Clone element form other item
-          ConfigItem *cl = oprop.read(&other).value<ConfigItem*>()->clone();
+          ConfigItem *cl = oitem->clone();
           if (nullptr == cl) {
-            logError() << "Cannot clone item '" << oprop.name() << "' of "
+            logError() << "Cannot clone item '" << prop.name() << "' of "
                        << other.metaObject()->className() << ".";
             return false;
           }
@@ -214,14 +239,18 @@ ConfigItem::copy(const ConfigItem &other) {
             return false;
           }
         }
-      } else if (! oprop.read(&other).isNull()) {
+      } else if (nullptr != oitem) {
         // If the owned item is not writable (must be present) -> copy from other if set
-        if (! prop.read(this).value<ConfigItem*>()->copy(*oprop.read(&other).value<ConfigItem*>())) {
+        if (! prop.read(this).value<ConfigItem*>()->copy(*oitem)) {
           logError() << "Cannot copy fixed item '" << prop.name() << "' of "
                      << this->metaObject()->className() << ".";
           return false;
         }
       }
+    } break;
+
+    case PropertyKind::Other:
+      break;
     }
   }
 
@@ -236,67 +265,65 @@ ConfigItem::compare(const ConfigItem &other) const {
     return strcmp(metaObject()->className(), other.metaObject()->className());
 
   // Compare by properties
-  const QMetaObject *meta = metaObject();
-  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
-    // This property
-    QMetaProperty prop = meta->property(p);
-    // the same property over at other
-    QMetaProperty oprop = other.metaObject()->property(p);
-
-    // Should never happen
-    if (! prop.isValid())
-      continue;
-
-    // Handle comparison of basic types
-    if ((prop.isEnumType()) || (QVariant::Bool == prop.type()) || (QVariant::Int == prop.type()) || (QVariant::UInt == prop.type())) {
-      int a=prop.read(this).toInt(), b=oprop.read(&other).toInt();
+  foreach (const PropertyInfo &info, propertyPlan().properties) {
+    const QMetaProperty &prop = info.prop;
+    switch (info.kind) {
+    case PropertyKind::Enum:
+    case PropertyKind::Bool:
+    case PropertyKind::Int:
+    case PropertyKind::UInt: {
+      int a=prop.read(this).toInt(), b=prop.read(&other).toInt();
       if (a<b) return -1;
       if (a>b) return 1;
-      continue;
-    }
+    } break;
 
-    if (QVariant::Double == prop.type()) {
-      double a=prop.read(this).toDouble(), b=oprop.read(&other).toDouble();
+    case PropertyKind::Double: {
+      double a=prop.read(this).toDouble(), b=prop.read(&other).toDouble();
       if (a<b) return -1;
       if (a>b) return 1;
-      continue;
-    }
+    } break;
 
-    if (QVariant::String == prop.type()) {
-      int cmp = QString::compare(prop.read(this).toString(), oprop.read(&other).toString());
+    case PropertyKind::String: {
+      int cmp = QString::compare(prop.read(this).toString(), prop.read(&other).toString());
       if (cmp) return cmp;
-      continue;
-    }
+    } break;
 
-    if (ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>()) {
-      int cmp = ref->compare(*oprop.read(&other).value<ConfigObjectReference*>());
-      if (cmp) return cmp;
-      continue;
-    }
+    case PropertyKind::Reference:
+      if (ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>()) {
+        int cmp = ref->compare(*prop.read(&other).value<ConfigObjectReference*>());
+        if (cmp) return cmp;
+      }
+      break;
 
-    if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
-      int cmp = lst->compare(*oprop.read(&other).value<ConfigObjectList*>());
-      if (cmp) return cmp;
-      continue;
-    }
+    case PropertyKind::List:
+      if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
+        int cmp = lst->compare(*prop.read(&other).value<ConfigObjectList*>());
+        if (cmp) return cmp;
+      }
+      break;
 
-    if (ConfigObjectRefList *lst = prop.read(this).value<ConfigObjectRefList *>()) {
-      int cmp = lst->compare(*oprop.read(&other).value<ConfigObjectRefList*>());
-      if (cmp) return cmp;
-      continue;
-    }
+    case PropertyKind::RefList:
+      if (ConfigObjectRefList *lst = prop.read(this).value<ConfigObjectRefList *>()) {
+        int cmp = lst->compare(*prop.read(&other).value<ConfigObjectRefList*>());
+        if (cmp) return cmp;
+      }
+      break;
 
-    if (propIsInstance<ConfigItem>(prop)) {
-      // If the owned item is writeable -> clone if set in other
-      if (prop.read(&other).isNull() && !oprop.read(&other).isNull())
+    case PropertyKind::Item: {
+      ConfigItem *a = prop.read(this).value<ConfigItem*>(),
+          *b = prop.read(&other).value<ConfigItem*>();
+      if ((nullptr == a) && (nullptr != b))
         return -1;
-      if (!prop.read(&other).isNull() && oprop.read(&other).isNull())
+      if ((nullptr != a) && (nullptr == b))
         return 1;
-      if (prop.read(&other).isNull() && oprop.read(&other).isNull())
+      if ((nullptr == a) && (nullptr == b))
         continue;
-      int cmp = prop.read(&other).value<ConfigItem*>()->compare(*oprop.read(&other).value<ConfigItem*>());
+      int cmp = a->compare(*b);
       if (cmp) return cmp;
-      continue;
+    } break;
+
+    case PropertyKind::Other:
+      break;
     }
   }
 
@@ -307,19 +334,14 @@ ConfigItem::compare(const ConfigItem &other) const {
 bool
 ConfigItem::label(ConfigObject::Context &context, const ErrorStack &err) {
   // Label properties owning config objects, that is of type ConfigObject or ConfigObjectList
-  const QMetaObject *meta = metaObject();
-
-  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
-    QMetaProperty prop = meta->property(p);
-    if (! prop.isValid())
-      continue;
-    if (prop.read(this).value<ConfigObjectList *>()) {
-      ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>();
-      if (! lst->label(context, err))
+  foreach (const PropertyInfo &info, propertyPlan().properties) {
+    if (PropertyKind::List == info.kind) {
+      ConfigObjectList *lst = info.prop.read(this).value<ConfigObjectList *>();
+      if (lst && (! lst->label(context, err)))
         return false;
-    } else if (prop.read(this).value<ConfigItem *>()) {
-      ConfigItem *obj = prop.read(this).value<ConfigItem *>();
-      if (! obj->label(context, err))
+    } else if (PropertyKind::Item == info.kind) {
+      ConfigItem *obj = info.prop.read(this).value<ConfigItem *>();
+      if (obj && (! obj->label(context, err)))
         return false;
     }
   }
@@ -341,17 +363,15 @@ ConfigItem::clear() {
   emit beginClear();
 
   // Delete or clear all object owned by properties, that is ConfigObjectList and ConfigObject
-  const QMetaObject *meta = metaObject();
-  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
-    QMetaProperty prop = meta->property(p);
-    if (! prop.isValid())
-      continue;
-    if (propIsInstance<ConfigItem>(prop) && prop.isWritable()) {
+  foreach (const PropertyInfo &info, propertyPlan().properties) {
+    const QMetaProperty &prop = info.prop;
+    if ((PropertyKind::Item == info.kind) && prop.isWritable()) {
       if (ConfigItem *item = prop.read(this).value<ConfigItem*>())
         item->deleteLater();
       prop.write(this, QVariant::fromValue<ConfigItem*>(nullptr));
-    } else if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
-      lst->clear();
+    } else if (PropertyKind::List == info.kind) {
+      if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>())
+        lst->clear();
     }
   }
 
@@ -361,17 +381,16 @@ ConfigItem::clear() {
 bool
 ConfigItem::populate(YAML::Node &node, const Context &context, const ErrorStack &err){
   // Serialize all properties
-  const QMetaObject *meta = metaObject();
-  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
-    QMetaProperty prop = meta->property(p);
-    if (! prop.isValid())
-      continue;
+  foreach (const PropertyInfo &info, propertyPlan().properties) {
+    const QMetaProperty &prop = info.prop;
     if (! prop.isScriptable()) {
       /*logDebug() << "Do not serialize property '"
                  << prop.name() << "': Marked as not scriptable.";*/
       continue;
     }
-    if (prop.isEnumType()) {
+
+    switch (info.kind) {
+    case PropertyKind::Enum: {
       QMetaEnum e = prop.enumerator();
       QVariant value = prop.read(this);
       const char *key = e.valueToKey(value.toInt());
@@ -383,18 +402,27 @@ ConfigItem::populate(YAML::Node &node, const Context &context, const ErrorStack
         continue;
       }
       node[prop.name()] = key;
-    } else if (QString("bool") == prop.typeName()) {
-      node[prop.name()] = this->property(prop.name()).toBool();
-    } else if (QString("int") == prop.typeName()) {
-      node[prop.name()] = this->property(prop.name()).toInt();
-    } else if (QString("uint") == prop.typeName()) {
-      node[prop.name()] = this->property(prop.name()).toUInt();
-    } else if (QString("double") == prop.typeName()) {
-      node[prop.name()] = this->property(prop.name()).toDouble();
-    } else if (QString("QString") == prop.typeName()) {
-      node[prop.name()] = this->property(prop.name()).toString().toStdString();
-    } else if (ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>()) {
-      ConfigObject *obj = ref->as<ConfigObject>();
+    } break;
+
+    case PropertyKind::Bool:
+      node[prop.name()] = prop.read(this).toBool();
+      break;
+    case PropertyKind::Int:
+      node[prop.name()] = prop.read(this).toInt();
+      break;
+    case PropertyKind::UInt:
+      node[prop.name()] = prop.read(this).toUInt();
+      break;
+    case PropertyKind::Double:
+      node[prop.name()] = prop.read(this).toDouble();
+      break;
+    case PropertyKind::String:
+      node[prop.name()] = prop.read(this).toString().toStdString();
+      break;
+
+    case PropertyKind::Reference: {
+      ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>();
+      ConfigObject *obj = (nullptr != ref) ? ref->as<ConfigObject>() : nullptr;
       if (nullptr == obj)
         continue;
       if (context.hasTag(prop.enclosingMetaObject()->className(), prop.name(), obj)) {
@@ -408,7 +436,12 @@ ConfigItem::populate(YAML::Node &node, const Context &context, const ErrorStack
         return false;
       }
       node[prop.name()] = context.getId(obj).toStdString();
-    } else if (ConfigObjectRefList *refs = prop.read(this).value<ConfigObjectRefList *>()) {
+    } break;
+
+    case PropertyKind::RefList: {
+      ConfigObjectRefList *refs = prop.read(this).value<ConfigObjectRefList *>();
+      if (nullptr == refs)
+        continue;
       //logDebug() << "Serialize obj ref list w/ " << refs->count() << " elements." ;
       YAML::Node list = YAML::Node(YAML::NodeType::Sequence);
       list.SetStyle(YAML::EmitterStyle::Flow);
@@ -428,17 +461,25 @@ ConfigItem::populate(YAML::Node &node, const Context &context, const ErrorStack
         list.push_back(context.getId(obj).toStdString());
       }
       node[prop.name()] = list;
-    } else if (propIsInstance<ConfigItem>(prop)) {
+    } break;
+
+    case PropertyKind::Item: {
       ConfigItem *obj = prop.read(this).value<ConfigItem *>();
       // Serialize config objects in-place.
       if (obj)
         node[prop.name()] = obj->serialize(context);
-    } else if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
+    } break;
+
+    case PropertyKind::List:
       // Serialize config object lists in-place.
-      node[prop.name()] = lst->serialize(context);
-    } else {
+      if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>())
+        node[prop.name()] = lst->serialize(context);
+      break;
+
+    case PropertyKind::Other:
       logDebug() << "Unhandled property " << prop.name()
                  << " of unknown type " << prop.typeName() << ".";
+      break;
     }
   }
 
@@ -487,113 +528,109 @@ ConfigItem::parse(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorS
   }
 
   const QMetaObject *meta = this->metaObject();
-  for (int p=QObject::staticMetaObject.propertyOffset(); p<meta->propertyCount(); p++) {
-    QMetaProperty prop = meta->property(p);
-
-    if (! prop.isValid())
-      continue;
+  const PropertyPlan &plan = propertyPlan();
+  QVector<YAML::Node> values = propertyValues(node, plan);
+  for (int i=0; i<plan.properties.size(); i++) {
+    const PropertyInfo &info = plan.properties.at(i);
+    QMetaProperty prop = info.prop;
     // If marked as non-scriptable, skip that property.
     // It is handled separately or not at all.
     if (! prop.isScriptable())
       continue;
+    // References and reference lists are linked later
+    if ((PropertyKind::Reference == info.kind) || (PropertyKind::RefList == info.kind) ||
+        (PropertyKind::Other == info.kind))
+      continue;
 
     /// @todo With Qt 5.15, we can use the REQUIRED flag to check for mandatory properties.
     /// However, Ubuntu 20.04 (Focal) comes with Qt 5.12.
 
-    if (prop.isEnumType()) {
-      // If property is not set -> skip
-      if (! node[prop.name()])
-        continue;
+    // If property is not set -> skip
+    YAML::Node propNode = values.at(i);
+    if (! propNode)
+      continue;
+
+    switch (info.kind) {
+    case PropertyKind::Enum: {
       // parse & check enum key
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected enum key.";
         return false;
       }
       QMetaEnum e = prop.enumerator();
-      std::string key = node[prop.name()].as<std::string>();
+      std::string key = propNode.as<std::string>();
       bool ok=true; int value = e.keyToValue(key.c_str(), &ok);
       if (! ok) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Unknown key '" << key.c_str() << "' for enum '" << prop.name()
                     << "'. Expected one of " << enumKeys(e).join(", ") << ".";
         return false;
       }
       // finally set property
       prop.write(this, value);
-    } else if (QString("bool") == prop.typeName()) {
-      // If property is not set -> skip
-      if (! node[prop.name()])
-        continue;
+    } break;
+
+    case PropertyKind::Bool:
       // parse & check type
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected boolean value.";
         return false;
       }
-      prop.write(this, node[prop.name()].as<bool>());
-    } else if (QString("int") == prop.typeName()) {
-      // If property is not set -> skip
-      if (! node[prop.name()])
-        continue;
+      prop.write(this, propNode.as<bool>());
+      break;
+
+    case PropertyKind::Int:
       // parse & check type
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected integer value.";
         return false;
       }
-      prop.write(this, node[prop.name()].as<int>());
-    } else if (QString("uint") == prop.typeName()) {
-      // If property is not set -> skip
-      if (! node[prop.name()])
-        continue;
+      prop.write(this, propNode.as<int>());
+      break;
+
+    case PropertyKind::UInt:
       // parse & check type
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected unsigned integer value.";
         return false;
       }
-      prop.write(this, node[prop.name()].as<unsigned>());
-    } else if (QString("double") == prop.typeName()) {
-      // If property is not set -> skip
-      if (! node[prop.name()])
-        continue;
+      prop.write(this, propNode.as<unsigned>());
+      break;
+
+    case PropertyKind::Double:
       // parse & check type
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected floating point value.";
         return false;
       }
-      prop.write(this, node[prop.name()].as<double>());
-    } else if (QString("QString") == prop.typeName()) {
-      // If property is not set -> skip
-      if (! node[prop.name()])
-        continue;
+      prop.write(this, propNode.as<double>());
+      break;
+
+    case PropertyKind::String:
       // parse & check type
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected string.";
         return false;
       }
-      prop.write(this, QString::fromStdString(node[prop.name()].as<std::string>()));
-    } else if (prop.read(this).value<ConfigObjectReference *>()) {
-      // references are linked later
-      continue;
-    } else if (prop.read(this).value<ConfigObjectRefList *>()) {
-      // reference lists are linked later
-      continue;
-    } else if (propIsInstance<ConfigItem>(prop)) {
-      if (! node[prop.name()])
-        continue;
+      prop.write(this, QString::fromStdString(propNode.as<std::string>()));
+      break;
+
+    case PropertyKind::Item: {
       // check type
-      if (! node[prop.name()].IsMap()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsMap()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse '" << prop.name() << "' of '" << meta->className()
                     << "': Expected instance of '"
                     << QMetaType::metaObjectForType(prop.userType())->className() << "'.";
@@ -604,8 +641,8 @@ ConfigItem::parse(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorS
 
       // If not set and writable -> allocate and set
       if ((nullptr == obj) && prop.isWritable()) {
-        if (nullptr == (obj = this->allocateChild(prop, node[prop.name()], ctx))) {
-          errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+        if (nullptr == (obj = this->allocateChild(prop, propNode, ctx))) {
+          errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                       << ": Cannot allocate " << prop.name() << " of " << meta->className() << ".";
           return false;
         }
@@ -620,20 +657,19 @@ ConfigItem::parse(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorS
       }
 
       // parse instance
-      YAML::Node propNode = node[prop.name()];
       if (obj && (! obj->parse(propNode, ctx))) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className() << ".";
         if (nullptr == obj->parent())
           obj->deleteLater();
         return false;
       }
-    } else if (prop.read(this).value<ConfigObjectList *>()) {
-      if (! node[prop.name()])
-        continue;
+    } break;
+
+    case PropertyKind::List: {
       // check type
-      if (! node[prop.name()].IsSequence()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsSequence()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot parse " << prop.name() << " of " << meta->className()
                     << ": Expected instance of '"
                     << QMetaType::metaObjectForType(prop.userType())->className() << "'.";
@@ -643,8 +679,8 @@ ConfigItem::parse(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorS
       ConfigObjectList *lst = prop.read(this).value<ConfigObjectList*>();
       // If not set and writable -> allocate and set
       if ((nullptr == lst) && prop.isWritable()) {
-        if (nullptr == (lst = this->allocateChild(prop, node[prop.name()], ctx)->as<ConfigObjectList>())) {
-          errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+        if (nullptr == (lst = this->allocateChild(prop, propNode, ctx)->as<ConfigObjectList>())) {
+          errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                       << ": Cannot allocate list " << prop.name() << " of " << meta->className() << ".";
           return false;
         }
@@ -657,10 +693,12 @@ ConfigItem::parse(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorS
           return false;
         }
       }
+      if (nullptr == lst)
+        continue;
 
       // Allocate elements
       ConfigObject *obj = nullptr;
-      for (YAML::const_iterator it=node[prop.name()].begin(); it!=node[prop.name()].end(); it++) {
+      for (YAML::const_iterator it=propNode.begin(); it!=propNode.end(); it++) {
         // allocate element
         if (nullptr == (obj = lst->allocateChild(*it, ctx, err)->as<ConfigObject>())) {
           errMsg(err) << it->Mark().line << ":" << it->Mark().column
@@ -685,6 +723,12 @@ ConfigItem::parse(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorS
           return false;
         }
       }
+    } break;
+
+    case PropertyKind::Reference:
+    case PropertyKind::RefList:
+    case PropertyKind::Other:
+      break;
     }
   }
 
@@ -697,34 +741,35 @@ ConfigItem::link(const YAML::Node &node, const ConfigItem::Context &ctx, const E
 
   const QMetaObject *meta = this->metaObject();
 
-  for (int p=QObject::staticMetaObject.propertyOffset(); p<meta->propertyCount(); p++) {
-    QMetaProperty prop = meta->property(p);
-    if (! prop.isValid())
-      continue;
-
+  const PropertyPlan &plan = propertyPlan();
+  QVector<YAML::Node> values = propertyValues(node, plan);
+  for (int i=0; i<plan.properties.size(); i++) {
+    const PropertyInfo &info = plan.properties.at(i);
+    const QMetaProperty &prop = info.prop;
     if (! prop.isScriptable()) {
       //logDebug() << "Do not link property '" << prop.name() << "': Marked as not scriptable.";
       continue;
     }
-    if ((prop.isEnumType()) || (QString("bool") == prop.typeName()) || (QString("int") == prop.typeName()) ||
-        (QString("uint") == prop.typeName()) || (QString("double") == prop.typeName()) || (QString("QString") == prop.typeName()) ) {
-      continue;
-    } else if (ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>()) {
+    const YAML::Node &propNode = values.at(i);
+    if (PropertyKind::Reference == info.kind) {
+      ConfigObjectReference *ref = prop.read(this).value<ConfigObjectReference *>();
+      if (nullptr == ref)
+        continue;
       // If not set -> skip
-      if (! node[prop.name()])
+      if (! propNode)
         continue;
       // check type
-      if (! node[prop.name()].IsScalar()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsScalar()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className()
                     << ": Expected id.";
         return false;
       }
       // handle tags
-      QString tag = QString::fromStdString(node[prop.name()].Tag());
-      if ((!node[prop.name()].Scalar().size()) && (!tag.isEmpty())) {
+      QString tag = QString::fromStdString(propNode.Tag());
+      if ((!propNode.Scalar().size()) && (!tag.isEmpty())) {
         if (! ref->set(ctx.getTag(prop.enclosingMetaObject()->className(), prop.name(), tag))) {
-          errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+          errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                       << ": Cannot link " << prop.name() << " of " << meta->className()
                       << ": Unknown tag " << tag << ".";
           return false;
@@ -732,14 +777,14 @@ ConfigItem::link(const YAML::Node &node, const ConfigItem::Context &ctx, const E
         continue;
       }
       // set reference
-      QString id = QString::fromStdString(node[prop.name()].as<std::string>());
+      QString id = QString::fromStdString(propNode.as<std::string>());
       if (! ctx.contains(id)) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link reference to '" << id << "', element not defined.";
         return false;
       }
       if (! ref->set(ctx.getObj(id))) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className()
                     << ": Cannot set reference.";
         return false;
@@ -747,18 +792,21 @@ ConfigItem::link(const YAML::Node &node, const ConfigItem::Context &ctx, const E
       /*logDebug() << "Linked reference " << prop.name() << "='" << id
                  << "' to " << ctx.getObj(id)->metaObject()->className()
                  << " '" << ctx.getObj(id)->name() << "'.";*/
-    } else if (ConfigObjectRefList *lst = prop.read(this).value<ConfigObjectRefList *>()) {
+    } else if (PropertyKind::RefList == info.kind) {
+      ConfigObjectRefList *lst = prop.read(this).value<ConfigObjectRefList *>();
+      if (nullptr == lst)
+        continue;
       // If not set -> skip
-      if (! node[prop.name()])
+      if (! propNode)
         continue;
       // check type
-      if (! node[prop.name()].IsSequence()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsSequence()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className()
                     << ": Expected sequence.";
         return false;
       }
-      for (YAML::const_iterator it=node[prop.name()].begin(); it!=node[prop.name()].end(); it++) {
+      for (YAML::const_iterator it=propNode.begin(); it!=propNode.end(); it++) {
         if (! it->IsScalar()) {
           errMsg(err) << it->Mark().line << ":" << it->Mark().column
                       << ": Cannot link " << prop.name() << " of " << meta->className()
@@ -791,39 +839,45 @@ ConfigItem::link(const YAML::Node &node, const ConfigItem::Context &ctx, const E
         }
       }
 
-    } else if (ConfigItem *obj = prop.read(this).value<ConfigItem *>()) {
+    } else if (PropertyKind::Item == info.kind) {
+      ConfigItem *obj = prop.read(this).value<ConfigItem *>();
+      if (nullptr == obj)
+        continue;
       // If not set -> skip
-      if (! node[prop.name()])
+      if (! propNode)
         continue;
 
       // check type
-      if (! node[prop.name()].IsMap()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsMap()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className()
                     << ": Expected object.";
         return false;
       }
 
-      if (! obj->link(node[prop.name()], ctx, err)) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! obj->link(propNode, ctx, err)) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className() << ".";
         return false;
       }
-    } else if (ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>()) {
+    } else if (PropertyKind::List == info.kind) {
+      ConfigObjectList *lst = prop.read(this).value<ConfigObjectList *>();
+      if (nullptr == lst)
+        continue;
       // If not set -> skip
-      if (! node[prop.name()])
+      if (! propNode)
         continue;
 
       // check type
-      if (! node[prop.name()].IsSequence()) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! propNode.IsSequence()) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className()
                     << ": Expected sequence.";
         return false;
       }
 
-      if (! lst->link(node[prop.name()], ctx, err)) {
-        errMsg(err) << node[prop.name()].Mark().line << ":" << node[prop.name()].Mark().column
+      if (! lst->link(propNode, ctx, err)) {
+        errMsg(err) << propNode.Mark().line << ":" << propNode.Mark().column
                     << ": Cannot link " << prop.name() << " of " << meta->className() << ".";
         return false;
       }
@@ -932,6 +986,92 @@ ConfigItem::longDescription(const QMetaProperty &prop) const {
 }
 
 
+const ConfigItem::PropertyPlan &
+ConfigItem::propertyPlan() const {
+  // Plans are created once per class and never freed
+  static QHash<const QMetaObject *, PropertyPlan *> plans;
+  static QReadWriteLock lock;
+
+  const QMetaObject *meta = metaObject();
+  lock.lockForRead();
+  PropertyPlan *plan = plans.value(meta, nullptr);
+  lock.unlock();
+  if (plan)
+    return *plan;
+
+  QWriteLocker locker(&lock);
+  if ((plan = plans.value(meta, nullptr)))
+    return *plan;
+
+  plan = new PropertyPlan();
+  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
+    PropertyInfo info = { meta->property(p), PropertyKind::Other };
+    // Should never happen
+    if (! info.prop.isValid()) {
+      logWarn() << "Invalid property " << info.prop.name() << ". This should not happen.";
+      continue;
+    }
+
+    if (info.prop.isEnumType()) {
+      info.kind = PropertyKind::Enum;
+    } else if (QVariant::Bool == info.prop.type()) {
+      info.kind = PropertyKind::Bool;
+    } else if (QVariant::Int == info.prop.type()) {
+      info.kind = PropertyKind::Int;
+    } else if (QVariant::UInt == info.prop.type()) {
+      info.kind = PropertyKind::UInt;
+    } else if (QVariant::Double == info.prop.type()) {
+      info.kind = PropertyKind::Double;
+    } else if (QVariant::String == info.prop.type()) {
+      info.kind = PropertyKind::String;
+    } else if (propIsInstance<ConfigObjectReference>(info.prop)) {
+      info.kind = PropertyKind::Reference;
+    } else if (propIsInstance<ConfigObjectList>(info.prop)) {
+      info.kind = PropertyKind::List;
+    } else if (propIsInstance<ConfigObjectRefList>(info.prop)) {
+      info.kind = PropertyKind::RefList;
+    } else if (propIsInstance<ConfigItem>(info.prop)) {
+      info.kind = PropertyKind::Item;
+    } else {
+      // Type not registered with the meta-type system, check instance
+      QVariant value = info.prop.read(this);
+      if (value.value<ConfigObjectReference *>())
+        info.kind = PropertyKind::Reference;
+      else if (value.value<ConfigObjectList *>())
+        info.kind = PropertyKind::List;
+      else if (value.value<ConfigObjectRefList *>())
+        info.kind = PropertyKind::RefList;
+      else if (value.value<ConfigItem *>())
+        info.kind = PropertyKind::Item;
+    }
+
+    plan->index.insert(info.prop.name(), plan->properties.size());
+    plan->properties.append(info);
+  }
+
+  plans.insert(meta, plan);
+  return *plan;
+}
+
+QVector<YAML::Node>
+ConfigItem::propertyValues(const YAML::Node &node, const PropertyPlan &plan) {
+  QVector<YAML::Node> values(plan.properties.size(), YAML::Node(YAML::NodeType::Undefined));
+  if ((! node) || (! node.IsMap()))
+    return values;
+
+  for (YAML::const_iterator it=node.begin(); it!=node.end(); it++) {
+    if (! it->first.IsScalar())
+      continue;
+    int idx = plan.index.value(QByteArray::fromStdString(it->first.Scalar()), -1);
+    // Like node[key], the first matching entry is used
+    if ((0 <= idx) && (! values.at(idx)))
+      values[idx].reset(it->second);
+  }
+
+  return values;
+}
+
+
 /* ********************************************************************************************* *
  * Implementation of ConfigObject
  * ********************************************************************************************* */
@@ -967,12 +1107,7 @@ ConfigObject::idPrefix() const {
 
 bool
 ConfigObject::label(ConfigObject::Context &context, const ErrorStack &err) {
-  unsigned n=1;
-  QString prefix = this->idPrefix();
-  QString id=QString("%1%2").arg(prefix).arg(n);
-  while (context.contains(id)) {
-    id=QString("%1%2").arg(prefix).arg(++n);
-  }
+  QString id = context.nextId(this->idPrefix());
 
   if (! context.add(id, this)) {
     if (context.contains(this))
@@ -1039,13 +1174,15 @@ ConfigExtension::ConfigExtension(QObject *parent)
  * Implementation of AbstractConfigObjectList
  * ********************************************************************************************* */
 AbstractConfigObjectList::AbstractConfigObjectList(const QMetaObject &elementType, QObject *parent)
-  : QObject(parent), _elementTypes(), _items()
+  : QObject(parent), _elementTypes(), _items(), _index(), _indexValidFrom(0),
+    _updateDepth(0), _modifiedFirst(-1), _modifiedLast(-1), _reset(false)
 {
   _elementTypes.append(elementType);
 }
 
 AbstractConfigObjectList::AbstractConfigObjectList(const std::initializer_list<QMetaObject> &elementTypes, QObject *parent)
-  : QObject(parent), _elementTypes(elementTypes), _items()
+  : QObject(parent), _elementTypes(elementTypes), _items(), _index(), _indexValidFrom(0),
+    _updateDepth(0), _modifiedFirst(-1), _modifiedLast(-1), _reset(false)
 {
   // pass...
 }
@@ -1066,14 +1203,20 @@ AbstractConfigObjectList::count() const {
 
 int
 AbstractConfigObjectList::indexOf(ConfigObject *obj) const {
-  return _items.indexOf(obj);
+  QHash<const ConfigObject *, int>::const_iterator item = _index.constFind(obj);
+  if (_index.constEnd() == item)
+    return -1;
+  if (item.value() < _indexValidFrom)
+    return item.value();
+  reindex();
+  return _index.value(obj, -1);
 }
 
 void
 AbstractConfigObjectList::clear() {
   for (int i=(count()-1); i>=0; i--) {
-    _items.pop_back();
-    emit elementRemoved(i);
+    removeItem(i);
+    notifyRemoved(i);
   }
 }
 
@@ -1127,11 +1270,11 @@ int AbstractConfigObjectList::add(ConfigObject *obj, int row) {
                << " to list, expected instances of " << classNames().join(", ");
     return -1;
   }
-  _items.insert(row, obj);
+  insertItem(row, obj);
   // Otherwise connect to object
   connect(obj, SIGNAL(destroyed(QObject*)), this, SLOT(onElementDeleted(QObject*)));
   connect(obj, SIGNAL(modified(ConfigItem*)), this, SLOT(onElementModified(ConfigItem*)));
-  emit elementAdded(row);
+  notifyAdded(row);
   return row;
 }
 
@@ -1143,8 +1286,8 @@ AbstractConfigObjectList::take(ConfigObject *obj) {
   int idx = indexOf(obj);
   if (0 > idx)
     return false;
-  _items.remove(idx, 1);
-  emit elementRemoved(idx);
+  removeItem(idx);
+  notifyRemoved(idx);
   // Otherwise disconnect from
   disconnect(obj, nullptr, this, nullptr);
   return true;
@@ -1159,7 +1302,8 @@ bool
 AbstractConfigObjectList::moveUp(int row) {
   if ((row <= 0) || (row>=count()))
     return false;
-  std::swap(_items[row-1], _items[row]);
+  swapItems(row-1, row);
+  notifyMoved(row, row-1);
   return true;
 }
 
@@ -1167,8 +1311,10 @@ bool
 AbstractConfigObjectList::moveUp(int first, int last) {
   if ((first <= 0) || (last>=count()))
     return false;
-  for (int row=first; row<=last; row++)
-    std::swap(_items[row-1], _items[row]);
+  for (int row=first; row<=last; row++) {
+    swapItems(row-1, row);
+    notifyMoved(row, row-1);
+  }
   return true;
 }
 
@@ -1176,7 +1322,8 @@ bool
 AbstractConfigObjectList::moveDown(int row) {
   if ((row >= (count()-1)) || (0 > row))
     return false;
-  std::swap(_items[row+1], _items[row]);
+  swapItems(row+1, row);
+  notifyMoved(row, row+1);
   return true;
 }
 
@@ -1184,8 +1331,10 @@ bool
 AbstractConfigObjectList::moveDown(int first, int last) {
   if ((last >= (count()-1)) || (0 > first))
     return false;
-  for (int row=last; row>=first; row--)
-    std::swap(_items[row+1], _items[row]);
+  for (int row=last; row>=first; row--) {
+    swapItems(row+1, row);
+    notifyMoved(row, row+1);
+  }
   return true;
 }
 
@@ -1206,8 +1355,10 @@ AbstractConfigObjectList::classNames() const {
 void
 AbstractConfigObjectList::onElementModified(ConfigItem *obj) {
   int idx = indexOf(obj->as<ConfigObject>());
-  if (0 >= idx)
-    emit elementModified(idx);
+  if (0 > idx)
+    return;
+  updateItem(idx);
+  notifyModified(idx);
 }
 
 void
@@ -1216,9 +1367,120 @@ AbstractConfigObjectList::onElementDeleted(QObject *obj) {
   // We just use the pointer address to remove the element here.
   int idx = indexOf(reinterpret_cast<ConfigObject *>(obj));
   if (0 <= idx) {
-    _items.remove(idx);
+    removeItem(idx);
+    notifyRemoved(idx);
+  }
+}
+
+void
+AbstractConfigObjectList::beginUpdate() {
+  _updateDepth++;
+}
+
+void
+AbstractConfigObjectList::endUpdate() {
+  if ((0 == _updateDepth) || (0 != (--_updateDepth)))
+    return;
+
+  if (_reset)
+    emit elementsReset();
+  else if (0 <= _modifiedFirst)
+    emit elementsModified(_modifiedFirst, _modifiedLast);
+
+  _reset = false;
+  _modifiedFirst = _modifiedLast = -1;
+}
+
+bool
+AbstractConfigObjectList::isUpdating() const {
+  return 0 != _updateDepth;
+}
+
+void
+AbstractConfigObjectList::notifyAdded(int idx) {
+  if (_updateDepth)
+    _reset = true;
+  else
+    emit elementAdded(idx);
+}
+
+void
+AbstractConfigObjectList::notifyModified(int idx) {
+  if (0 == _updateDepth) {
+    emit elementModified(idx);
+    return;
+  }
+  _modifiedFirst = (0 > _modifiedFirst) ? idx : std::min(_modifiedFirst, idx);
+  _modifiedLast  = std::max(_modifiedLast, idx);
+}
+
+void
+AbstractConfigObjectList::notifyRemoved(int idx) {
+  if (_updateDepth)
+    _reset = true;
+  else
     emit elementRemoved(idx);
+}
+
+void
+AbstractConfigObjectList::notifyMoved(int from, int to) {
+  if (_updateDepth)
+    _reset = true;
+  else
+    emit elementMoved(from, to);
+}
+
+void
+AbstractConfigObjectList::insertItem(int row, ConfigObject *obj) {
+  _items.insert(row, obj);
+  _index.insert(obj, row);
+  // All positions from the inserted one on are shifted. The element previously at this row still
+  // holds it as its position, hence the index is only valid below.
+  if (_indexValidFrom > row)
+    _indexValidFrom = row;
+}
+
+void
+AbstractConfigObjectList::removeItem(int row) {
+  _index.remove(_items.at(row));
+  _items.remove(row);
+  // All positions after the removed one are shifted
+  if (_indexValidFrom > row)
+    _indexValidFrom = row;
+}
+
+void
+AbstractConfigObjectList::updateItem(int row) {
+  Q_UNUSED(row)
+  // pass...
+}
+
+void
+AbstractConfigObjectList::swapItems(int a, int b) {
+  std::swap(_items[a], _items[b]);
+  _index[_items.at(a)] = a;
+  _index[_items.at(b)] = b;
+}
+
+void
+AbstractConfigObjectList::reindex() const {
+  for (int i=_indexValidFrom; i<_items.size(); i++)
+    _index[_items.at(i)] = i;
+  _indexValidFrom = _items.size();
+}
+
+ConfigObject *
+AbstractConfigObjectList::first(const QList<ConfigObject *> &candidates) const {
+  ConfigObject *obj = nullptr;
+  int row = count();
+  foreach (ConfigObject *candidate, candidates) {
+    int idx = indexOf(candidate);
+    if ((0 <= idx) && (idx < row)) {
+      obj = candidate;
+      row = idx;
+    }
   }
+  return obj;
 }
 
 
@@ -69,6 +69,13 @@ public:
 
     /** Associates the given object with the given ID. */
     virtual bool add(const QString &id, ConfigObject *);
+    /** Removes the given object and its ID from the context. */
+    virtual void remove(ConfigObject *obj);
+
+    /** Returns the first unused ID of the form <tt>prefix + n</tt> for @c n>0.
+     * The search continues from the last ID returned for the same prefix. Hence, this yields an
+     * unused ID in amortized constant time and IDs of removed objects are not handed out again. */
+    QString nextId(const QString &prefix);
 
     /** Returns @c true if the property of the class has the specified tag associated. */
     static bool hasTag(const QString &className, const QString &property, const QString &tag);
@@ -88,6 +95,8 @@ public:
     QHash<QString, ConfigObject *> _objects;
     /** OBJ->ID look-up table. */
     QHash<ConfigObject*, QString> _ids;
+    /** Next ID number to probe for each ID prefix. */
+    QHash<QString, unsigned> _nextIds;
     /** Maps tags to singleton objects. */
     static QHash<QString, QHash<QString, ConfigObject *>> _tagObjects;
     /** Maps singleton objects to tags. */
@@ -182,6 +191,48 @@ protected:
    * The complete configuration must be labeled first. */
   virtual bool populate(YAML::Node &node, const Context &context, const ErrorStack &err=ErrorStack());
 
+  // Allow the snapshot format to store extensions and settings using the property plan.
+  friend class SnapshotEncoder;
+  friend class SnapshotDecoder;
+
+protected:
+  /** Possible kinds of properties handled by the generic (reflection based) methods. */
+  enum class PropertyKind {
+    Enum, Bool, Int, UInt, Double, String, ///< Basic types, copied by value.
+    Reference,                             ///< Instance of @c ConfigObjectReference.
+    List,                                  ///< Instance of @c ConfigObjectList.
+    RefList,                               ///< Instance of @c ConfigObjectRefList.
+    Item,                                  ///< Owned instance of @c ConfigItem.
+    Other                                  ///< Any other type, ignored.
+  };
+
+  /** Precomputed information about a single property. */
+  struct PropertyInfo {
+    /** The meta property. */
+    QMetaProperty prop;
+    /** The kind of the property. */
+    PropertyKind kind;
+  };
+
+  /** The properties of a class, starting after the properties of @c QObject. */
+  struct PropertyPlan {
+    /** The properties in declaration order. */
+    QVector<PropertyInfo> properties;
+    /** Maps property names to their position in @c properties. */
+    QHash<QByteArray, int> index;
+  };
+
+  /** Returns the property plan for the class of this item.
+   * The plan is created once per class on first use and cached. This avoids the repeated
+   * classification of properties by type name and the look-up of properties by name on every
+   * call of @c copy, @c compare, @c populate, @c parse, @c link and @c clear. */
+  const PropertyPlan &propertyPlan() const;
+
+  /** Collects the values of all properties of the plan from the given YAML map in a single pass
+   * over its entries. This replaces a linear search of the map for every property. Values of
+   * properties not present in the map are left undefined. */
+  static QVector<YAML::Node> propertyValues(const YAML::Node &node, const PropertyPlan &plan);
+
 signals:
   /** Gets emitted once the config object is modified.
    * The instance passed is the modified item, this event is passed up the config tree. */
@@ -311,6 +362,18 @@ public:
   /** Returns a list of all class names. */
   QStringList classNames() const;
 
+  /** Starts a batch update of the list.
+   *
+   * While a batch update is running, the @c elementAdded, @c elementModified, @c elementRemoved
+   * and @c elementMoved signals are suppressed. Once the (outermost) batch update ends, either
+   * @c elementsReset gets emitted if elements were added or removed, or @c elementsModified for the
+   * range of modified elements. Batch updates can be nested. */
+  void beginUpdate();
+  /** Ends a batch update and emits the coalesced change notification. */
+  void endUpdate();
+  /** Returns @c true if a batch update is running. */
+  bool isUpdating() const;
+
 signals:
   /** Gets emitted if an element was added to the list. */
   void elementAdded(int idx);
@@ -318,6 +381,13 @@ signals:
   void elementModified(int idx);
   /** Gets emitted if one of the lists elements gets deleted. */
   void elementRemoved(int idx);
+  /** Gets emitted if the element at index @c from was moved to the adjacent index @c to. */
+  void elementMoved(int from, int to);
+  /** Gets emitted at the end of a batch update, if elements within the given range were modified
+   * but none were added or removed. */
+  void elementsModified(int first, int last);
+  /** Gets emitted at the end of a batch update, if elements were added or removed. */
+  void elementsReset();
 
 private slots:
   /** Internal used callback to handle modified elements. */
@@ -325,11 +395,54 @@ private slots:
   /** Internal used callback to handle deleted elements. */
   void onElementDeleted(QObject *obj);
 
+protected:
+  /** Emits @c elementAdded or records the change if a batch update is running. */
+  void notifyAdded(int idx);
+  /** Emits @c elementModified or records the change if a batch update is running. */
+  void notifyModified(int idx);
+  /** Emits @c elementRemoved or records the change if a batch update is running. */
+  void notifyRemoved(int idx);
+  /** Emits @c elementMoved or records the change if a batch update is running. */
+  void notifyMoved(int from, int to);
+
+  /** Inserts the given object at the specified row into the list and updates the index.
+   * Lists maintaining secondary indices may override this method to update them too. */
+  virtual void insertItem(int row, ConfigObject *obj);
+  /** Removes the object at the given row from the list and updates the index. The object may
+   * already be destroyed, hence overriding methods must not dereference it. */
+  virtual void removeItem(int row);
+  /** Gets called if the object at the given row was modified. Lists maintaining secondary
+   * indices may override this method to update them. The default implementation does nothing.
+   * @since 0.11.3 */
+  virtual void updateItem(int row);
+  /** Swaps the objects at the given rows and updates the index. */
+  void swapItems(int a, int b);
+  /** Updates the stale part of the index. */
+  void reindex() const;
+  /** Returns the candidate with the lowest position within the list or @c nullptr if none of
+   * the candidates is an element of this list. Lists maintaining secondary indices use this to
+   * resolve ambiguous keys.
+   * @since 0.11.3 */
+  ConfigObject *first(const QList<ConfigObject *> &candidates) const;
+
 protected:
   /** Holds the static QMetaObject of the element type. */
   QList<QMetaObject> _elementTypes;
   /** Holds the list items. */
   QVector<ConfigObject *> _items;
+  /** Maps each list item to its position. Positions at or beyond @c _indexValidFrom may be stale
+   * and get updated lazily by @c reindex. */
+  mutable QHash<const ConfigObject *, int> _index;
+  /** All positions in @c _index below this row are valid. */
+  mutable int _indexValidFrom;
+  /** Nesting depth of batch updates. */
+  unsigned _updateDepth;
+  /** First modified element during the current batch update, -1 if none. */
+  int _modifiedFirst;
+  /** Last modified element during the current batch update, -1 if none. */
+  int _modifiedLast;
+  /** If @c true, elements were added or removed during the current batch update. */
+  bool _reset;
 };
 
 
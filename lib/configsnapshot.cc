@@ -0,0 +1,1454 @@
+#include "configsnapshot.hh"
+#include "config.hh"
+#include "configreference.hh"
+#include "radioid.hh"
+#include "contact.hh"
+#include "rxgrouplist.hh"
+#include "channel.hh"
+#include "zone.hh"
+#include "scanlist.hh"
+#include "gpssystem.hh"
+#include "roamingchannel.hh"
+#include "roamingzone.hh"
+#include "radiosettings.hh"
+#include "encryptionextension.hh"
+#include "commercial_extension.hh"
+#include "anytone_extension.hh"
+#include "opengd77_extension.hh"
+#include "tyt_extensions.hh"
+#include "logger.hh"
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QPair>
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+#include <algorithm>
+
+#define SNAPSHOT_MAGIC      "QDMRSNAP"
+#define SNAPSHOT_MAGIC_SIZE 8
+
+// Kinds of properties in generic item records
+#define FIELD_NONE      0x00
+#define FIELD_ENUM      0x01
+#define FIELD_BOOL      0x02
+#define FIELD_INT       0x03
+#define FIELD_UINT      0x04
+#define FIELD_DOUBLE    0x05
+#define FIELD_STRING    0x06
+#define FIELD_REFERENCE 0x07
+#define FIELD_REFLIST   0x08
+#define FIELD_LIST      0x09
+#define FIELD_ITEM      0x0a
+
+// Object IDs of the singletons, that are not part of the codeplug
+#define ID_NONE                 0x00000000
+#define ID_SELECTED_CHANNEL     0xffffffff
+#define ID_DEFAULT_RADIO_ID     0xfffffffe
+#define ID_DEFAULT_ROAMING_ZONE 0xfffffffd
+
+typedef ConfigSnapshot::Record Record;
+
+
+/** Encodes a codeplug into the snapshot sections.
+ * @ingroup conf */
+class SnapshotEncoder
+{
+public:
+  /** Constructor. */
+  SnapshotEncoder()
+    : _strings(), _stringIndex(), _types(), _typeIndex(), _fields(), _objects(), _ids(), _fixups()
+  {
+    // pass...
+  }
+
+  /** Encodes the given codeplug. */
+  bool encode(Config *config, const ErrorStack &err) {
+    if (! writeConfig(config, err))
+      return false;
+
+    // Resolve forward references
+    foreach (const Fixup &fixup, _fixups) {
+      if (! _ids.contains(fixup.second)) {
+        errMsg(err) << "Cannot store reference to " << fixup.second->metaObject()->className()
+                    << " '" << fixup.second->name() << "': Not part of the codeplug.";
+        return false;
+      }
+      qToLittleEndian<quint32>(_ids.value(fixup.second), (uchar *)_objects.data()+fixup.first);
+    }
+
+    return true;
+  }
+
+  /** Assembles the snapshot. */
+  QByteArray data() const {
+    QByteArray strings;
+    appendUInt32(strings, _strings.size());
+    foreach (const QByteArray &str, _strings) {
+      appendUInt32(strings, str.size());
+      strings.append(str);
+    }
+
+    QByteArray types;
+    appendUInt32(types, _typeIndex.size());
+    types.append(_types);
+
+    QByteArray data(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    appendUInt32(data, ConfigSnapshot::Version);
+    appendUInt32(data, 3);
+    appendSection(data, ConfigSnapshot::Section::Strings, strings);
+    appendSection(data, ConfigSnapshot::Section::Types, types);
+    appendSection(data, ConfigSnapshot::Section::Objects, _objects);
+    return data;
+  }
+
+  /** Maps the given property of the given item to the field kind stored in property blocks.
+   * Returns @c FIELD_NONE for properties, that are not stored in the property block. For codeplug
+   * elements, these are the properties already stored in the typed record. For all other items
+   * (extensions and settings), these are the non-scriptable properties. */
+  static uint8_t fieldKind(const ConfigItem *item, const ConfigItem::PropertyInfo &info) {
+    if (const ConfigObject *obj = item->as<ConfigObject>()) {
+      if (recordFields(recordType(obj)).contains(info.prop.name()))
+        return FIELD_NONE;
+    } else if (! info.prop.isScriptable()) {
+      // Non-scriptable properties of items are handled separately or not at all.
+      return FIELD_NONE;
+    }
+    switch (info.kind) {
+    case ConfigItem::PropertyKind::Enum: return info.prop.isWritable() ? FIELD_ENUM : FIELD_NONE;
+    case ConfigItem::PropertyKind::Bool: return info.prop.isWritable() ? FIELD_BOOL : FIELD_NONE;
+    case ConfigItem::PropertyKind::Int: return info.prop.isWritable() ? FIELD_INT : FIELD_NONE;
+    case ConfigItem::PropertyKind::UInt: return info.prop.isWritable() ? FIELD_UINT : FIELD_NONE;
+    case ConfigItem::PropertyKind::Double: return info.prop.isWritable() ? FIELD_DOUBLE : FIELD_NONE;
+    case ConfigItem::PropertyKind::String: return info.prop.isWritable() ? FIELD_STRING : FIELD_NONE;
+    case ConfigItem::PropertyKind::Reference: return FIELD_REFERENCE;
+    case ConfigItem::PropertyKind::RefList: return FIELD_REFLIST;
+    case ConfigItem::PropertyKind::List: return FIELD_LIST;
+    case ConfigItem::PropertyKind::Item: return FIELD_ITEM;
+    case ConfigItem::PropertyKind::Other: break;
+    }
+    return FIELD_NONE;
+  }
+
+  /** Returns the record type for the given element. */
+  static Record recordType(const ConfigObject *obj) {
+    if (obj->is<DMRRadioID>()) return Record::DMRRadioID;
+    if (obj->is<DTMFRadioID>()) return Record::DTMFRadioID;
+    if (obj->is<DMRContact>()) return Record::DMRContact;
+    if (obj->is<DTMFContact>()) return Record::DTMFContact;
+    if (obj->is<RXGroupList>()) return Record::GroupList;
+    if (obj->is<DMRChannel>()) return Record::DMRChannel;
+    if (obj->is<FMChannel>()) return Record::FMChannel;
+    if (obj->is<Zone>()) return Record::Zone;
+    if (obj->is<ScanList>()) return Record::ScanList;
+    if (obj->is<GPSSystem>()) return Record::GPSSystem;
+    if (obj->is<APRSSystem>()) return Record::APRSSystem;
+    if (obj->is<RoamingChannel>()) return Record::RoamingChannel;
+    if (obj->is<RoamingZone>()) return Record::RoamingZone;
+    if (obj->is<DMREncryptionKey>()) return Record::DMREncryptionKey;
+    if (obj->is<AESEncryptionKey>()) return Record::AESEncryptionKey;
+    return Record::Null;
+  }
+
+  /** Returns the names of the properties stored in the typed record of the given type. All other
+   * properties of the element are stored in the property block following the typed fields. */
+  static const QSet<QByteArray> &recordFields(Record type) {
+    static const QSet<QByteArray> channel = {
+      "name", "rxFrequency", "txFrequency", "power", "timeout", "rxOnly", "scanListRef", "vox",
+      "openGD77", "tyt" };
+    static const QHash<int, QSet<QByteArray>> fields = {
+      { int(Record::DMRRadioID), { "name", "number" } },
+      { int(Record::DTMFRadioID), { "name", "number" } },
+      { int(Record::DMRContact), { "name", "ring", "type", "number", "anytone", "openGD77" } },
+      { int(Record::DTMFContact), { "name", "ring", "number" } },
+      { int(Record::GroupList), { "name", "contacts" } },
+      { int(Record::DMRChannel), channel + QSet<QByteArray>{
+          "admit", "colorCode", "timeSlot", "radioId", "groupList", "contact", "aprs", "roaming",
+          "commercial", "anytone" } },
+      { int(Record::FMChannel), channel + QSet<QByteArray>{
+          "admit", "squelch", "bandwidth", "aprs", "anytone" } },
+      { int(Record::Zone), { "name", "A", "B", "anytone" } },
+      { int(Record::ScanList), { "name", "primary", "secondary", "revert", "channels", "tyt" } },
+      { int(Record::GPSSystem), { "name", "period", "contact", "revert" } },
+      { int(Record::APRSSystem), { "name", "period", "revert", "icon", "message" } },
+      { int(Record::RoamingChannel), {
+          "name", "rxFrequency", "txFrequency", "overrideColorCode", "colorCode",
+          "overrideTimeSlot", "timeSlot" } },
+      { int(Record::RoamingZone), { "name", "channels" } },
+      { int(Record::DMREncryptionKey), { "name", "key" } },
+      { int(Record::AESEncryptionKey), { "name", "key" } }
+    };
+    static const QSet<QByteArray> none;
+
+    auto it = fields.find(int(type));
+    if (fields.end() == it)
+      return none;
+    return *it;
+  }
+
+protected:
+  /** Writes the config record. */
+  bool writeConfig(Config *config, const ErrorStack &err) {
+    int record = beginRecord(Record::Config);
+
+    if (! writeList(config->radioIDs(), err))
+      return false;
+    if (config->radioIDs()->defaultId())
+      writeInt32(config->radioIDs()->indexOf(config->radioIDs()->defaultId()));
+    else
+      writeInt32(-1);
+
+    if ((! writeList(config->contacts(), err)) || (! writeList(config->rxGroupLists(), err)) ||
+        (! writeList(config->channelList(), err)) || (! writeList(config->zones(), err)) ||
+        (! writeList(config->scanlists(), err)) || (! writeList(config->posSystems(), err)) ||
+        (! writeList(config->roamingChannels(), err)) || (! writeList(config->roamingZones(), err)))
+      return false;
+
+    if ((! writeItem(config->settings(), err)) ||
+        (! writeItem(config->commercialExtension(), err)) ||
+        (! writeItem(config->tytExtension(), err)))
+      return false;
+
+    endRecord(record);
+    return true;
+  }
+
+  /** Writes the number of elements and the records of all elements of the given list. */
+  bool writeList(AbstractConfigObjectList *list, const ErrorStack &err) {
+    if (nullptr == list) {
+      writeUInt32(0);
+      return true;
+    }
+    writeUInt32(list->count());
+    for (int i=0; i<list->count(); i++) {
+      if (! writeObject(list->get(i), err))
+        return false;
+    }
+    return true;
+  }
+
+  /** Writes the record of the given codeplug element. */
+  bool writeObject(ConfigObject *obj, const ErrorStack &err) {
+    Record type = recordType(obj);
+    if (Record::Null == type) {
+      errMsg(err) << "Cannot store " << obj->metaObject()->className() << " '" << obj->name()
+                  << "' in snapshot: Unknown element type.";
+      return false;
+    }
+
+    uint32_t id = _ids.size()+1;
+    _ids.insert(obj, id);
+
+    int record = beginRecord(type);
+    writeUInt32(id);
+    writeString(obj->name());
+
+    bool ok = true;
+    switch (type) {
+    case Record::DMRRadioID:
+      writeUInt32(obj->as<DMRRadioID>()->number());
+      break;
+    case Record::DTMFRadioID:
+      writeString(obj->as<DTMFRadioID>()->number());
+      break;
+    case Record::DMRContact:
+      ok = writeDMRContact(obj->as<DMRContact>(), err);
+      break;
+    case Record::DTMFContact:
+      writeUInt8(obj->as<DTMFContact>()->ring());
+      writeString(obj->as<DTMFContact>()->number());
+      break;
+    case Record::GroupList:
+      writeRefList(obj->as<RXGroupList>()->contacts());
+      break;
+    case Record::DMRChannel:
+      ok = writeDMRChannel(obj->as<DMRChannel>(), err);
+      break;
+    case Record::FMChannel:
+      ok = writeFMChannel(obj->as<FMChannel>(), err);
+      break;
+    case Record::Zone:
+      writeRefList(obj->as<Zone>()->A());
+      writeRefList(obj->as<Zone>()->B());
+      ok = writeItem(obj->as<Zone>()->anytoneExtension(), err);
+      break;
+    case Record::ScanList:
+      writeReference(obj->as<ScanList>()->primary());
+      writeReference(obj->as<ScanList>()->secondary());
+      writeReference(obj->as<ScanList>()->revert());
+      writeRefList(obj->as<ScanList>()->channels());
+      ok = writeItem(obj->as<ScanList>()->tytScanListExtension(), err);
+      break;
+    case Record::GPSSystem:
+      writeUInt32(obj->as<GPSSystem>()->period());
+      writeReference(obj->as<GPSSystem>()->contact());
+      writeReference(obj->as<GPSSystem>()->revert());
+      break;
+    case Record::APRSSystem:
+      writeAPRSSystem(obj->as<APRSSystem>());
+      break;
+    case Record::RoamingChannel:
+      writeRoamingChannel(obj->as<RoamingChannel>());
+      break;
+    case Record::RoamingZone:
+      writeRefList(obj->as<RoamingZone>()->channels());
+      break;
+    case Record::DMREncryptionKey:
+    case Record::AESEncryptionKey:
+      writeString(obj->as<EncryptionKey>()->toHex());
+      break;
+    default:
+      break;
+    }
+    // Store any other property of the element
+    if ((! ok) || (! writeProperties(obj, err)))
+      return false;
+
+    endRecord(record);
+    return true;
+  }
+
+  /** Writes the fields of a DMR contact. */
+  bool writeDMRContact(DMRContact *contact, const ErrorStack &err) {
+    writeUInt8(contact->ring());
+    writeUInt8(contact->type());
+    writeUInt32(contact->number());
+    return writeItem(contact->anytoneExtension(), err) &&
+        writeItem(contact->openGD77ContactExtension(), err);
+  }
+
+  /** Writes the fields common to all channels. */
+  bool writeChannel(Channel *channel, const ErrorStack &err) {
+    writeInt64(channel->rxFreq().inHz());
+    writeInt64(channel->txFreq().inHz());
+    writeUInt8(channel->defaultPower());
+    writeUInt8(uint8_t(channel->power()));
+    writeUInt32(channel->timeout());
+    writeUInt8(channel->rxOnly());
+    writeUInt32(channel->vox());
+    writeReference(channel->scanListRef());
+    return writeItem(channel->openGD77ChannelExtension(), err) &&
+        writeItem(channel->tytChannelExtension(), err);
+  }
+
+  /** Writes the fields of a DMR channel. */
+  bool writeDMRChannel(DMRChannel *channel, const ErrorStack &err) {
+    if (! writeChannel(channel, err))
+      return false;
+    writeUInt8(uint8_t(channel->admit()));
+    writeUInt8(channel->colorCode());
+    writeUInt8(uint8_t(channel->timeSlot()));
+    writeReference(channel->radioId());
+    writeReference(channel->groupList());
+    writeReference(channel->contact());
+    writeReference(channel->aprs());
+    writeReference(channel->roaming());
+    return writeItem(channel->commercialExtension(), err) &&
+        writeItem(channel->anytoneChannelExtension(), err);
+  }
+
+  /** Writes the fields of an FM channel. */
+  bool writeFMChannel(FMChannel *channel, const ErrorStack &err) {
+    if (! writeChannel(channel, err))
+      return false;
+    writeUInt8(uint8_t(channel->admit()));
+    writeUInt32(channel->squelch());
+    writeUInt32(channel->rxTone());
+    writeUInt32(channel->txTone());
+    writeUInt8(uint8_t(channel->bandwidth()));
+    writeReference(channel->aprs());
+    return writeItem(channel->anytoneChannelExtension(), err);
+  }
+
+  /** Writes the fields of an APRS system. */
+  void writeAPRSSystem(APRSSystem *sys) {
+    writeUInt32(sys->period());
+    writeReference(sys->revert());
+    writeUInt32(uint32_t(sys->icon()));
+    writeString(sys->message());
+    writeString(sys->destination());
+    writeUInt8(sys->destSSID());
+    writeString(sys->source());
+    writeUInt8(sys->srcSSID());
+    writeString(sys->path());
+  }
+
+  /** Writes the fields of a roaming channel. */
+  void writeRoamingChannel(RoamingChannel *channel) {
+    writeInt64(channel->rxFreq().inHz());
+    writeInt64(channel->txFreq().inHz());
+    writeUInt8(channel->colorCodeOverridden());
+    writeUInt8(channel->colorCode());
+    writeUInt8(channel->timeSlotOverridden());
+    writeUInt8(uint8_t(channel->timeSlot()));
+  }
+
+  /** Writes a generic item record. A @c nullptr is written as a null record. */
+  bool writeItem(ConfigItem *item, const ErrorStack &err) {
+    if (nullptr == item) {
+      endRecord(beginRecord(Record::Null));
+      return true;
+    }
+
+    int record = beginRecord(Record::Item);
+    if (! writeProperties(item, err))
+      return false;
+    endRecord(record);
+
+    return true;
+  }
+
+  /** Writes the property block of the given item. That is, the type followed by the values of all
+   * properties described by the type. */
+  bool writeProperties(ConfigItem *item, const ErrorStack &err) {
+    uint32_t idx = type(item);
+    writeUInt32(idx);
+    const ConfigItem::PropertyPlan &plan = item->propertyPlan();
+    foreach (const Field &field, _fields.at(idx)) {
+      QVariant value = plan.properties.at(field.first).prop.read(item);
+      switch (field.second) {
+      case FIELD_ENUM:
+      case FIELD_INT: writeInt32(value.toInt()); break;
+      case FIELD_BOOL: writeUInt8(value.toBool()); break;
+      case FIELD_UINT: writeUInt32(value.toUInt()); break;
+      case FIELD_DOUBLE: writeDouble(value.toDouble()); break;
+      case FIELD_STRING: writeString(value.toString()); break;
+      case FIELD_REFERENCE: writeReference(value.value<ConfigObjectReference *>()); break;
+      case FIELD_REFLIST: writeRefList(value.value<ConfigObjectRefList *>()); break;
+      case FIELD_LIST:
+        if (! writeList(value.value<ConfigObjectList *>(), err))
+          return false;
+        break;
+      case FIELD_ITEM:
+        if (! writeItem(value.value<ConfigItem *>(), err))
+          return false;
+        break;
+      default:
+        break;
+      }
+    }
+    return true;
+  }
+
+  /** Returns the index of the type of the given item, adds the type to the type table if needed. */
+  uint32_t type(const ConfigItem *item) {
+    const QMetaObject *meta = item->metaObject();
+    if (_typeIndex.contains(meta))
+      return _typeIndex.value(meta);
+
+    uint32_t idx = _typeIndex.size();
+    _typeIndex.insert(meta, idx);
+
+    // Select the stored properties once per type
+    const ConfigItem::PropertyPlan &plan = item->propertyPlan();
+    QVector<Field> fields;
+    for (int i=0; i<plan.properties.size(); i++) {
+      uint8_t kind = fieldKind(item, plan.properties.at(i));
+      if (FIELD_NONE != kind)
+        fields.append(Field(i, kind));
+    }
+    _fields.append(fields);
+
+    appendUInt32(_types, string(meta->className()));
+    appendUInt32(_types, fields.size());
+    foreach (const Field &field, fields) {
+      appendUInt32(_types, string(plan.properties.at(field.first).prop.name()));
+      _types.append(char(field.second));
+    }
+
+    return idx;
+  }
+
+  /** Starts a record of the given type. Returns the offset of the length field. */
+  int beginRecord(Record type) {
+    _objects.append(char(type));
+    int offset = _objects.size();
+    writeUInt32(0);
+    return offset;
+  }
+
+  /** Completes the record by updating its length field. */
+  void endRecord(int offset) {
+    qToLittleEndian<quint32>(_objects.size()-offset-sizeof(uint32_t),
+                             (uchar *)_objects.data()+offset);
+  }
+
+  /** Writes the ID of the referenced object. */
+  void writeReference(const ConfigObjectReference *ref) {
+    writeId(ref ? ref->as<ConfigObject>() : nullptr);
+  }
+
+  /** Writes the number of referenced objects followed by their IDs. */
+  void writeRefList(const ConfigObjectRefList *list) {
+    if (nullptr == list) {
+      writeUInt32(0);
+      return;
+    }
+    writeUInt32(list->count());
+    for (int i=0; i<list->count(); i++)
+      writeId(list->get(i));
+  }
+
+  /** Writes the ID of the given object. */
+  void writeId(ConfigObject *obj) {
+    if (nullptr == obj) {
+      writeUInt32(ID_NONE);
+    } else if (obj->is<SelectedChannel>()) {
+      writeUInt32(ID_SELECTED_CHANNEL);
+    } else if (obj->is<DefaultRadioID>()) {
+      writeUInt32(ID_DEFAULT_RADIO_ID);
+    } else if (obj->is<DefaultRoamingZone>()) {
+      writeUInt32(ID_DEFAULT_ROAMING_ZONE);
+    } else if (_ids.contains(obj)) {
+      writeUInt32(_ids.value(obj));
+    } else {
+      // Forward reference, resolved once all objects are written
+      _fixups.append(Fixup(_objects.size(), obj));
+      writeUInt32(ID_NONE);
+    }
+  }
+
+  /** Returns the index of the given string, adds the string to the table if needed. */
+  uint32_t string(const QString &str) {
+    QByteArray key = str.toUtf8();
+    uint32_t idx = _stringIndex.value(key, _strings.size());
+    if (uint32_t(_strings.size()) == idx) {
+      _stringIndex.insert(key, idx);
+      _strings.append(key);
+    }
+    return idx;
+  }
+
+  /** Writes the index of the given string. */
+  void writeString(const QString &str) {
+    writeUInt32(string(str));
+  }
+
+  /** Writes an unsigned byte. */
+  void writeUInt8(uint8_t value) {
+    _objects.append(char(value));
+  }
+
+  /** Writes an unsigned integer. */
+  void writeUInt32(uint32_t value) {
+    appendUInt32(_objects, value);
+  }
+
+  /** Writes a signed integer. */
+  void writeInt32(int32_t value) {
+    appendUInt32(_objects, uint32_t(value));
+  }
+
+  /** Writes a signed 64bit integer. */
+  void writeInt64(qint64 value) {
+    quint64 le = qToLittleEndian(quint64(value));
+    _objects.append((const char *)&le, sizeof(quint64));
+  }
+
+  /** Writes a double precision floating point value. */
+  void writeDouble(double value) {
+    quint64 bits = 0;
+    memcpy(&bits, &value, sizeof(double));
+    writeInt64(qint64(bits));
+  }
+
+  /** Appends an unsigned integer in little endian to the given buffer. */
+  static void appendUInt32(QByteArray &buffer, uint32_t value) {
+    value = qToLittleEndian(value);
+    buffer.append((const char *)&value, sizeof(uint32_t));
+  }
+
+  /** Appends a section to the given buffer. */
+  static void appendSection(QByteArray &buffer, ConfigSnapshot::Section type, const QByteArray &content) {
+    appendUInt32(buffer, uint32_t(type));
+    appendUInt32(buffer, content.size());
+    buffer.append(content);
+  }
+
+protected:
+  /** A reference to an object not written yet, the offset of the ID and the referenced object. */
+  typedef QPair<int, ConfigObject *> Fixup;
+  /** A stored property, the index within the property plan and the field kind. */
+  typedef QPair<int, uint8_t> Field;
+
+  /** The string table. */
+  QVector<QByteArray> _strings;
+  /** Maps strings to their index in the table. */
+  QHash<QByteArray, uint32_t> _stringIndex;
+  /** The type table, without the number of types. */
+  QByteArray _types;
+  /** Maps classes to their index in the type table. */
+  QHash<const QMetaObject *, uint32_t> _typeIndex;
+  /** The stored properties for each type. */
+  QVector<QVector<Field>> _fields;
+  /** The encoded records. */
+  QByteArray _objects;
+  /** Maps the written objects to their IDs. */
+  QHash<ConfigObject *, uint32_t> _ids;
+  /** Forward references to be resolved. */
+  QVector<Fixup> _fixups;
+};
+
+
+/** Decodes a codeplug from the snapshot sections.
+ * @ingroup conf */
+class SnapshotDecoder
+{
+public:
+  /** Constructor. */
+  SnapshotDecoder(const char *data, qint64 size)
+    : _data(data), _end(data+size), _strings(), _types(), _objects(), _references(), _refLists(),
+      _context()
+  {
+    // pass...
+  }
+
+  /** Decodes the complete snapshot into the given config. */
+  bool decode(Config *config, const ErrorStack &err) {
+    if (((_end-_data) < SNAPSHOT_MAGIC_SIZE) || memcmp(_data, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE)) {
+      errMsg(err) << "Not a codeplug snapshot.";
+      return false;
+    }
+    _data += SNAPSHOT_MAGIC_SIZE;
+
+    uint32_t version = 0, sections = 0;
+    if ((! readUInt32(version)) || (! readUInt32(sections))) {
+      errMsg(err) << "Truncated snapshot header.";
+      return false;
+    }
+    if (ConfigSnapshot::Version != version) {
+      errMsg(err) << "Unsupported snapshot version " << version << ".";
+      return false;
+    }
+
+    bool hasConfig = false;
+    for (uint32_t i=0; i<sections; i++) {
+      uint32_t type = 0, length = 0;
+      if ((! readUInt32(type)) || (! readUInt32(length)) || (uint32_t(_end-_data) < length)) {
+        errMsg(err) << "Truncated snapshot section " << i << ".";
+        return false;
+      }
+
+      const char *end = _end;
+      _end = _data + length;
+      if (uint32_t(ConfigSnapshot::Section::Strings) == type) {
+        if (! readStrings(err))
+          return false;
+      } else if (uint32_t(ConfigSnapshot::Section::Types) == type) {
+        if (! readTypes(err))
+          return false;
+      } else if (uint32_t(ConfigSnapshot::Section::Objects) == type) {
+        if (! readConfig(config, err))
+          return false;
+        hasConfig = true;
+      } else {
+        logDebug() << "Skip unknown snapshot section " << type << ".";
+      }
+      _data = _end;
+      _end = end;
+    }
+
+    if (! hasConfig) {
+      errMsg(err) << "Snapshot contains no codeplug.";
+      return false;
+    }
+
+    return link(err);
+  }
+
+protected:
+  /** Reads the string table. */
+  bool readStrings(const ErrorStack &err) {
+    uint32_t count = 0;
+    if (! readUInt32(count)) {
+      errMsg(err) << "Truncated string table.";
+      return false;
+    }
+    _strings.clear();
+    _strings.reserve(std::min(count, uint32_t(_end-_data)/4));
+    for (uint32_t i=0; i<count; i++) {
+      uint32_t length = 0;
+      if ((! readUInt32(length)) || (uint32_t(_end-_data) < length)) {
+        errMsg(err) << "Truncated string " << i << " in string table.";
+        return false;
+      }
+      _strings.append(QString::fromUtf8(_data, length));
+      _data += length;
+    }
+    return true;
+  }
+
+  /** Reads the type table. */
+  bool readTypes(const ErrorStack &err) {
+    uint32_t count = 0;
+    if (! readUInt32(count)) {
+      errMsg(err) << "Truncated type table.";
+      return false;
+    }
+    _types.clear();
+    _types.reserve(std::min(count, uint32_t(_end-_data)/8));
+    for (uint32_t i=0; i<count; i++) {
+      Type type;
+      uint32_t fields = 0;
+      if ((! readString(type.className)) || (! readUInt32(fields))) {
+        errMsg(err) << "Truncated type " << i << " in type table.";
+        return false;
+      }
+      for (uint32_t j=0; j<fields; j++) {
+        QString name; uint8_t kind = 0;
+        if ((! readString(name)) || (! readUInt8(kind))) {
+          errMsg(err) << "Truncated type " << type.className << " in type table.";
+          return false;
+        }
+        if ((FIELD_NONE == kind) || (FIELD_ITEM < kind)) {
+          errMsg(err) << "Unknown kind " << kind << " of field '" << name << "' of type "
+                      << type.className << " in type table.";
+          return false;
+        }
+        type.names.append(name);
+        type.kinds.append(kind);
+      }
+      _types.append(type);
+    }
+    return true;
+  }
+
+  /** Reads the config record. */
+  bool readConfig(Config *config, const ErrorStack &err) {
+    uint8_t type = 0; const char *end = nullptr;
+    if (! enterRecord(type, end, err))
+      return false;
+    if (uint8_t(Record::Config) != type) {
+      errMsg(err) << "Expected config record, got record type " << type << ".";
+      return false;
+    }
+
+    int32_t defaultId = -1;
+    if ((! readList(config->radioIDs(), err)) || (! readInt32(defaultId))) {
+      errMsg(err) << "Cannot read radio IDs from snapshot.";
+      return false;
+    }
+
+    if ((! readList(config->contacts(), err)) || (! readList(config->rxGroupLists(), err)) ||
+        (! readList(config->channelList(), err)) || (! readList(config->zones(), err)) ||
+        (! readList(config->scanlists(), err)) || (! readList(config->posSystems(), err)) ||
+        (! readList(config->roamingChannels(), err)) || (! readList(config->roamingZones(), err))) {
+      errMsg(err) << "Cannot read codeplug from snapshot.";
+      return false;
+    }
+
+    TyTConfigExtension *tyt = nullptr;
+    if ((! readItemRecord(config->settings(), err)) ||
+        (! readItemRecord(config->commercialExtension(), err)) ||
+        (! readExtension(tyt, err))) {
+      errMsg(err) << "Cannot read settings from snapshot.";
+      return false;
+    }
+    if (tyt)
+      config->setTyTExtension(tyt);
+
+    // Like for YAML codeplugs, the first ID is the default one if not set explicitly
+    if (0 <= defaultId) {
+      if (! config->radioIDs()->setDefaultId(defaultId)) {
+        errMsg(err) << "Cannot set default radio ID " << defaultId << ".";
+        return false;
+      }
+    } else if (config->radioIDs()->count()) {
+      config->radioIDs()->setDefaultId(0);
+    }
+
+    leaveRecord(end);
+    return true;
+  }
+
+  /** Reads the elements of the given list. */
+  bool readList(AbstractConfigObjectList *list, const ErrorStack &err) {
+    uint32_t count = 0;
+    if (! readUInt32(count)) {
+      errMsg(err) << "Truncated list in snapshot.";
+      return false;
+    }
+    for (uint32_t i=0; i<count; i++) {
+      ConfigObject *obj = readObject(err);
+      if (nullptr == obj)
+        return false;
+      if (nullptr == list) {
+        obj->deleteLater();
+        continue;
+      }
+      if (0 > list->add(obj)) {
+        errMsg(err) << "Cannot add " << obj->metaObject()->className() << " '" << obj->name()
+                    << "' to list.";
+        obj->deleteLater();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Reads a codeplug element record. */
+  ConfigObject *readObject(const ErrorStack &err) {
+    uint8_t type = 0; const char *end = nullptr;
+    if (! enterRecord(type, end, err))
+      return nullptr;
+
+    ConfigObject *obj = nullptr;
+    switch (Record(type)) {
+    case Record::DMRRadioID: obj = new DMRRadioID(); break;
+    case Record::DTMFRadioID: obj = new DTMFRadioID(); break;
+    case Record::DMRContact: obj = new DMRContact(); break;
+    case Record::DTMFContact: obj = new DTMFContact(); break;
+    case Record::GroupList: obj = new RXGroupList(); break;
+    case Record::DMRChannel: obj = new DMRChannel(); break;
+    case Record::FMChannel: obj = new FMChannel(); break;
+    case Record::Zone: obj = new Zone(); break;
+    case Record::ScanList: obj = new ScanList(); break;
+    case Record::GPSSystem: obj = new GPSSystem(); break;
+    case Record::APRSSystem: obj = new APRSSystem(); break;
+    case Record::RoamingChannel: obj = new RoamingChannel(); break;
+    case Record::RoamingZone: obj = new RoamingZone(); break;
+    case Record::DMREncryptionKey: obj = new DMREncryptionKey(); break;
+    case Record::AESEncryptionKey: obj = new AESEncryptionKey(); break;
+    default:
+      errMsg(err) << "Unknown element record type " << type << " in snapshot.";
+      return nullptr;
+    }
+
+    uint32_t id = 0; QString name;
+    if ((! readUInt32(id)) || (! readString(name))) {
+      errMsg(err) << "Truncated " << obj->metaObject()->className() << " record in snapshot.";
+      obj->deleteLater();
+      return nullptr;
+    }
+    if ((ID_NONE == id) || (ID_DEFAULT_ROAMING_ZONE <= id) || _objects.contains(id)) {
+      errMsg(err) << "Invalid object ID " << id << " of " << obj->metaObject()->className()
+                  << " '" << name << "' in snapshot.";
+      obj->deleteLater();
+      return nullptr;
+    }
+    _objects.insert(id, obj);
+    obj->setName(name);
+
+    bool ok = false;
+    switch (Record(type)) {
+    case Record::DMRRadioID: ok = readDMRRadioID(obj->as<DMRRadioID>()); break;
+    case Record::DTMFRadioID: ok = readDTMFRadioID(obj->as<DTMFRadioID>()); break;
+    case Record::DMRContact: ok = readDMRContact(obj->as<DMRContact>(), err); break;
+    case Record::DTMFContact: ok = readDTMFContact(obj->as<DTMFContact>()); break;
+    case Record::GroupList: ok = readRefList(obj->as<RXGroupList>()->contacts()); break;
+    case Record::DMRChannel: ok = readDMRChannel(obj->as<DMRChannel>(), err); break;
+    case Record::FMChannel: ok = readFMChannel(obj->as<FMChannel>(), err); break;
+    case Record::Zone: ok = readZone(obj->as<Zone>(), err); break;
+    case Record::ScanList: ok = readScanList(obj->as<ScanList>(), err); break;
+    case Record::GPSSystem: ok = readGPSSystem(obj->as<GPSSystem>()); break;
+    case Record::APRSSystem: ok = readAPRSSystem(obj->as<APRSSystem>()); break;
+    case Record::RoamingChannel: ok = readRoamingChannel(obj->as<RoamingChannel>()); break;
+    case Record::RoamingZone: ok = readRefList(obj->as<RoamingZone>()->channels()); break;
+    case Record::DMREncryptionKey:
+    case Record::AESEncryptionKey: ok = readEncryptionKey(obj->as<EncryptionKey>()); break;
+    default: break;
+    }
+    // Read any other property of the element
+    if (ok)
+      ok = readProperties(obj, err);
+    if (! ok) {
+      errMsg(err) << "Cannot read " << obj->metaObject()->className() << " '" << name
+                  << "' from snapshot.";
+      obj->deleteLater();
+      return nullptr;
+    }
+
+    leaveRecord(end);
+    return obj;
+  }
+
+  /** Reads the fields of a DMR radio ID. */
+  bool readDMRRadioID(DMRRadioID *id) {
+    uint32_t number = 0;
+    if (! readUInt32(number))
+      return false;
+    id->setNumber(number);
+    return true;
+  }
+
+  /** Reads the fields of a DTMF radio ID. */
+  bool readDTMFRadioID(DTMFRadioID *id) {
+    QString number;
+    if (! readString(number))
+      return false;
+    id->setNumber(number);
+    return true;
+  }
+
+  /** Reads the fields of a DMR contact. */
+  bool readDMRContact(DMRContact *contact, const ErrorStack &err) {
+    uint8_t ring = 0, type = 0; uint32_t number = 0;
+    AnytoneContactExtension *anytone = nullptr;
+    OpenGD77ContactExtension *openGD77 = nullptr;
+    if ((! readUInt8(ring)) || (! readUInt8(type)) || (! readUInt32(number)) ||
+        (! readExtension(anytone, err)) || (! readExtension(openGD77, err)))
+      return false;
+    contact->setRing(ring);
+    contact->setType(DMRContact::Type(type));
+    contact->setNumber(number);
+    contact->setAnytoneExtension(anytone);
+    contact->setOpenGD77ContactExtension(openGD77);
+    return true;
+  }
+
+  /** Reads the fields of a DTMF contact. */
+  bool readDTMFContact(DTMFContact *contact) {
+    uint8_t ring = 0; QString number;
+    if ((! readUInt8(ring)) || (! readString(number)))
+      return false;
+    contact->setRing(ring);
+    contact->setNumber(number);
+    return true;
+  }
+
+  /** Reads the fields common to all channels. */
+  bool readChannel(Channel *channel, const ErrorStack &err) {
+    qint64 rx = 0, tx = 0;
+    uint8_t defaultPower = 0, power = 0, rxOnly = 0;
+    uint32_t timeout = 0, vox = 0;
+    OpenGD77ChannelExtension *openGD77 = nullptr;
+    TyTChannelExtension *tyt = nullptr;
+    if ((! readInt64(rx)) || (! readInt64(tx)) || (! readUInt8(defaultPower)) ||
+        (! readUInt8(power)) || (! readUInt32(timeout)) || (! readUInt8(rxOnly)) ||
+        (! readUInt32(vox)) || (! readReference(channel->scanListRef())) ||
+        (! readExtension(openGD77, err)) || (! readExtension(tyt, err)))
+      return false;
+    channel->setRXFreq(Frequency::fromHz(rx));
+    channel->setTXFreq(Frequency::fromHz(tx));
+    channel->setPower(Channel::Power(power));
+    if (defaultPower)
+      channel->setDefaultPower();
+    channel->setTimeout(timeout);
+    channel->setRXOnly(rxOnly);
+    channel->setVOX(vox);
+    channel->setOpenGD77ChannelExtension(openGD77);
+    channel->setTyTChannelExtension(tyt);
+    return true;
+  }
+
+  /** Reads the fields of a DMR channel. */
+  bool readDMRChannel(DMRChannel *channel, const ErrorStack &err) {
+    uint8_t admit = 0, colorCode = 0, timeSlot = 0;
+    CommercialChannelExtension *commercial = nullptr;
+    AnytoneDMRChannelExtension *anytone = nullptr;
+    if ((! readChannel(channel, err)) || (! readUInt8(admit)) || (! readUInt8(colorCode)) ||
+        (! readUInt8(timeSlot)) || (! readReference(channel->radioId())) ||
+        (! readReference(channel->groupList())) || (! readReference(channel->contact())) ||
+        (! readReference(channel->aprs())) || (! readReference(channel->roaming())) ||
+        (! readExtension(commercial, err)) || (! readExtension(anytone, err)))
+      return false;
+    channel->setAdmit(DMRChannel::Admit(admit));
+    channel->setColorCode(colorCode);
+    channel->setTimeSlot(DMRChannel::TimeSlot(timeSlot));
+    channel->setCommercialExtension(commercial);
+    channel->setAnytoneChannelExtension(anytone);
+    return true;
+  }
+
+  /** Reads the fields of an FM channel. */
+  bool readFMChannel(FMChannel *channel, const ErrorStack &err) {
+    uint8_t admit = 0, bandwidth = 0;
+    uint32_t squelch = 0, rxTone = 0, txTone = 0;
+    AnytoneFMChannelExtension *anytone = nullptr;
+    if ((! readChannel(channel, err)) || (! readUInt8(admit)) || (! readUInt32(squelch)) ||
+        (! readUInt32(rxTone)) || (! readUInt32(txTone)) || (! readUInt8(bandwidth)) ||
+        (! readReference(channel->aprs())) || (! readExtension(anytone, err)))
+      return false;
+    channel->setAdmit(FMChannel::Admit(admit));
+    channel->setSquelch(squelch);
+    channel->setRXTone(Signaling::Code(rxTone));
+    channel->setTXTone(Signaling::Code(txTone));
+    channel->setBandwidth(FMChannel::Bandwidth(bandwidth));
+    channel->setAnytoneChannelExtension(anytone);
+    return true;
+  }
+
+  /** Reads the fields of a zone. */
+  bool readZone(Zone *zone, const ErrorStack &err) {
+    AnytoneZoneExtension *anytone = nullptr;
+    if ((! readRefList(zone->A())) || (! readRefList(zone->B())) ||
+        (! readExtension(anytone, err)))
+      return false;
+    zone->setAnytoneExtension(anytone);
+    return true;
+  }
+
+  /** Reads the fields of a scan list. */
+  bool readScanList(ScanList *list, const ErrorStack &err) {
+    TyTScanListExtension *tyt = nullptr;
+    if ((! readReference(list->primary())) || (! readReference(list->secondary())) ||
+        (! readReference(list->revert())) || (! readRefList(list->channels())) ||
+        (! readExtension(tyt, err)))
+      return false;
+    list->setTyTScanListExtension(tyt);
+    return true;
+  }
+
+  /** Reads the fields of a DMR GPS system. */
+  bool readGPSSystem(GPSSystem *sys) {
+    uint32_t period = 0;
+    if ((! readUInt32(period)) || (! readReference(sys->contact())) ||
+        (! readReference(sys->revert())))
+      return false;
+    sys->setPeriod(period);
+    return true;
+  }
+
+  /** Reads the fields of an APRS system. */
+  bool readAPRSSystem(APRSSystem *sys) {
+    uint32_t period = 0, icon = 0;
+    uint8_t destSSID = 0, srcSSID = 0;
+    QString message, destination, source, path;
+    if ((! readUInt32(period)) || (! readReference(sys->revert())) || (! readUInt32(icon)) ||
+        (! readString(message)) || (! readString(destination)) || (! readUInt8(destSSID)) ||
+        (! readString(source)) || (! readUInt8(srcSSID)) || (! readString(path)))
+      return false;
+    sys->setPeriod(period);
+    sys->setIcon(APRSSystem::Icon(icon));
+    sys->setMessage(message);
+    sys->setDestination(destination, destSSID);
+    sys->setSource(source, srcSSID);
+    sys->setPath(path);
+    return true;
+  }
+
+  /** Reads the fields of a roaming channel. */
+  bool readRoamingChannel(RoamingChannel *channel) {
+    qint64 rx = 0, tx = 0;
+    uint8_t overrideColorCode = 0, colorCode = 0, overrideTimeSlot = 0, timeSlot = 0;
+    if ((! readInt64(rx)) || (! readInt64(tx)) || (! readUInt8(overrideColorCode)) ||
+        (! readUInt8(colorCode)) || (! readUInt8(overrideTimeSlot)) || (! readUInt8(timeSlot)))
+      return false;
+    channel->setRXFreq(Frequency::fromHz(rx));
+    channel->setTXFreq(Frequency::fromHz(tx));
+    channel->overrideColorCode(overrideColorCode);
+    channel->setColorCode(colorCode);
+    channel->overrideTimeSlot(overrideTimeSlot);
+    channel->setTimeSlot(DMRChannel::TimeSlot(timeSlot));
+    return true;
+  }
+
+  /** Reads the fields of an encryption key. */
+  bool readEncryptionKey(EncryptionKey *key) {
+    QString hex;
+    if (! readString(hex))
+      return false;
+    key->fromHex(hex);
+    return true;
+  }
+
+  /** Reads an optional extension. Allocates the extension if the record is not a null record. */
+  template <class Extension>
+  bool readExtension(Extension *&ext, const ErrorStack &err) {
+    ext = nullptr;
+    uint8_t type = 0; const char *end = nullptr;
+    if (! enterRecord(type, end, err))
+      return false;
+    if (uint8_t(Record::Null) != type) {
+      if (uint8_t(Record::Item) != type) {
+        errMsg(err) << "Expected item record, got record type " << type << ".";
+        return false;
+      }
+      ext = new Extension();
+      if (! readProperties(ext, err)) {
+        ext->deleteLater();
+        ext = nullptr;
+        return false;
+      }
+    }
+    leaveRecord(end);
+    return true;
+  }
+
+  /** Reads a generic item record into the given, existing item.
+   * A null record leaves the item untouched. */
+  bool readItemRecord(ConfigItem *item, const ErrorStack &err) {
+    uint8_t type = 0; const char *end = nullptr;
+    if (! enterRecord(type, end, err))
+      return false;
+    if (uint8_t(Record::Null) != type) {
+      if (uint8_t(Record::Item) != type) {
+        errMsg(err) << "Expected item record, got record type " << type << ".";
+        return false;
+      }
+      if (item && (! readProperties(item, err)))
+        return false;
+    }
+    leaveRecord(end);
+    return true;
+  }
+
+  /** Reads a property block into the given item. */
+  bool readProperties(ConfigItem *item, const ErrorStack &err) {
+    uint32_t idx = 0;
+    if ((! readUInt32(idx)) || (uint32_t(_types.size()) <= idx)) {
+      errMsg(err) << "Invalid type of " << item->metaObject()->className() << " in snapshot.";
+      return false;
+    }
+
+    Type &type = _types[idx];
+    if (type.className != item->metaObject()->className()) {
+      errMsg(err) << "Expected " << item->metaObject()->className() << ", got "
+                  << type.className << " in snapshot.";
+      return false;
+    }
+
+    const ConfigItem::PropertyPlan &plan = item->propertyPlan();
+    if (type.properties.isEmpty() && (! type.names.isEmpty())) {
+      // Map fields to properties once per type
+      for (int i=0; i<type.names.size(); i++) {
+        int prop = plan.index.value(type.names.at(i).toLatin1(), -1);
+        if ((0 <= prop) && (type.kinds.at(i) != SnapshotEncoder::fieldKind(item, plan.properties.at(prop))))
+          prop = -1;
+        type.properties.append(prop);
+      }
+    }
+
+    for (int i=0; i<type.kinds.size(); i++) {
+      QMetaProperty prop;
+      if (0 <= type.properties.at(i))
+        prop = plan.properties.at(type.properties.at(i)).prop;
+      if (! readField(item, prop, type.kinds.at(i), err)) {
+        errMsg(err) << "Cannot read field '" << type.names.at(i) << "' of " << type.className
+                    << " from snapshot.";
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /** Reads a single field of a generic item record. If the property is invalid, the field gets
+   * skipped. */
+  bool readField(ConfigItem *item, QMetaProperty &prop, uint8_t kind, const ErrorStack &err) {
+    bool skip = ! prop.isValid();
+    int32_t i = 0; uint32_t u = 0; uint8_t b = 0; qint64 bits = 0; QString str;
+    switch (kind) {
+    case FIELD_ENUM:
+    case FIELD_INT:
+      if (! readInt32(i))
+        return false;
+      if (! skip)
+        prop.write(item, i);
+      return true;
+    case FIELD_BOOL:
+      if (! readUInt8(b))
+        return false;
+      if (! skip)
+        prop.write(item, bool(b));
+      return true;
+    case FIELD_UINT:
+      if (! readUInt32(u))
+        return false;
+      if (! skip)
+        prop.write(item, u);
+      return true;
+    case FIELD_DOUBLE:
+      if (! readInt64(bits))
+        return false;
+      if (! skip) {
+        double value = 0;
+        memcpy(&value, &bits, sizeof(double));
+        prop.write(item, value);
+      }
+      return true;
+    case FIELD_STRING:
+      if (! readString(str))
+        return false;
+      if (! skip)
+        prop.write(item, str);
+      return true;
+    case FIELD_REFERENCE:
+      return readReference(skip ? nullptr : prop.read(item).value<ConfigObjectReference *>());
+    case FIELD_REFLIST:
+      return readRefList(skip ? nullptr : prop.read(item).value<ConfigObjectRefList *>());
+    case FIELD_LIST:
+      return readList(skip ? nullptr : prop.read(item).value<ConfigObjectList *>(), err);
+    case FIELD_ITEM:
+      return readChild(item, prop, err);
+    default:
+      break;
+    }
+    return false;
+  }
+
+  /** Reads the item record of a child item. Allocates the child if needed. */
+  bool readChild(ConfigItem *item, QMetaProperty &prop, const ErrorStack &err) {
+    uint8_t type = 0; const char *end = nullptr;
+    if (! enterRecord(type, end, err))
+      return false;
+    if ((uint8_t(Record::Item) == type) && prop.isValid()) {
+      ConfigItem *child = prop.read(item).value<ConfigItem *>();
+      // If not set and writable -> allocate and set
+      if ((nullptr == child) && prop.isWritable()) {
+        if (nullptr == (child = item->allocateChild(prop, YAML::Node(), _context, err))) {
+          errMsg(err) << "Cannot allocate " << prop.name() << " of "
+                      << item->metaObject()->className() << ".";
+          return false;
+        }
+        if (! prop.write(item, QVariant::fromValue(child))) {
+          if (nullptr == child->parent())
+            child->deleteLater();
+          errMsg(err) << "Cannot set writable property '" << prop.name() << "' in "
+                      << item->metaObject()->className() << ".";
+          return false;
+        }
+      }
+      if (child && (! readProperties(child, err)))
+        return false;
+    } else if ((uint8_t(Record::Null) != type) && (uint8_t(Record::Item) != type)) {
+      errMsg(err) << "Expected item record, got record type " << type << ".";
+      return false;
+    }
+    leaveRecord(end);
+    return true;
+  }
+
+  /** Reads an object ID and schedules the reference for linking. */
+  bool readReference(ConfigObjectReference *ref) {
+    uint32_t id = 0;
+    if (! readUInt32(id))
+      return false;
+    if (ref && (ID_NONE != id))
+      _references.append(PendingReference(ref, id));
+    return true;
+  }
+
+  /** Reads the object IDs of a reference list and schedules the list for linking. */
+  bool readRefList(ConfigObjectRefList *list) {
+    uint32_t count = 0;
+    if ((! readUInt32(count)) || (uint32_t(_end-_data)/sizeof(uint32_t) < count))
+      return false;
+    QVector<uint32_t> ids(count);
+    for (uint32_t i=0; i<count; i++)
+      readUInt32(ids[i]);
+    if (list && count)
+      _refLists.append(PendingRefList(list, ids));
+    return true;
+  }
+
+  /** Resolves the given object ID. */
+  ConfigObject *object(uint32_t id, const ErrorStack &err) {
+    switch (id) {
+    case ID_SELECTED_CHANNEL: return SelectedChannel::get();
+    case ID_DEFAULT_RADIO_ID: return DefaultRadioID::get();
+    case ID_DEFAULT_ROAMING_ZONE: return DefaultRoamingZone::get();
+    default: break;
+    }
+    ConfigObject *obj = _objects.value(id, nullptr);
+    if (nullptr == obj)
+      errMsg(err) << "Cannot resolve reference to unknown object ID " << id << ".";
+    return obj;
+  }
+
+  /** Links all references, once all objects are read. */
+  bool link(const ErrorStack &err) {
+    foreach (const PendingReference &ref, _references) {
+      ConfigObject *obj = object(ref.second, err);
+      if (nullptr == obj)
+        return false;
+      if (! ref.first->set(obj)) {
+        errMsg(err) << "Cannot link reference to " << obj->metaObject()->className()
+                    << " '" << obj->name() << "'.";
+        return false;
+      }
+    }
+
+    foreach (const PendingRefList &list, _refLists) {
+      foreach (uint32_t id, list.second) {
+        ConfigObject *obj = object(id, err);
+        if (nullptr == obj)
+          return false;
+        if (0 > list.first->add(obj)) {
+          errMsg(err) << "Cannot add " << obj->metaObject()->className()
+                      << " '" << obj->name() << "' to reference list.";
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /** Enters a record, restricts the read position to its content.
+   * Returns the type of the record and the previous end. */
+  bool enterRecord(uint8_t &type, const char *&end, const ErrorStack &err) {
+    uint32_t length = 0;
+    if ((! readUInt8(type)) || (! readUInt32(length)) || (uint32_t(_end-_data) < length)) {
+      errMsg(err) << "Truncated record in snapshot.";
+      return false;
+    }
+    end = _end;
+    _end = _data + length;
+    return true;
+  }
+
+  /** Leaves the current record, skipping any unknown trailing content. */
+  void leaveRecord(const char *end) {
+    _data = _end;
+    _end = end;
+  }
+
+  /** Reads a string index and resolves it. */
+  bool readString(QString &str) {
+    uint32_t idx = 0;
+    if ((! readUInt32(idx)) || (uint32_t(_strings.size()) <= idx))
+      return false;
+    str = _strings.at(idx);
+    return true;
+  }
+
+  /** Reads an unsigned byte. */
+  bool readUInt8(uint8_t &value) {
+    if (_data >= _end)
+      return false;
+    value = uint8_t(*_data++);
+    return true;
+  }
+
+  /** Reads an unsigned little endian integer. */
+  bool readUInt32(uint32_t &value) {
+    if ((_end-_data) < qint64(sizeof(uint32_t)))
+      return false;
+    value = qFromLittleEndian<quint32>((const uchar *)_data);
+    _data += sizeof(uint32_t);
+    return true;
+  }
+
+  /** Reads a signed little endian integer. */
+  bool readInt32(int32_t &value) {
+    uint32_t u = 0;
+    if (! readUInt32(u))
+      return false;
+    value = int32_t(u);
+    return true;
+  }
+
+  /** Reads a signed 64bit little endian integer. */
+  bool readInt64(qint64 &value) {
+    if ((_end-_data) < qint64(sizeof(quint64)))
+      return false;
+    value = qint64(qFromLittleEndian<quint64>((const uchar *)_data));
+    _data += sizeof(quint64);
+    return true;
+  }
+
+protected:
+  /** Describes the fields of a generic item record. */
+  struct Type {
+    /** The class name of the item. */
+    QString className;
+    /** The field names. */
+    QVector<QString> names;
+    /** The field kinds. */
+    QVector<uint8_t> kinds;
+    /** The property plan index for each field or -1, if the field is skipped.
+     * Gets populated on first use. */
+    QVector<int> properties;
+  };
+
+  /** A reference to be linked and the ID of the referenced object. */
+  typedef QPair<ConfigObjectReference *, uint32_t> PendingReference;
+  /** A reference list to be linked and the IDs of the referenced objects. */
+  typedef QPair<ConfigObjectRefList *, QVector<uint32_t>> PendingRefList;
+
+  /** The current read position. */
+  const char *_data;
+  /** The end of the current section or record. */
+  const char *_end;
+  /** The string table. */
+  QVector<QString> _strings;
+  /** The type table. */
+  QVector<Type> _types;
+  /** Maps object IDs to the decoded objects. */
+  QHash<uint32_t, ConfigObject *> _objects;
+  /** References to be linked. */
+  QVector<PendingReference> _references;
+  /** Reference lists to be linked. */
+  QVector<PendingRefList> _refLists;
+  /** Context passed to allocated child items. */
+  ConfigItem::Context _context;
+};
+
+
+/* ********************************************************************************************* *
+ * Implementation of ConfigSnapshot
+ * ********************************************************************************************* */
+const uint32_t ConfigSnapshot::Version;
+
+bool
+ConfigSnapshot::isSnapshot(const QString &filename) {
+  QFile file(filename);
+  if (! file.open(QIODevice::ReadOnly))
+    return false;
+  return QByteArray(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) == file.read(SNAPSHOT_MAGIC_SIZE);
+}
+
+bool
+ConfigSnapshot::encode(Config *config, QByteArray &data, const ErrorStack &err) {
+  SnapshotEncoder encoder;
+  if (! encoder.encode(config, err))
+    return false;
+  data = encoder.data();
+  return true;
+}
+
+bool
+ConfigSnapshot::decode(const char *data, qint64 size, Config *config, const ErrorStack &err) {
+  Config::Transaction transaction(config);
+  config->clear();
+  SnapshotDecoder decoder(data, size);
+  return decoder.decode(config, err);
+}
+
+bool
+ConfigSnapshot::write(Config *config, const QString &filename, const ErrorStack &err) {
+  QByteArray data;
+  if (! encode(config, data, err))
+    return false;
+
+  QSaveFile file(filename);
+  if (! file.open(QIODevice::WriteOnly)) {
+    errMsg(err) << "Cannot open snapshot file '" << filename << "': " << file.errorString() << ".";
+    return false;
+  }
+
+  if ((data.size() != file.write(data)) || (! file.commit())) {
+    errMsg(err) << "Cannot write snapshot file '" << filename << "': " << file.errorString() << ".";
+    return false;
+  }
+
+  return true;
+}
+
+bool
+ConfigSnapshot::read(const QString &filename, Config *config, const ErrorStack &err) {
+  QFile file(filename);
+  if (! file.open(QIODevice::ReadOnly)) {
+    errMsg(err) << "Cannot open snapshot file '" << filename << "': " << file.errorString() << ".";
+    return false;
+  }
+
+  // Decode from memory mapped file, fall back to reading the file if it cannot be mapped
+  QByteArray buffer;
+  uchar *mapped = file.map(0, file.size());
+  if (nullptr == mapped)
+    buffer = file.readAll();
+  bool ok = mapped ? decode((const char *)mapped, file.size(), config, err)
+                   : decode(buffer.constData(), buffer.size(), config, err);
+  if (mapped)
+    file.unmap(mapped);
+
+  if (! ok)
+    errMsg(err) << "Cannot read snapshot file '" << filename << "'.";
+
+  return ok;
+}
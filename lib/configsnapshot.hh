@@ -0,0 +1,98 @@
+#ifndef CONFIGSNAPSHOT_HH
+#define CONFIGSNAPSHOT_HH
+
+#include <QString>
+#include <QByteArray>
+
+#include "errorstack.hh"
+
+class Config;
+
+
+/** Implements the compact binary snapshot format for codeplugs.
+ *
+ * YAML is the interchange format for codeplugs. Reading and writing large codeplugs in YAML is,
+ * however, dominated by scanning and emitting the text as well as by the reflection based
+ * parsing and linking of the document tree. The snapshot format stores the codeplug as a sequence
+ * of typed records, that are written and read directly from and into the codeplug elements.
+ * Hence it is suited for fast saving and loading of projects as well as for auto-saving.
+ *
+ * A snapshot file starts with the magic @c "QDMRSNAP", followed by the format version and the
+ * number of sections (32bit little endian each). Each section consists of a 32bit type, a 32bit
+ * length and the section content. Unknown sections are skipped. There are three sections:
+ *  - The string table, holding every distinct string exactly once. All strings are stored as
+ *    32bit indices into this table.
+ *  - The type table, describing the property blocks of the generic records (see below).
+ *  - The object section, holding a single config record.
+ *
+ * Every record consists of a single byte record type, a 32bit length and the record content.
+ * Unknown trailing content of a record is skipped. For each type of codeplug element (radio IDs,
+ * contacts, channels, zones etc.) there is a dedicated record type. These records start with the
+ * object ID and the name of the element, followed by the fields of the element in a fixed order.
+ * References are stored as the ID of the referenced element. Object IDs are assigned
+ * consecutively, starting at 1. The ID 0 encodes a @c null reference. The fixed fields are
+ * followed by a property block, holding all remaining properties of the element. This way,
+ * properties added to the elements later on, are stored even if the fixed fields are not updated.
+ *
+ * Extensions and radio settings are stored as generic item records, consisting of a single
+ * property block. A property block starts with an index into the type table, followed by the
+ * values of the properties described by the type. The decoder maps the properties of each type
+ * only once to the properties of the class. Properties unknown to the decoder are skipped.
+ *
+ * When reading a snapshot, the file is memory-mapped and decoded directly from the mapping.
+ *
+ * @since 0.11.3
+ * @ingroup conf */
+class ConfigSnapshot
+{
+public:
+  /** Section types. */
+  enum class Section {
+    Strings = 1,   ///< The string table.
+    Types   = 2,   ///< The type table.
+    Objects = 3    ///< The config record.
+  };
+
+  /** Record types. */
+  enum class Record {
+    Null             = 0x00,  ///< An unset item.
+    Item             = 0x01,  ///< A generic item, described by the type table.
+    Config           = 0x02,  ///< The complete codeplug.
+    DMRRadioID       = 0x10,  ///< A DMR radio ID.
+    DTMFRadioID      = 0x11,  ///< A DTMF radio ID.
+    DMRContact       = 0x12,  ///< A DMR contact.
+    DTMFContact      = 0x13,  ///< A DTMF contact.
+    GroupList        = 0x14,  ///< A RX group list.
+    DMRChannel       = 0x15,  ///< A DMR channel.
+    FMChannel        = 0x16,  ///< An FM channel.
+    Zone             = 0x17,  ///< A zone.
+    ScanList         = 0x18,  ///< A scan list.
+    GPSSystem        = 0x19,  ///< A DMR GPS system.
+    APRSSystem       = 0x1a,  ///< An APRS system.
+    RoamingChannel   = 0x1b,  ///< A roaming channel.
+    RoamingZone      = 0x1c,  ///< A roaming zone.
+    DMREncryptionKey = 0x1d,  ///< A basic DMR encryption key.
+    AESEncryptionKey = 0x1e   ///< An AES encryption key.
+  };
+
+  /** The current format version. */
+  static const uint32_t Version = 2;
+
+public:
+  /** Returns @c true if the given file starts with the snapshot magic. */
+  static bool isSnapshot(const QString &filename);
+
+  /** Encodes the given codeplug into a snapshot. */
+  static bool encode(Config *config, QByteArray &data, const ErrorStack &err=ErrorStack());
+  /** Decodes the codeplug from the given snapshot data. The given config gets cleared first. */
+  static bool decode(const char *data, qint64 size, Config *config,
+                     const ErrorStack &err=ErrorStack());
+
+  /** Writes the given codeplug as a snapshot into the specified file. The file is replaced
+   * atomically, that is, it is either completely written or not modified at all. */
+  static bool write(Config *config, const QString &filename, const ErrorStack &err=ErrorStack());
+  /** Reads the codeplug from the specified snapshot file. */
+  static bool read(const QString &filename, Config *config, const ErrorStack &err=ErrorStack());
+};
+
+#endif // CONFIGSNAPSHOT_HH
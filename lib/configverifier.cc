@@ -0,0 +1,293 @@
+#include "configverifier.hh"
+#include "config.hh"
+#include "configreference.hh"
+#include "radio.hh"
+#include "logger.hh"
+
+#include <QMetaProperty>
+
+#define VERIFIER_BATCH_SIZE 64
+
+
+/* ********************************************************************************************* *
+ * Implementation of ConfigVerifier
+ * ********************************************************************************************* */
+ConfigVerifier::ConfigVerifier(Config *config, QObject *parent)
+  : QObject(parent), _config(config), _limits(nullptr), _ignoreFrequencyLimits(false), _radio(),
+    _ownedLimits(nullptr), _lists(), _cache(), _dirty(), _referrers(), _references(), _timer()
+{
+  _timer.setSingleShot(true);
+  _timer.setInterval(0);
+  connect(&_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+  foreach (AbstractConfigObjectList *list, _config->lists()) {
+    connect(list, SIGNAL(elementAdded(int)), this, SLOT(onElementAdded(int)));
+    connect(list, SIGNAL(elementModified(int)), this, SLOT(onElementModified(int)));
+    connect(list, SIGNAL(elementsModified(int,int)), this, SLOT(onElementsModified(int,int)));
+    connect(list, SIGNAL(elementsReset()), this, SLOT(onElementsReset()));
+  }
+}
+
+const RadioLimits *
+ConfigVerifier::limits() const {
+  return _limits;
+}
+
+void
+ConfigVerifier::setLimits(const RadioLimits *limits, bool ignoreFrequencyLimits) {
+  if ((_limits == limits) && (_ignoreFrequencyLimits == ignoreFrequencyLimits))
+    return;
+
+  if (_limits)
+    disconnect(_limits, SIGNAL(destroyed(QObject*)), this, SLOT(onLimitsDeleted()));
+  if (_limits != limits)
+    _radio.clear();
+
+  _limits = limits;
+  _ignoreFrequencyLimits = ignoreFrequencyLimits;
+  _lists.clear();
+  _cache.clear();
+  _dirty.clear();
+
+  if (nullptr == _limits)
+    return;
+  connect(_limits, SIGNAL(destroyed(QObject*)), this, SLOT(onLimitsDeleted()));
+
+  // Find the limits of all lists of the configuration
+  const QMetaObject *meta = _config->metaObject();
+  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
+    QMetaProperty prop = meta->property(p);
+    const RadioLimitList *limits = qobject_cast<const RadioLimitList *>(_limits->element(prop.name()));
+    ConfigObjectList *list = prop.read(_config).value<ConfigObjectList *>();
+    if ((nullptr == limits) || (nullptr == list))
+      continue;
+    _lists.insert(list, ListLimits{limits, prop.name()});
+    markDirty(list);
+  }
+}
+
+void
+ConfigVerifier::setRadio(Radio *radio, bool ignoreFrequencyLimits) {
+  if (nullptr == radio)
+    return;
+
+  QString key = radio->name() + "/" + radio->variant();
+  if (_limits && (key == _radio)) {
+    // Same model and variant, keep limits and cached results
+    setLimits(_limits, ignoreFrequencyLimits);
+    return;
+  }
+
+  logDebug() << "Verify configuration against limits of '" << key << "'.";
+  RadioLimits *previous = _ownedLimits;
+  _ownedLimits = radio->takeLimits(this);
+  setLimits(_ownedLimits ? _ownedLimits : &radio->limits(), ignoreFrequencyLimits);
+  _radio = key;
+  if (previous)
+    previous->deleteLater();
+}
+
+bool
+ConfigVerifier::isUpToDate() const {
+  return _dirty.isEmpty();
+}
+
+RadioLimitContext
+ConfigVerifier::issues() {
+  RadioLimitContext context(_ignoreFrequencyLimits);
+  if (nullptr == _limits)
+    return context;
+
+  _limits->verifyRadio(context);
+
+  const QMetaObject *meta = _config->metaObject();
+  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
+    QMetaProperty prop = meta->property(p);
+    const RadioLimitElement *limits = _limits->element(prop.name());
+    if (nullptr == limits)
+      continue;
+
+    ConfigObjectList *list = prop.read(_config).value<ConfigObjectList *>();
+    if ((nullptr == list) || (! _lists.contains(list))) {
+      // Anything else than a list is cheap to verify
+      if (! limits->verify(_config, prop, context))
+        return context;
+      continue;
+    }
+
+    // Collect cached issues, verify elements that were modified or moved
+    const ListLimits &listLimits = _lists[list];
+    context.pushList(listLimits.name);
+    for (int i=0; i<list->count(); i++) {
+      ConfigObject *obj = list->get(i);
+      if (_dirty.contains(obj) || (! _cache.contains(obj)) || (i != _cache[obj].index))
+        verify(listLimits, i, obj);
+      context.merge(_cache[obj].issues);
+      if (! _cache[obj].success) {
+        // Stop at the first critical issue, remaining elements get verified in the background
+        context.pop();
+        return context;
+      }
+    }
+    listLimits.limits->verifyCounts(list, context);
+    context.pop();
+  }
+
+  // Remaining objects are not part of the configuration anymore
+  _dirty.clear();
+
+  return context;
+}
+
+void
+ConfigVerifier::markDirty(ConfigObject *obj) {
+  if (nullptr == obj)
+    return;
+  _dirty.insert(obj);
+  connect(obj, SIGNAL(destroyed(QObject*)), this, SLOT(onObjectDeleted(QObject*)), Qt::UniqueConnection);
+  // Issues of elements may depend on the objects they refer to
+  foreach (ConfigObject *referrer, _referrers.value(obj))
+    _dirty.insert(referrer);
+  schedule();
+}
+
+void
+ConfigVerifier::markDirty(AbstractConfigObjectList *list) {
+  for (int i=0; i<list->count(); i++)
+    markDirty(list->get(i));
+}
+
+void
+ConfigVerifier::verify(const ListLimits &limits, int index, ConfigObject *obj) {
+  _dirty.remove(obj);
+
+  Entry &entry = _cache[obj];
+  entry.index = index;
+  entry.issues = RadioLimitContext(_ignoreFrequencyLimits);
+  entry.issues.pushList(limits.name);
+  entry.success = limits.limits->verifyElement(index, obj, entry.issues);
+  entry.issues.pop();
+
+  updateReferences(obj);
+  connect(obj, SIGNAL(destroyed(QObject*)), this, SLOT(onObjectDeleted(QObject*)), Qt::UniqueConnection);
+}
+
+void
+ConfigVerifier::updateReferences(ConfigObject *obj) {
+  removeReferences(obj);
+
+  QList<ConfigObject *> references;
+  const QMetaObject *meta = obj->metaObject();
+  for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
+    QVariant value = meta->property(p).read(obj);
+    if (ConfigObjectReference *ref = value.value<ConfigObjectReference *>()) {
+      if (! ref->isNull())
+        references.append(ref->as<ConfigObject>());
+    } else if (ConfigObjectRefList *refs = value.value<ConfigObjectRefList *>()) {
+      for (int i=0; i<refs->count(); i++)
+        references.append(refs->get(i));
+    }
+  }
+
+  foreach (ConfigObject *target, references)
+    _referrers[target].insert(obj);
+  _references.insert(obj, references);
+}
+
+void
+ConfigVerifier::removeReferences(ConfigObject *obj) {
+  foreach (ConfigObject *target, _references.take(obj)) {
+    if (! _referrers.contains(target))
+      continue;
+    _referrers[target].remove(obj);
+    if (_referrers[target].isEmpty())
+      _referrers.remove(target);
+  }
+}
+
+void
+ConfigVerifier::schedule() {
+  if (_limits && (! _timer.isActive()))
+    _timer.start();
+}
+
+void
+ConfigVerifier::onElementAdded(int idx) {
+  AbstractConfigObjectList *list = qobject_cast<AbstractConfigObjectList *>(sender());
+  if (list && _lists.contains(list))
+    markDirty(list->get(idx));
+}
+
+void
+ConfigVerifier::onElementModified(int idx) {
+  AbstractConfigObjectList *list = qobject_cast<AbstractConfigObjectList *>(sender());
+  if (list && _lists.contains(list))
+    markDirty(list->get(idx));
+}
+
+void
+ConfigVerifier::onElementsModified(int first, int last) {
+  AbstractConfigObjectList *list = qobject_cast<AbstractConfigObjectList *>(sender());
+  if ((nullptr == list) || (! _lists.contains(list)))
+    return;
+  for (int i=first; (i<=last) && (i<list->count()); i++)
+    markDirty(list->get(i));
+}
+
+void
+ConfigVerifier::onElementsReset() {
+  AbstractConfigObjectList *list = qobject_cast<AbstractConfigObjectList *>(sender());
+  if (list && _lists.contains(list))
+    markDirty(list);
+}
+
+void
+ConfigVerifier::onObjectDeleted(QObject *obj) {
+  // The object is partially destroyed already, the pointer is only used as a key
+  ConfigObject *object = static_cast<ConfigObject *>(obj);
+  _cache.remove(object);
+  _dirty.remove(object);
+  removeReferences(object);
+  // Elements referring to the deleted object get verified again
+  foreach (ConfigObject *referrer, _referrers.take(object))
+    markDirty(referrer);
+}
+
+void
+ConfigVerifier::onLimitsDeleted() {
+  if (_ownedLimits == _limits)
+    _ownedLimits = nullptr;
+  _limits = nullptr;
+  _radio.clear();
+  _lists.clear();
+  _cache.clear();
+  _dirty.clear();
+  _timer.stop();
+}
+
+void
+ConfigVerifier::onTimeout() {
+  if (nullptr == _limits)
+    return;
+
+  unsigned count = 0;
+  while ((! _dirty.isEmpty()) && (count < VERIFIER_BATCH_SIZE)) {
+    ConfigObject *obj = *_dirty.begin();
+    AbstractConfigObjectList *list = qobject_cast<AbstractConfigObjectList *>(obj->parent());
+    int index = list ? list->indexOf(obj) : -1;
+    if ((nullptr == list) || (! _lists.contains(list)) || (0 > index)) {
+      // Not part of the configuration anymore
+      _dirty.remove(obj);
+      continue;
+    }
+    verify(_lists[list], index, obj);
+    count++;
+  }
+
+  if (_dirty.isEmpty()) {
+    logDebug() << "Verification of configuration is up to date.";
+    emit updated();
+  } else {
+    _timer.start();
+  }
+}
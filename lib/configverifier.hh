@@ -0,0 +1,139 @@
+#ifndef CONFIGVERIFIER_HH
+#define CONFIGVERIFIER_HH
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QTimer>
+
+#include "radiolimits.hh"
+
+class Config;
+class ConfigObject;
+class ConfigObjectList;
+class AbstractConfigObjectList;
+class Radio;
+
+
+/** Keeps the verification of a configuration against some radio limits up to date.
+ *
+ * Verifying a large configuration with @c RadioLimits::verifyConfig takes some time. The verifier
+ * instead caches the issues of every element of the lists of the configuration. Whenever the
+ * configuration gets modified, only the modified elements and those elements referring to them
+ * are marked. They get verified again in small batches, whenever the event loop is idle. Hence
+ * the issues of the current configuration are usually available at once via @c issues.
+ *
+ * Like @c RadioLimits::verifyConfig, @c issues stops at the first element with a critical issue.
+ * The remaining modified elements get verified in the background.
+ *
+ * The verifier may take over the limits of a radio (see @c setRadio). Then the cached results
+ * remain valid for all radios of the same model and variant, e.g., for several uploads in a row.
+ *
+ * @ingroup limits */
+class ConfigVerifier : public QObject
+{
+  Q_OBJECT
+
+protected:
+  /** The cached verification result of a single list element. */
+  struct Entry {
+    /** The index of the element at the time of verification. */
+    int index;
+    /** If @c false, the element has a critical issue. */
+    bool success;
+    /** The issues found. */
+    RadioLimitContext issues;
+  };
+
+  /** The limits and the property name of a list of the configuration. */
+  struct ListLimits {
+    /** The limits of the list. */
+    const RadioLimitList *limits;
+    /** The name of the list property. */
+    const char *name;
+  };
+
+public:
+  /** Constructs a verifier for the given configuration. */
+  explicit ConfigVerifier(Config *config, QObject *parent=nullptr);
+
+  /** Returns the current limits or @c nullptr if there are none. */
+  const RadioLimits *limits() const;
+  /** Sets the limits to verify against. The ownership of the limits is not taken. If they differ
+   * from the current limits, the complete configuration gets verified again. */
+  void setLimits(const RadioLimits *limits, bool ignoreFrequencyLimits=false);
+  /** Verifies against the limits of the given radio. If the radio has the same model and variant
+   * as the previous one, the current limits and the cached results are kept. Otherwise, the
+   * verifier takes over the limits of the radio (see @c Radio::takeLimits). Hence the verification continues in the
+   * background, once the radio was destroyed.
+   * @since 0.11.3 */
+  void setRadio(Radio *radio, bool ignoreFrequencyLimits=false);
+
+  /** Returns @c true if all modified elements were verified. */
+  bool isUpToDate() const;
+  /** Returns the issues of the current configuration. All elements, that were not verified yet,
+   * get verified first. Stops at the first element with a critical issue. */
+  RadioLimitContext issues();
+
+signals:
+  /** Gets emitted once all modified elements were verified. */
+  void updated();
+
+protected:
+  /** Marks the given object and all objects referring to it as modified. */
+  void markDirty(ConfigObject *obj);
+  /** Marks all elements of the given list as modified. */
+  void markDirty(AbstractConfigObjectList *list);
+  /** Verifies the given element of a list and caches the result. */
+  void verify(const ListLimits &limits, int index, ConfigObject *obj);
+  /** Updates the objects, the given object refers to. */
+  void updateReferences(ConfigObject *obj);
+  /** Removes the given object from the reference graph. */
+  void removeReferences(ConfigObject *obj);
+  /** Schedules the verification of the modified elements. */
+  void schedule();
+
+protected slots:
+  /** Internal callback on added list elements. */
+  void onElementAdded(int idx);
+  /** Internal callback on modified list elements. */
+  void onElementModified(int idx);
+  /** Internal callback on coalesced modifications. */
+  void onElementsModified(int first, int last);
+  /** Internal callback on coalesced structural changes. */
+  void onElementsReset();
+  /** Internal callback on deleted objects. */
+  void onObjectDeleted(QObject *obj);
+  /** Internal callback on deleted limits. */
+  void onLimitsDeleted();
+  /** Internal callback to verify the next batch of modified elements. */
+  void onTimeout();
+
+protected:
+  /** The configuration. */
+  Config *_config;
+  /** The limits to verify against. */
+  const RadioLimits *_limits;
+  /** If @c true, frequency range violations are warnings. */
+  bool _ignoreFrequencyLimits;
+  /** Model and variant of the radio, the current limits were taken from. */
+  QString _radio;
+  /** The limits taken over from a radio, owned by the verifier. @c nullptr if the limits of the
+   * radio are shared by all instances. */
+  RadioLimits *_ownedLimits;
+  /** The limits of each list of the configuration. */
+  QHash<AbstractConfigObjectList *, ListLimits> _lists;
+  /** The cached results per list element. */
+  QHash<ConfigObject *, Entry> _cache;
+  /** The elements, that need to be verified again. */
+  QSet<ConfigObject *> _dirty;
+  /** Maps an object to the elements referring to it. */
+  QHash<ConfigObject *, QSet<ConfigObject *>> _referrers;
+  /** Maps an element to the objects it refers to. */
+  QHash<ConfigObject *, QList<ConfigObject *>> _references;
+  /** Verifies the modified elements once the event loop is idle. */
+  QTimer _timer;
+};
+
+#endif // CONFIGVERIFIER_HH
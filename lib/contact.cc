@@ -310,12 +310,9 @@ ContactList::digitalContact(int idx) const {
 
 DMRContact *
 ContactList::findDigitalContact(unsigned number) const {
-  for (int i=0; i<_items.size(); i++) {
-    if (! _items.at(i)->is<DMRContact>())
-      continue;
-    if (_items.at(i)->as<DMRContact>()->number() == number)
-      return _items.at(i)->as<DMRContact>();
-  }
+  // Several contacts may share a number, return the first one in list order
+  if (ConfigObject *obj = first(_numberIndex.values(number)))
+    return obj->as<DMRContact>();
   return nullptr;
 }
 
@@ -357,3 +354,37 @@ ContactList::allocateChild(const YAML::Node &node, ConfigItem::Context &ctx, con
 
   return nullptr;
 }
+
+void
+ContactList::insertItem(int row, ConfigObject *obj) {
+  ConfigObjectList::insertItem(row, obj);
+  indexContact(obj);
+}
+
+void
+ContactList::removeItem(int row) {
+  unindexContact(_items.at(row));
+  ConfigObjectList::removeItem(row);
+}
+
+void
+ContactList::updateItem(int row) {
+  // Number may have changed
+  unindexContact(_items.at(row));
+  indexContact(_items.at(row));
+}
+
+void
+ContactList::indexContact(ConfigObject *obj) {
+  if (DMRContact *contact = obj->as<DMRContact>()) {
+    _numberIndex.insert(contact->number(), obj);
+    _numbers.insert(obj, contact->number());
+  }
+}
+
+void
+ContactList::unindexContact(ConfigObject *obj) {
+  // Only uses the pointer, the object may already be destroyed.
+  if (_numbers.contains(obj))
+    _numberIndex.remove(_numbers.take(obj), obj);
+}
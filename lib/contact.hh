@@ -218,6 +218,10 @@ protected:
  * This class implements the @c QAbstractTableModel, such that the list can be shown with the
  * @c QTableView widget.
  *
+ * The list keeps a hash index of all digital contacts by their number, which gets updated
+ * whenever contacts are added, removed or modified. Hence @c findDigitalContact does not need to
+ * scan the list.
+ *
  * @ingroup conf */
 class ContactList: public ConfigObjectList
 {
@@ -245,6 +249,23 @@ public:
 
 public:
   ConfigItem *allocateChild(const YAML::Node &node, ConfigItem::Context &ctx, const ErrorStack &err=ErrorStack());
+
+protected:
+  void insertItem(int row, ConfigObject *obj);
+  void removeItem(int row);
+  void updateItem(int row);
+
+  /** Adds the given contact to the index. */
+  void indexContact(ConfigObject *obj);
+  /** Removes the given contact from the index. The contact may already be destroyed. */
+  void unindexContact(ConfigObject *obj);
+
+protected:
+  /** Maps numbers to the digital contacts. */
+  QMultiHash<unsigned, ConfigObject *> _numberIndex;
+  /** Maps each indexed digital contact to its number. Allows for removing contacts from the
+   * index, even if the number has changed or the contact was destroyed. */
+  QHash<const ConfigObject *, unsigned> _numbers;
 };
 
 #endif // CONTACT_HH
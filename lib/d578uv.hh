@@ -21,7 +21,7 @@ class D578UV: public AnytoneRadio
 
 public:
   /** Do not construct this class directly, rather use @c Radio::detect. */
-  explicit D578UV(AnytoneInterface *device=nullptr, QObject *parent=nullptr);
+  explicit D578UV(RadioInterface *device=nullptr, QObject *parent=nullptr);
 
   const RadioLimits &limits() const;
 
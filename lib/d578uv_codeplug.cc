@@ -1,6 +1,7 @@
 #include "d578uv_codeplug.hh"
 #include "config.hh"
 #include "utils.hh"
+#include "bitmapiterator.hh"
 #include "channel.hh"
 #include "gpssystem.hh"
 #include "userdatabase.hh"
@@ -152,8 +153,8 @@ D578UVCodeplug::D578UVCodeplug(QObject *parent)
 }
 
 void
-D578UVCodeplug::allocateUpdated() {
-  D878UVCodeplug::allocateUpdated();
+D578UVCodeplug::allocateKept() {
+  D878UVCodeplug::allocateKept();
 
   image(0).addElement(ADDR_UNKNOWN_SETTING_1, UNKNOWN_SETTING_1_SIZE);
   image(0).addElement(ADDR_UNKNOWN_SETTING_2, UNKNOWN_SETTING_2_SIZE);
@@ -173,8 +174,17 @@ D578UVCodeplug::encodeChannels(const Flags &flags, Context &ctx, const ErrorStac
   for (int i=0; i<ctx.config()->channelList()->count(); i++) {
     // enable channel
     uint16_t bank = i/128, idx = i%128;
-    ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    ch.fromChannelObj(ctx.config()->channelList()->channel(i), ctx);
+    uint32_t addr = CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE;
+    Channel *channel = ctx.config()->channelList()->channel(i);
+    ChannelElement ch(data(addr));
+    ch.fromChannelObj(channel, ctx);
+    // Remember the element for incremental encoding
+    trackElement(channel, [this, addr, channel](Context &ctx, const ErrorStack &err) {
+      Q_UNUSED(err)
+      ChannelElement ch(data(addr));
+      ch.fromChannelObj(channel, ctx);
+      return true;
+    });
   }
   return true;
 }
@@ -183,16 +193,12 @@ bool
 D578UVCodeplug::createChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Create channels
-  uint8_t *channel_bitmap = data(CHANNEL_BITMAP);
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == ((channel_bitmap[byte]>>bit) & 0x01))
-      continue;
+  // Create enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
     if (Channel *obj = ch.toChannelObj(ctx)) {
-      ctx.config()->channelList()->add(obj); ctx.add(obj, i);
+      ctx.config()->channelList()->add(obj); ctx.add(obj, i.index());
     }
   }
   return true;
@@ -202,15 +208,12 @@ bool
 D578UVCodeplug::linkChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Link channel objects
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == (((*data(CHANNEL_BITMAP+byte))>>bit) & 0x01))
-      continue;
+  // Link channel objects of enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    if (ctx.has<Channel>(i))
-      ch.linkChannelObj(ctx.get<Channel>(i), ctx);
+    if (ctx.has<Channel>(i.index()))
+      ch.linkChannelObj(ctx.get<Channel>(i.index()), ctx);
   }
   return true;
 }
@@ -219,20 +222,16 @@ D578UVCodeplug::linkChannels(Context &ctx, const ErrorStack &err) {
 void
 D578UVCodeplug::allocateContacts() {
   /* Allocate contacts */
-  uint8_t *contact_bitmap = data(CONTACTS_BITMAP);
+  Allocator allocator(this);
   unsigned contactCount=0;
-  for (uint16_t i=0; i<NUM_CONTACTS; i++) {
-    // enabled if false (ass hole)
-    if (1 == ((contact_bitmap[i/8]>>(i%8)) & 0x01))
-      continue;
+  // enabled if false (ass hole)
+  for (BitmapIterator i(data(CONTACTS_BITMAP), NUM_CONTACTS, true); i.isValid(); i.next()) {
     contactCount++;
-    uint32_t bank_addr = CONTACT_BLOCK_0 + (i/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
-    uint32_t addr = bank_addr + (i%CONTACTS_PER_BANK)*CONTACT_SIZE;
-    if (nullptr == data(addr, 0)) {
-      image(0).addElement(addr, CONTACT_BANK_SIZE);
-      memset(data(addr), 0x00, CONTACT_BANK_SIZE);
-    }
+    uint32_t bank_addr = CONTACT_BLOCK_0 + (i.index()/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
+    uint32_t addr = bank_addr + (i.index()%CONTACTS_PER_BANK)*CONTACT_SIZE;
+    allocator.add(addr, CONTACT_BANK_SIZE);
   }
+  allocator.flush();
   if (contactCount) {
     image(0).addElement(CONTACT_INDEX_LIST, align_size(4*contactCount, 16));
     memset(data(CONTACT_INDEX_LIST), 0xff, align_size(4*contactCount, 16));
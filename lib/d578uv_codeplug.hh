@@ -245,7 +245,7 @@ public:
   explicit D578UVCodeplug(QObject *parent = nullptr);
 
 protected:
-  void allocateUpdated();
+  void allocateKept();
 
   void allocateHotKeySettings();
 
@@ -38,7 +38,7 @@ class D868UV: public AnytoneRadio
 
 public:
   /** Do not construct this class directly, rather use @c Radio::detect. */
-  explicit D868UV(AnytoneInterface *device=nullptr, QObject *parent=nullptr);
+  explicit D868UV(RadioInterface *device=nullptr, QObject *parent=nullptr);
 
   const RadioLimits &limits() const;
 
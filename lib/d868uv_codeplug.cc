@@ -1,6 +1,7 @@
 #include "d868uv_codeplug.hh"
 #include "config.hh"
 #include "utils.hh"
+#include "bitmapiterator.hh"
 #include "channel.hh"
 #include "gpssystem.hh"
 #include "userdatabase.hh"
@@ -237,81 +238,81 @@ D868UVCodeplug::ChannelElement::ChannelElement(uint8_t *ptr)
 
 bool
 D868UVCodeplug::ChannelElement::ranging() const {
-  return getBit(0x0034, 0);
+  return get<Fields::Ranging>();
 }
 void
 D868UVCodeplug::ChannelElement::enableRanging(bool enable) {
-  setBit(0x0034, 0, enable);
+  set<Fields::Ranging>(enable);
 }
 
 bool
 D868UVCodeplug::ChannelElement::throughMode() const {
-  return getBit(0x0034, 1);
+  return get<Fields::ThroughMode>();
 }
 void
 D868UVCodeplug::ChannelElement::enableThroughMode(bool enable) {
-  setBit(0x0034, 1, enable);
+  set<Fields::ThroughMode>(enable);
 }
 
 bool
 D868UVCodeplug::ChannelElement::dataACK() const {
-  return !getBit(0x0034, 2);
+  return get<Fields::DataACK>();
 }
 void
 D868UVCodeplug::ChannelElement::enableDataACK(bool enable) {
-  setBit(0x0034, 2, !enable);
+  set<Fields::DataACK>(enable);
 }
 
 bool
 D868UVCodeplug::ChannelElement::txDigitalAPRS() const {
-  return getBit(0x0035, 0);
+  return get<Fields::TXDigitalAPRS>();
 }
 void
 D868UVCodeplug::ChannelElement::enableTXDigitalAPRS(bool enable) {
-  setBit(0x0035, 0, enable);
+  set<Fields::TXDigitalAPRS>(enable);
 }
 unsigned
 D868UVCodeplug::ChannelElement::digitalAPRSSystemIndex() const {
-  return getUInt8(0x0036);
+  return get<Fields::DigitalAPRSSystemIndex>();
 }
 void
 D868UVCodeplug::ChannelElement::setDigitalAPRSSystemIndex(unsigned idx) {
-  setUInt8(0x0036, idx);
+  set<Fields::DigitalAPRSSystemIndex>(idx);
 }
 
 unsigned
 D868UVCodeplug::ChannelElement::dmrEncryptionKeyIndex() const {
-  return getUInt8(0x003a);
+  return get<Fields::DMREncryptionKeyIndex>();
 }
 void
 D868UVCodeplug::ChannelElement::setDMREncryptionKeyIndex(unsigned idx) {
-  setUInt8(0x003a, idx);
+  set<Fields::DMREncryptionKeyIndex>(idx);
 }
 
 bool
 D868UVCodeplug::ChannelElement::multipleKeyEncryption() const {
-  return getBit(0x003b, 0);
+  return get<Fields::MultipleKeyEncryption>();
 }
 void
 D868UVCodeplug::ChannelElement::enableMultipleKeyEncryption(bool enable) {
-  setBit(0x003b, 0, enable);
+  set<Fields::MultipleKeyEncryption>(enable);
 }
 
 bool
 D868UVCodeplug::ChannelElement::randomKey() const {
-  return getBit(0x003b, 1);
+  return get<Fields::RandomKey>();
 }
 void
 D868UVCodeplug::ChannelElement::enableRandomKey(bool enable) {
-  setBit(0x003b, 1, enable);
+  set<Fields::RandomKey>(enable);
 }
 bool
 D868UVCodeplug::ChannelElement::sms() const {
-  return !getBit(0x003b, 2);
+  return get<Fields::SMS>();
 }
 void
 D868UVCodeplug::ChannelElement::enableSMS(bool enable) {
-  setBit(0x003b, 0, !enable);
+  set<Fields::SMS>(enable);
 }
 
 Channel *
@@ -642,15 +643,19 @@ D868UVCodeplug::D868UVCodeplug(QObject *parent)
 
 void
 D868UVCodeplug::allocateUpdated() {
-  this->allocateVFOSettings();
-
   // General config
   this->allocateGeneralSettings();
-  this->allocateZoneChannelList();
-  this->allocateDTMFNumbers();
   this->allocateBootSettings();
 
   this->allocateGPSSystems();
+}
+
+void
+D868UVCodeplug::allocateKept() {
+  this->allocateVFOSettings();
+
+  this->allocateZoneChannelList();
+  this->allocateDTMFNumbers();
 
   this->allocateSMSMessages();
   this->allocateHotKeySettings();
@@ -803,22 +808,16 @@ D868UVCodeplug::encodeElements(const Flags &flags, Context &ctx, const ErrorStac
   if (! this->encodeBootSettings(flags, ctx, err))
     return false;
 
-  if (! this->encodeChannels(flags, ctx, err))
-    return false;
-
-  if (! this->encodeContacts(flags, ctx, err))
-    return false;
-
-  if (! this->encodeAnalogContacts(flags, ctx, err))
-    return false;
-
-  if (! this->encodeRXGroupLists(flags, ctx, err))
-    return false;
-
-  if (! this->encodeZones(flags, ctx, err))
-    return false;
-
-  if (! this->encodeScanLists(flags, ctx, err))
+  // These sections are encoded into disjoint memory, possibly concurrently
+  QVector<Section> sections = {
+    [this, &flags, &ctx](const ErrorStack &err) { return this->encodeChannels(flags, ctx, err); },
+    [this, &flags, &ctx](const ErrorStack &err) { return this->encodeContacts(flags, ctx, err); },
+    [this, &flags, &ctx](const ErrorStack &err) { return this->encodeAnalogContacts(flags, ctx, err); },
+    [this, &flags, &ctx](const ErrorStack &err) { return this->encodeRXGroupLists(flags, ctx, err); },
+    [this, &flags, &ctx](const ErrorStack &err) { return this->encodeZones(flags, ctx, err); },
+    [this, &flags, &ctx](const ErrorStack &err) { return this->encodeScanLists(flags, ctx, err); }
+  };
+  if (! this->encodeSections(sections, flags, ctx, err))
     return false;
 
   if (! this->encodeGPSSystems(flags, ctx, err))
@@ -881,21 +880,12 @@ D868UVCodeplug::decodeElements(Context &ctx, const ErrorStack &err)
 
 void
 D868UVCodeplug::allocateChannels() {
-  /* Allocate channels */
-  uint8_t *channel_bitmap = data(CHANNEL_BITMAP);
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Get byte and bit for channel, as well as bank of channel
-    uint16_t bit = i%8, byte = i/8, bank = i/128, idx=i%128;
-    // if disabled -> skip
-    if (0 == ((channel_bitmap[byte]>>bit) & 0x01))
-      continue;
+  /* Allocate channels, consecutive channels within a bank form a single element */
+  Allocator allocator(this);
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
     // compute address for channel
-    uint32_t addr = CHANNEL_BANK_0
-        + bank*CHANNEL_BANK_OFFSET
-        + idx*CHANNEL_SIZE;
-    if (nullptr == data(addr, 0)) {
-      image(0).addElement(addr, CHANNEL_SIZE);
-    }
+    uint16_t bank = i.index()/128, idx = i.index()%128;
+    allocator.add(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE, CHANNEL_SIZE);
   }
 }
 
@@ -907,9 +897,17 @@ D868UVCodeplug::encodeChannels(const Flags &flags, Context &ctx, const ErrorStac
   for (int i=0; i<ctx.config()->channelList()->count(); i++) {
     // enable channel
     uint16_t bank = i/128, idx = i%128;
-    ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    if (! ch.fromChannelObj(ctx.config()->channelList()->channel(i), ctx))
+    uint32_t addr = CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE;
+    Channel *channel = ctx.config()->channelList()->channel(i);
+    ChannelElement ch(data(addr));
+    if (! ch.fromChannelObj(channel, ctx))
       return false;
+    // Remember the element for incremental encoding
+    trackElement(channel, [this, addr, channel](Context &ctx, const ErrorStack &err) {
+      Q_UNUSED(err)
+      ChannelElement ch(data(addr));
+      return ch.fromChannelObj(channel, ctx);
+    });
   }
   return true;
 }
@@ -917,16 +915,12 @@ D868UVCodeplug::encodeChannels(const Flags &flags, Context &ctx, const ErrorStac
 bool
 D868UVCodeplug::createChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
-  // Create channels
-  uint8_t *channel_bitmap = data(CHANNEL_BITMAP);
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == ((channel_bitmap[byte]>>bit) & 0x01))
-      continue;
+  // Create enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
     if (Channel *obj = ch.toChannelObj(ctx)) {
-      ctx.config()->channelList()->add(obj); ctx.add(obj, i);
+      ctx.config()->channelList()->add(obj); ctx.add(obj, i.index());
     }
   }
   return true;
@@ -936,15 +930,12 @@ bool
 D868UVCodeplug::linkChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Link channel objects
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == (((*data(CHANNEL_BITMAP+byte))>>bit) & 0x01))
-      continue;
+  // Link channel objects of enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    if (ctx.has<Channel>(i))
-      ch.linkChannelObj(ctx.get<Channel>(i), ctx);
+    if (ctx.has<Channel>(i.index()))
+      ch.linkChannelObj(ctx.get<Channel>(i.index()), ctx);
   }
   return true;
 }
@@ -961,21 +952,17 @@ D868UVCodeplug::allocateVFOSettings() {
 
 void
 D868UVCodeplug::allocateContacts() {
-  /* Allocate contacts */
-  uint8_t *contact_bitmap = data(CONTACTS_BITMAP);
+  /* Allocate contacts, consecutive blocks within a bank form a single element */
+  Allocator allocator(this);
   unsigned contactCount=0;
-  for (uint16_t i=0; i<NUM_CONTACTS; i++) {
-    // enabled if false (ass hole)
-    if (1 == ((contact_bitmap[i/8]>>(i%8)) & 0x01))
-      continue;
+  // enabled if false (ass hole)
+  for (BitmapIterator i(data(CONTACTS_BITMAP), NUM_CONTACTS, true); i.isValid(); i.next()) {
     contactCount++;
-    uint32_t bank_addr = CONTACT_BLOCK_0 + (i/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
-    uint32_t addr = bank_addr + ((i%CONTACTS_PER_BANK)/CONTACTS_PER_BLOCK)*CONTACT_BLOCK_SIZE;
-    if (nullptr == data(addr, 0)) {
-      image(0).addElement(addr, CONTACT_BLOCK_SIZE);
-      memset(data(addr), 0x00, CONTACT_BLOCK_SIZE);
-    }
+    uint32_t bank_addr = CONTACT_BLOCK_0 + (i.index()/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
+    uint32_t addr = bank_addr + ((i.index()%CONTACTS_PER_BANK)/CONTACTS_PER_BLOCK)*CONTACT_BLOCK_SIZE;
+    allocator.add(addr, CONTACT_BLOCK_SIZE);
   }
+  allocator.flush();
 
   if (contactCount) {
     image(0).addElement(CONTACT_INDEX_LIST, align_size(4*contactCount, 16));
@@ -1018,19 +1005,26 @@ bool
 D868UVCodeplug::createContacts(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Create digital contacts
-  uint8_t *contact_bitmap = data(CONTACTS_BITMAP);
-  for (uint16_t i=0; i<NUM_CONTACTS; i++) {
-    // Check if contact is enabled:
-    uint16_t  bit = i%8, byte = i/8;
-    if (1 == ((contact_bitmap[byte]>>bit) & 0x01))
-      continue;
-    uint32_t bank_addr = CONTACT_BLOCK_0 + (i/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
-    uint32_t addr = bank_addr + (i%CONTACTS_PER_BANK)*CONTACT_SIZE;
-    ContactElement con(data(addr));
-    if (DMRContact *obj = con.toContactObj(ctx)) {
-      ctx.config()->contacts()->add(obj); ctx.add(obj, i);
-    }
+  // Collect enabled digital contacts (enabled if bit is cleared)
+  QVector<unsigned> indices;
+  for (BitmapIterator i(data(CONTACTS_BITMAP), NUM_CONTACTS, true); i.isValid(); i.next())
+    indices.append(i.index());
+
+  // Decode contacts concurrently, only reading the codeplug
+  const D868UVCodeplug *self = this;
+  auto records = decodeRecords<ContactElement::Record>(
+        indices.size(), [self, &indices](unsigned i, ContactElement::Record &record) {
+    unsigned idx = indices.at(i);
+    uint32_t bank_addr = CONTACT_BLOCK_0 + (idx/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
+    uint32_t addr = bank_addr + (idx%CONTACTS_PER_BANK)*CONTACT_SIZE;
+    record = ContactElement(const_cast<uint8_t *>(self->data(addr))).toRecord();
+    return true;
+  });
+
+  // Create contacts in order
+  for (int i=0; i<records.size(); i++) {
+    DMRContact *obj = ContactElement::createContact(records[i].second);
+    ctx.config()->contacts()->add(obj); ctx.add(obj, indices[records[i].first]);
   }
   return true;
 }
@@ -1166,8 +1160,17 @@ D868UVCodeplug::encodeRXGroupLists(const Flags &flags, Context &ctx, const Error
 
   // Encode RX group-lists
   for (int i=0; i<ctx.config()->rxGroupLists()->count(); i++) {
-    GroupListElement grp(data(ADDR_RXGRP_0 + i*RXGRP_OFFSET));
-    grp.fromGroupListObj(ctx.config()->rxGroupLists()->list(i), ctx);
+    uint32_t addr = ADDR_RXGRP_0 + i*RXGRP_OFFSET;
+    RXGroupList *list = ctx.config()->rxGroupLists()->list(i);
+    GroupListElement grp(data(addr));
+    grp.fromGroupListObj(list, ctx);
+    // Remember the element for incremental encoding
+    trackElement(list, [this, addr, list](Context &ctx, const ErrorStack &err) {
+      Q_UNUSED(err)
+      GroupListElement grp(data(addr));
+      grp.fromGroupListObj(list, ctx);
+      return true;
+    });
   }
   return true;
 }
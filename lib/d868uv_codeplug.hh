@@ -198,6 +198,30 @@ public:
    *  @verbinclude d868uv_channel.txt */
   class ChannelElement: public AnytoneCodeplug::ChannelElement
   {
+  public:
+    /** Compile-time layout of the channel element, extends the common AnyTone layout by the
+     * device specific fields. */
+    struct Fields: public AnytoneCodeplug::ChannelElement::Fields {
+      /** Ranging flag. */
+      typedef Layout::Flag<0x0034, 0> Ranging;
+      /** Through mode flag. */
+      typedef Layout::Flag<0x0034, 1> ThroughMode;
+      /** Data ACK flag, cleared if enabled. */
+      typedef Layout::InvertedFlag<0x0034, 2> DataACK;
+      /** TX digital APRS flag. */
+      typedef Layout::Flag<0x0035, 0> TXDigitalAPRS;
+      /** Index of the DMR APRS system. */
+      typedef Layout::UInt8<0x0036> DigitalAPRSSystemIndex;
+      /** DMR encryption key index (+1). */
+      typedef Layout::UInt8<0x003a> DMREncryptionKeyIndex;
+      /** Multiple key encryption flag. */
+      typedef Layout::Flag<0x003b, 0> MultipleKeyEncryption;
+      /** Random key flag. */
+      typedef Layout::Flag<0x003b, 1> RandomKey;
+      /** SMS flag, cleared if enabled. */
+      typedef Layout::InvertedFlag<0x003b, 2> SMS;
+    };
+
   protected:
     /** Hidden constructor. */
     ChannelElement(uint8_t *ptr, unsigned size);
@@ -390,6 +414,7 @@ protected:
   bool allocateBitmaps();
   virtual void setBitmaps(Config *config);
   virtual void allocateUpdated();
+  virtual void allocateKept();
   virtual void allocateForDecoding();
   virtual void allocateForEncoding();
 
@@ -11,7 +11,7 @@
 #define WBSIZE 16
 
 
-D878UV::D878UV(AnytoneInterface *device, QObject *parent)
+D878UV::D878UV(RadioInterface *device, QObject *parent)
   : AnytoneRadio("Anytone AT-D878UV", device, parent), _limits(nullptr)
 {
   _codeplug = new D878UVCodeplug(this);
@@ -20,8 +20,8 @@ D878UV::D878UV(AnytoneInterface *device, QObject *parent)
 
   // Get device info and determine supported TX frequency bands
   AnytoneInterface::RadioVariant info;
-  if (_dev)
-    _dev->getInfo(info);
+  if (AnytoneInterface *anytone = dynamic_cast<AnytoneInterface *>(_dev))
+    anytone->getInfo(info);
 
   switch (info.bands) {
   case 0x00:
@@ -38,7 +38,7 @@ class D878UV: public AnytoneRadio
 
 public:
   /** Do not construct this class directly, rather use @c Radio::detect. */
-  explicit D878UV(AnytoneInterface *device=nullptr, QObject *parent=nullptr);
+  explicit D878UV(RadioInterface *device=nullptr, QObject *parent=nullptr);
 
   const RadioLimits &limits() const;
 
@@ -10,7 +10,7 @@
 #define WBSIZE 16
 
 
-D878UV2::D878UV2(AnytoneInterface *device, QObject *parent)
+D878UV2::D878UV2(RadioInterface *device, QObject *parent)
   : AnytoneRadio("Anytone AT-D878UVII", device, parent), _limits(nullptr)
 {
   _codeplug = new D878UV2Codeplug(this);
@@ -19,8 +19,8 @@ D878UV2::D878UV2(AnytoneInterface *device, QObject *parent)
 
   // Get device info and determine supported TX frequency bands
   AnytoneInterface::RadioVariant info;
-  if (_dev)
-    _dev->getInfo(info);
+  if (AnytoneInterface *anytone = dynamic_cast<AnytoneInterface *>(_dev))
+    anytone->getInfo(info);
 
   switch (info.bands) {
   case 0x00:
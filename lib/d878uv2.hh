@@ -38,7 +38,7 @@ class D878UV2: public AnytoneRadio
 
 public:
   /** Do not construct this class directly, rather use @c Radio::detect. */
-  explicit D878UV2(AnytoneInterface *device=nullptr, QObject *parent=nullptr);
+  explicit D878UV2(RadioInterface *device=nullptr, QObject *parent=nullptr);
 
   const RadioLimits &limits() const;
 
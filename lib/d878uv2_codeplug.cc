@@ -1,6 +1,7 @@
 #include "d878uv2_codeplug.hh"
 #include "config.hh"
 #include "utils.hh"
+#include "bitmapiterator.hh"
 #include "channel.hh"
 #include "gpssystem.hh"
 #include "userdatabase.hh"
@@ -44,21 +45,17 @@ D878UV2Codeplug::D878UV2Codeplug(QObject *parent)
  * be reimplemented. Otherwise, everything remains the same. */
 void
 D878UV2Codeplug::allocateContacts() {
-  /* Allocate contacts */
-  uint8_t *contact_bitmap = data(CONTACTS_BITMAP);
+  /* Allocate contacts, consecutive blocks within a bank form a single element */
+  Allocator allocator(this);
   unsigned contactCount=0;
-  for (uint16_t i=0; i<NUM_CONTACTS; i++) {
-    // enabled if false (ass hole)
-    if (1 == ((contact_bitmap[i/8]>>(i%8)) & 0x01))
-      continue;
+  // enabled if false (ass hole)
+  for (BitmapIterator i(data(CONTACTS_BITMAP), NUM_CONTACTS, true); i.isValid(); i.next()) {
     contactCount++;
-    uint32_t bank_addr = CONTACT_BLOCK_0 + (contactCount/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
-    uint32_t addr = bank_addr + ((i%CONTACTS_PER_BANK)/CONTACTS_PER_BLOCK)*CONTACT_BLOCK_SIZE;
-    if (nullptr == data(addr, 0)) {
-      image(0).addElement(addr, CONTACT_BLOCK_SIZE);
-      memset(data(addr), 0x00, CONTACT_BLOCK_SIZE);
-    }
+    uint32_t bank_addr = CONTACT_BLOCK_0 + (i.index()/CONTACTS_PER_BANK)*CONTACT_BANK_SIZE;
+    uint32_t addr = bank_addr + ((i.index()%CONTACTS_PER_BANK)/CONTACTS_PER_BLOCK)*CONTACT_BLOCK_SIZE;
+    allocator.add(addr, CONTACT_BLOCK_SIZE);
   }
+  allocator.flush();
   if (contactCount) {
     image(0).addElement(CONTACT_INDEX_LIST, align_size(4*contactCount, 16));
     memset(data(CONTACT_INDEX_LIST), 0xff, align_size(4*contactCount, 16));
@@ -1,6 +1,7 @@
 #include "d878uv_codeplug.hh"
 #include "config.hh"
 #include "utils.hh"
+#include "bitmapiterator.hh"
 #include "channel.hh"
 #include "gpssystem.hh"
 #include "userdatabase.hh"
@@ -352,8 +353,8 @@ D878UVCodeplug::RoamingChannelElement::setName(const QString &name) {
 bool
 D878UVCodeplug::RoamingChannelElement::fromChannel(const RoamingChannel* ch) {
   setName(ch->name());
-  setRXFrequency(ch->rxFrequency()*1e6);
-  setTXFrequency(ch->txFrequency()*1e6);
+  setRXFrequency(ch->rxFreq().inHz());
+  setTXFrequency(ch->txFreq().inHz());
   if (ch->colorCodeOverridden())
     setColorCode(ch->colorCode());
   else
@@ -366,8 +367,8 @@ RoamingChannel *
 D878UVCodeplug::RoamingChannelElement::toChannel(Context &ctx) {
   RoamingChannel *roam = new RoamingChannel();
   roam->setName(name());
-  roam->setRXFrequency(rxFrequency()/1e6);
-  roam->setTXFrequency(txFrequency()/1e6);
+  roam->setRXFreq(Frequency::fromHz(rxFrequency()));
+  roam->setTXFreq(Frequency::fromHz(txFrequency()));
   if (hasColorCode())
     roam->setColorCode(colorCode());
   else
@@ -1601,7 +1602,7 @@ D878UVCodeplug::AnalogAPRSSettingsElement::fromAPRSSystem(const APRSSystem *sys,
                 << "No revert channel defined for APRS system '" << sys->name() <<"'.";
     return false;
   }
-  setFrequency(sys->revertChannel()->txFrequency()*1e6);
+  setFrequency(sys->revertChannel()->txFreq().inHz());
   setTXTone(sys->revertChannel()->txTone());
   setPower(sys->revertChannel()->power());
   setManualTXInterval(sys->period());
@@ -1625,13 +1626,13 @@ D878UVCodeplug::AnalogAPRSSettingsElement::toAPRSSystem() {
 bool
 D878UVCodeplug::AnalogAPRSSettingsElement::linkAPRSSystem(APRSSystem *sys, Context &ctx) {
   // First, try to find a matching analog channel in list
-  FMChannel *ch = ctx.config()->channelList()->findFMChannelByTxFreq(frequency()/1e6);
+  FMChannel *ch = ctx.config()->channelList()->findFMChannelByTxFreq(Frequency::fromHz(frequency()));
   if (! ch) {
     // If no channel is found, create one with the settings from APRS channel:
     ch = new FMChannel();
     ch->setName("APRS Channel");
-    ch->setRXFrequency(frequency()/1e6);
-    ch->setTXFrequency(frequency()/1e6);
+    ch->setRXFreq(Frequency::fromHz(frequency()));
+    ch->setTXFreq(Frequency::fromHz(frequency()));
     ch->setPower(power());
     ch->setTXTone(txTone());
     ch->setBandwidth(FMChannel::Bandwidth::Wide);
@@ -2168,9 +2169,9 @@ D878UVCodeplug::allocateBitmaps() {
 }
 
 void
-D878UVCodeplug::allocateUpdated() {
+D878UVCodeplug::allocateKept() {
   // First allocate everything common between D868UV and D878UV codeplugs.
-  D868UVCodeplug::allocateUpdated();
+  D868UVCodeplug::allocateKept();
 
   // Encryption keys
   image(0).addElement(ADDR_ENCRYPTION_KEYS, ENCRYPTION_KEYS_SIZE);
@@ -2250,25 +2251,15 @@ D878UVCodeplug::decodeElements(Context &ctx, const ErrorStack &err)
 
 void
 D878UVCodeplug::allocateChannels() {
-  /* Allocate channels */
-  uint8_t *channel_bitmap = data(CHANNEL_BITMAP);
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Get byte and bit for channel, as well as bank of channel
-    uint16_t bit = i%8, byte = i/8, bank = i/128, idx=i%128;
-    // if disabled -> skip
-    if (0 == ((channel_bitmap[byte]>>bit) & 0x01))
-      continue;
+  /* Allocate channels and their extensions at +0x2000, consecutive channels within a bank form
+   * a single element. */
+  Allocator channels(this), extensions(this);
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
     // compute address for channel
-    uint32_t addr = CHANNEL_BANK_0
-        + bank*CHANNEL_BANK_OFFSET
-        + idx*CHANNEL_SIZE;
-    if (nullptr == data(addr, 0)) {
-      image(0).addElement(addr, CHANNEL_SIZE);
-    }
-    if (nullptr == data(addr+0x2000, 0)) {
-      image(0).addElement(addr+0x2000, CHANNEL_SIZE);
-      memset(data(addr+0x2000), 0x00, CHANNEL_SIZE);
-    }
+    uint16_t bank = i.index()/128, idx = i.index()%128;
+    uint32_t addr = CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE;
+    channels.add(addr, CHANNEL_SIZE);
+    extensions.add(addr+0x2000, CHANNEL_SIZE);
   }
 }
 
@@ -2279,8 +2270,17 @@ D878UVCodeplug::encodeChannels(const Flags &flags, Context &ctx, const ErrorStac
   for (int i=0; i<ctx.config()->channelList()->count(); i++) {
     // enable channel
     uint16_t bank = i/128, idx = i%128;
-    ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    ch.fromChannelObj(ctx.config()->channelList()->channel(i), ctx);
+    uint32_t addr = CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE;
+    Channel *channel = ctx.config()->channelList()->channel(i);
+    ChannelElement ch(data(addr));
+    ch.fromChannelObj(channel, ctx);
+    // Remember the element for incremental encoding
+    trackElement(channel, [this, addr, channel](Context &ctx, const ErrorStack &err) {
+      Q_UNUSED(err)
+      ChannelElement ch(data(addr));
+      ch.fromChannelObj(channel, ctx);
+      return true;
+    });
   }
   return true;
 }
@@ -2289,16 +2289,12 @@ bool
 D878UVCodeplug::createChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Create channels
-  uint8_t *channel_bitmap = data(CHANNEL_BITMAP);
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == ((channel_bitmap[byte]>>bit) & 0x01))
-      continue;
+  // Create enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
     if (Channel *obj = ch.toChannelObj(ctx)) {
-      ctx.config()->channelList()->add(obj); ctx.add(obj, i);
+      ctx.config()->channelList()->add(obj); ctx.add(obj, i.index());
     }
   }
   return true;
@@ -2308,15 +2304,12 @@ bool
 D878UVCodeplug::linkChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Link channel objects
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == (((*data(CHANNEL_BITMAP+byte))>>bit) & 0x01))
-      continue;
+  // Link channel objects of enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    if (ctx.has<Channel>(i))
-      ch.linkChannelObj(ctx.get<Channel>(i), ctx);
+    if (ctx.has<Channel>(i.index()))
+      ch.linkChannelObj(ctx.get<Channel>(i.index()), ctx);
   }
   return true;
 }
@@ -1363,7 +1363,7 @@ protected:
   bool allocateBitmaps();
   void setBitmaps(Config *config);
   void allocateForDecoding();
-  void allocateUpdated();
+  void allocateKept();
   void allocateForEncoding();
 
   bool decodeElements(Context &ctx, const ErrorStack &err=ErrorStack());
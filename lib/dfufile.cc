@@ -628,7 +628,7 @@ DFUFile::Image::sort() {
   // Rebuild address map
   _addressmap.clear();
   for (int i=0; i<_elements.size(); i++)
-    _addressmap.add(_elements[i].address(), _elements.size());
+    _addressmap.add(_elements[i].address(), _elements[i].size());
 }
 
 void
@@ -4,7 +4,7 @@
 #include "d868uv_callsigndb.hh"
 #include "logger.hh"
 
-DMR6X2UV::DMR6X2UV(AnytoneInterface *device, QObject *parent)
+DMR6X2UV::DMR6X2UV(RadioInterface *device, QObject *parent)
   : AnytoneRadio("BTECH DMR-6X2UV", device, parent), _limits(nullptr)
 {
   _codeplug = new DMR6X2UVCodeplug(this);
@@ -13,8 +13,8 @@ DMR6X2UV::DMR6X2UV(AnytoneInterface *device, QObject *parent)
 
   // Get device info and determine supported TX frequency bands
   AnytoneInterface::RadioVariant info;
-  if (_dev)
-    _dev->getInfo(info);
+  if (AnytoneInterface *anytone = dynamic_cast<AnytoneInterface *>(_dev))
+    anytone->getInfo(info);
 
   switch (info.bands) {
   case 0x00:
@@ -24,7 +24,7 @@ class DMR6X2UV: public AnytoneRadio
 
 public:
   /** Do not construct this class directly, rather use @c Radio::detect. */
-  explicit DMR6X2UV(AnytoneInterface *device=nullptr, QObject *parent=nullptr);
+  explicit DMR6X2UV(RadioInterface *device=nullptr, QObject *parent=nullptr);
 
   const RadioLimits &limits() const;
 
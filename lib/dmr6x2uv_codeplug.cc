@@ -1,5 +1,6 @@
 #include "dmr6x2uv_codeplug.hh"
 #include "utils.hh"
+#include "bitmapiterator.hh"
 
 
 #define NUM_CHANNELS              4000
@@ -811,9 +812,17 @@ DMR6X2UVCodeplug::encodeChannels(const Flags &flags, Context &ctx, const ErrorSt
   for (int i=0; i<ctx.config()->channelList()->count(); i++) {
     // enable channel
     uint16_t bank = i/128, idx = i%128;
-    ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    if (! ch.fromChannelObj(ctx.config()->channelList()->channel(i), ctx))
+    uint32_t addr = CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE;
+    Channel *channel = ctx.config()->channelList()->channel(i);
+    ChannelElement ch(data(addr));
+    if (! ch.fromChannelObj(channel, ctx))
       return false;
+    // Remember the element for incremental encoding
+    trackElement(channel, [this, addr, channel](Context &ctx, const ErrorStack &err) {
+      Q_UNUSED(err)
+      ChannelElement ch(data(addr));
+      return ch.fromChannelObj(channel, ctx);
+    });
   }
   return true;
 }
@@ -821,16 +830,12 @@ DMR6X2UVCodeplug::encodeChannels(const Flags &flags, Context &ctx, const ErrorSt
 bool
 DMR6X2UVCodeplug::createChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
-  // Create channels
-  uint8_t *channel_bitmap = data(CHANNEL_BITMAP);
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == ((channel_bitmap[byte]>>bit) & 0x01))
-      continue;
+  // Create enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
     if (Channel *obj = ch.toChannelObj(ctx)) {
-      ctx.config()->channelList()->add(obj); ctx.add(obj, i);
+      ctx.config()->channelList()->add(obj); ctx.add(obj, i.index());
     }
   }
   return true;
@@ -840,15 +845,12 @@ bool
 DMR6X2UVCodeplug::linkChannels(Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
 
-  // Link channel objects
-  for (uint16_t i=0; i<NUM_CHANNELS; i++) {
-    // Check if channel is enabled:
-    uint16_t  bit = i%8, byte = i/8, bank = i/128, idx = i%128;
-    if (0 == (((*data(CHANNEL_BITMAP+byte))>>bit) & 0x01))
-      continue;
+  // Link channel objects of enabled channels
+  for (BitmapIterator i(data(CHANNEL_BITMAP), NUM_CHANNELS); i.isValid(); i.next()) {
+    uint16_t bank = i.index()/128, idx = i.index()%128;
     ChannelElement ch(data(CHANNEL_BANK_0 + bank*CHANNEL_BANK_OFFSET + idx*CHANNEL_SIZE));
-    if (ctx.has<Channel>(i))
-      ch.linkChannelObj(ctx.get<Channel>(i), ctx);
+    if (ctx.has<Channel>(i.index()))
+      ch.linkChannelObj(ctx.get<Channel>(i.index()), ctx);
   }
   return true;
 }
@@ -0,0 +1,147 @@
+#include "encodingcache.hh"
+#include "config.hh"
+#include "config.h"
+#include "logger.hh"
+
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QFile>
+#include <QDir>
+
+
+/* ********************************************************************************************* *
+ * Implementation of EncodingCache
+ * ********************************************************************************************* */
+EncodingCache::EncodingCache(const QString &path, int maxEntries, qint64 maxSize)
+  : _path(path), _maxEntries(maxEntries), _maxSize(maxSize)
+{
+  if (_path.isEmpty())
+    _path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/codeplugs";
+}
+
+const QString &
+EncodingCache::path() const {
+  return _path;
+}
+
+bool
+EncodingCache::hashConfig(Config *config, QByteArray &hash, const ErrorStack &err) {
+  // The YAML serialization is canonical: Elements get labeled by their index and all properties
+  // are written in a fixed order. Hence it does not depend on the source format or file.
+  QByteArray yaml;
+  QTextStream stream(&yaml);
+  if (! config->toYAML(stream, err)) {
+    errMsg(err) << "Cannot serialize configuration.";
+    return false;
+  }
+  stream.flush();
+
+  hash = QCryptographicHash::hash(yaml, QCryptographicHash::Sha256);
+  return true;
+}
+
+QString
+EncodingCache::key(const QByteArray &configHash, const QString &radio, const Codeplug::Flags &flags) {
+  // The concurrent encoding yields the same codeplug, hence it is not part of the key.
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  hash.addData(QByteArray("qdmr ") + VERSION_STRING + "\n");
+  hash.addData(radio.toLower().toUtf8() + "\n");
+  hash.addData(QString("update=%1 gps=%2 roaming=%3\n")
+               .arg(flags.updateCodePlug).arg(flags.autoEnableGPS).arg(flags.autoEnableRoaming)
+               .toLatin1());
+  hash.addData(configHash);
+  return QString::fromLatin1(hash.result().toHex());
+}
+
+bool
+EncodingCache::contains(const QString &key) const {
+  return QFile::exists(filename(key));
+}
+
+bool
+EncodingCache::lookup(const QString &key, const QString &filename, const ErrorStack &err) const {
+  QFile entry(this->filename(key));
+  if (! entry.exists())
+    return false;
+
+  if (QFile::exists(filename) && (! QFile::remove(filename))) {
+    errMsg(err) << "Cannot replace file '" << filename << "'.";
+    return false;
+  }
+  if (! entry.copy(filename)) {
+    errMsg(err) << "Cannot copy cached codeplug '" << entry.fileName() << "' to '" << filename
+                << "': " << entry.errorString() << ".";
+    return false;
+  }
+
+  // Mark entry as recently used
+  if (entry.open(QIODevice::ReadWrite)) {
+    entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    entry.close();
+  }
+
+  logDebug() << "Found cached codeplug '" << entry.fileName() << "'.";
+  return true;
+}
+
+bool
+EncodingCache::store(const QString &key, const QString &filename, const ErrorStack &err) const {
+  QDir directory;
+  if ((! directory.exists(_path)) && (! directory.mkpath(_path))) {
+    errMsg(err) << "Cannot create path '" << _path << "'.";
+    return false;
+  }
+
+  // Copy to a temporary file first, an entry is then either complete or absent
+  QString tmp = this->filename(key) + ".tmp";
+  QFile::remove(tmp);
+  QFile file(filename);
+  if (! file.copy(tmp)) {
+    errMsg(err) << "Cannot copy codeplug '" << filename << "' into cache: "
+                << file.errorString() << ".";
+    return false;
+  }
+  QFile::remove(this->filename(key));
+  if (! QFile::rename(tmp, this->filename(key))) {
+    QFile::remove(tmp);
+    errMsg(err) << "Cannot store cached codeplug '" << this->filename(key) << "'.";
+    return false;
+  }
+
+  logDebug() << "Stored codeplug in cache at '" << this->filename(key) << "'.";
+  return true;
+}
+
+int
+EncodingCache::evict() const {
+  // Most recently used entries first
+  QFileInfoList entries = QDir(_path).entryInfoList(QStringList() << "*.dfu", QDir::Files, QDir::Time);
+
+  int count = 0, deleted = 0;
+  qint64 size = 0;
+  foreach (const QFileInfo &entry, entries) {
+    count++; size += entry.size();
+    if ((count <= _maxEntries) && (size <= _maxSize))
+      continue;
+    if (QFile::remove(entry.absoluteFilePath()))
+      deleted++;
+  }
+
+  if (deleted)
+    logDebug() << "Evicted " << deleted << " codeplugs from cache '" << _path << "'.";
+  return deleted;
+}
+
+void
+EncodingCache::clear() const {
+  foreach (const QFileInfo &entry, QDir(_path).entryInfoList(QStringList() << "*.dfu", QDir::Files))
+    QFile::remove(entry.absoluteFilePath());
+}
+
+QString
+EncodingCache::filename(const QString &key) const {
+  return _path + "/" + key + ".dfu";
+}
@@ -0,0 +1,79 @@
+#ifndef ENCODINGCACHE_HH
+#define ENCODINGCACHE_HH
+
+#include <QString>
+#include <QByteArray>
+
+#include "codeplug.hh"
+#include "errorstack.hh"
+
+class Config;
+
+
+/** Persistent content-addressed cache of encoded binary codeplugs.
+ *
+ * Encoding the same configuration for the same radio with the same flags yields the same codeplug.
+ * Hence the encoded image can be stored under a key derived from all of these inputs and
+ * retrieved instead of being encoded again. The key is the SHA-256 hash of the canonical YAML
+ * serialization of the configuration, the radio key, the encoding flags and the qdmr version.
+ * The latter invalidates all entries whenever the encoder changes.
+ *
+ * Each entry is a single codeplug file within the cache directory, named by its key. Entries are
+ * written to a temporary file first and renamed afterwards. Hence concurrent processes sharing a
+ * cache never see a partial entry. On every hit, the modification time of the entry is updated.
+ * The least recently used entries get evicted by @c evict, once the number of entries or their
+ * total size exceed the configured limits.
+ *
+ * @since 0.11.3
+ * @ingroup conf */
+class EncodingCache
+{
+public:
+  /** Default maximum number of entries. */
+  static const int DefaultMaxEntries = 256;
+  /** Default maximum total size of all entries in bytes. */
+  static const qint64 DefaultMaxSize = 256*1024*1024;
+
+public:
+  /** Constructs a cache at the given directory. If empty, the default cache location of the
+   * application is used. */
+  explicit EncodingCache(const QString &path=QString(), int maxEntries=DefaultMaxEntries,
+                         qint64 maxSize=DefaultMaxSize);
+
+  /** Returns the cache directory. */
+  const QString &path() const;
+
+  /** Computes the hash of the canonical serialization of the given configuration. This hash is
+   * shared by all keys derived for this configuration. */
+  static bool hashConfig(Config *config, QByteArray &hash, const ErrorStack &err=ErrorStack());
+  /** Derives the key of the codeplug encoded from a configuration with the given hash, for the
+   * specified radio and flags. */
+  static QString key(const QByteArray &configHash, const QString &radio, const Codeplug::Flags &flags);
+
+  /** Returns @c true if there is an entry for the given key. */
+  bool contains(const QString &key) const;
+  /** Copies the entry for the given key to the specified file. Returns @c false if there is no
+   * such entry or it cannot be copied. */
+  bool lookup(const QString &key, const QString &filename, const ErrorStack &err=ErrorStack()) const;
+  /** Stores a copy of the given codeplug file as the entry for the given key. */
+  bool store(const QString &key, const QString &filename, const ErrorStack &err=ErrorStack()) const;
+  /** Deletes the least recently used entries until the limits are met. Returns the number of
+   * deleted entries. */
+  int evict() const;
+  /** Deletes all entries. */
+  void clear() const;
+
+protected:
+  /** Returns the file name of the entry with the given key. */
+  QString filename(const QString &key) const;
+
+protected:
+  /** The cache directory. */
+  QString _path;
+  /** The maximum number of entries. */
+  int _maxEntries;
+  /** The maximum total size of all entries. */
+  qint64 _maxSize;
+};
+
+#endif // ENCODINGCACHE_HH
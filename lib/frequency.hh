@@ -0,0 +1,88 @@
+#ifndef FREQUENCY_HH
+#define FREQUENCY_HH
+
+#include <QMetaType>
+#include <QHash>
+#include <QString>
+#include <cmath>
+
+#include "codeplugfield.hh"
+
+/** A frequency in integer Hz.
+ *
+ * Frequencies stored as floating point MHz values cannot be compared exactly and need to be
+ * rounded whenever they get encoded. Storing integer Hz instead makes comparisons and hashing
+ * exact. Hence frequencies can be used as keys of hash tables.
+ *
+ * Most codeplugs store frequencies as 8 BCD digits in units of 10Hz within a 4-byte word. The
+ * conversion from and to these words (see @c fromBCD8 and @c toBCD8) uses the branch-free BCD
+ * helpers of @c CodeplugField. The byte order is handled by the caller, e.g., by the
+ * @c Codeplug::Element accessors.
+ *
+ * @since 0.11.3
+ * @ingroup conf */
+class Frequency
+{
+public:
+  /** Empty constructor, a frequency of 0Hz. */
+  constexpr Frequency() : _hz(0) { }
+
+  /** Constructs a frequency from the given value in Hz. */
+  static constexpr Frequency fromHz(qint64 hz) { return Frequency(hz); }
+  /** Constructs a frequency from the given value in kHz, rounded to Hz. */
+  static inline Frequency fromkHz(double kHz) { return Frequency(std::llround(kHz*1e3)); }
+  /** Constructs a frequency from the given value in MHz, rounded to Hz. */
+  static inline Frequency fromMHz(double MHz) { return Frequency(std::llround(MHz*1e6)); }
+  /** Constructs a frequency from 8 BCD digits in units of 10Hz. */
+  static inline Frequency fromBCD8(uint32_t bcd) { return Frequency(qint64(CodeplugField::fromBCD(bcd))*10); }
+
+  /** Returns @c true if the frequency is 0Hz. */
+  constexpr bool isNull() const { return 0 == _hz; }
+
+  /** Returns the frequency in Hz. */
+  constexpr qint64 inHz() const { return _hz; }
+  /** Returns the frequency in kHz. */
+  constexpr double inkHz() const { return double(_hz)/1e3; }
+  /** Returns the frequency in MHz. */
+  constexpr double inMHz() const { return double(_hz)/1e6; }
+  /** Returns the frequency as 8 BCD digits in units of 10Hz. Digits below 10Hz are truncated. */
+  inline uint32_t toBCD8() const { return CodeplugField::toBCD(uint32_t(_hz/10)); }
+
+  /** Formats the frequency in MHz. */
+  inline QString format() const { return QString::number(inMHz(), 'f', 5); }
+
+  /** Comparison operator. */
+  constexpr bool operator==(const Frequency &other) const { return _hz == other._hz; }
+  /** Comparison operator. */
+  constexpr bool operator!=(const Frequency &other) const { return _hz != other._hz; }
+  /** Comparison operator. */
+  constexpr bool operator<(const Frequency &other) const { return _hz < other._hz; }
+  /** Comparison operator. */
+  constexpr bool operator<=(const Frequency &other) const { return _hz <= other._hz; }
+  /** Comparison operator. */
+  constexpr bool operator>(const Frequency &other) const { return _hz > other._hz; }
+  /** Comparison operator. */
+  constexpr bool operator>=(const Frequency &other) const { return _hz >= other._hz; }
+
+  /** Returns the sum of two frequencies. */
+  constexpr Frequency operator+(const Frequency &other) const { return Frequency(_hz+other._hz); }
+  /** Returns the difference of two frequencies, e.g., the offset of a repeater. */
+  constexpr Frequency operator-(const Frequency &other) const { return Frequency(_hz-other._hz); }
+
+protected:
+  /** Hidden constructor from Hz. */
+  explicit constexpr Frequency(qint64 hz) : _hz(hz) { }
+
+protected:
+  /** The frequency in Hz. */
+  qint64 _hz;
+};
+
+/** Hashes a frequency exactly. */
+inline uint qHash(const Frequency &freq, uint seed=0) {
+  return qHash(freq.inHz(), seed);
+}
+
+Q_DECLARE_METATYPE(Frequency)
+
+#endif // FREQUENCY_HH
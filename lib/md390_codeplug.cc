@@ -278,16 +278,23 @@ MD390Codeplug::encodeContacts(Config *config, const Flags &flags, Context &ctx,
 
 bool
 MD390Codeplug::createContacts(Config *config, Context &ctx, const ErrorStack &err) {
-  for (int i=0; i<NUM_CONTACTS; i++) {
-    ContactElement cont(data(ADDR_CONTACTS+i*CONTACT_SIZE));
+  Q_UNUSED(err)
+
+  // Decode contacts concurrently, only reading the codeplug
+  const MD390Codeplug *self = this;
+  auto records = decodeRecords<ContactElement::Record>(
+        NUM_CONTACTS, [self](unsigned i, ContactElement::Record &record) {
+    ContactElement cont(const_cast<uint8_t *>(self->data(ADDR_CONTACTS+i*CONTACT_SIZE)));
     if (! cont.isValid())
-      continue;
-    if (DMRContact *obj = cont.toContactObj()) {
-      config->contacts()->add(obj); ctx.add(obj, i+1);
-    } else {
-      errMsg(err) << "Invalid contact at index " << i << ".";
       return false;
-    }
+    record = cont.toRecord();
+    return true;
+  });
+
+  // Create contacts in order
+  for (int i=0; i<records.size(); i++) {
+    DMRContact *obj = ContactElement::createContact(records[i].second);
+    config->contacts()->add(obj); ctx.add(obj, records[i].first+1);
   }
   return true;
 }
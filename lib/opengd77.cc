@@ -9,7 +9,7 @@
 RadioLimits *OpenGD77::_limits = nullptr;
 
 OpenGD77::OpenGD77(OpenGD77Interface *device, QObject *parent)
-  : Radio(parent), _name("Open GD-77"), _dev(device), _config(nullptr), _codeplug(), _callsigns()
+  : Radio(parent), _name("Open GD-77"), _dev(device), _config(), _codeplug(), _callsigns()
 {
   // pass...
 }
@@ -91,7 +91,9 @@ OpenGD77::startUpload(Config *config, bool blocking, const Codeplug::Flags &flag
     return false;
   }
 
-  if (! (_config = config)) {
+  // Encode from a frozen copy, the config may still be edited while uploading.
+  _config = QSharedPointer<Config>((config ? config->freeze(err) : nullptr), &QObject::deleteLater);
+  if (_config.isNull()) {
     logError() << "Cannot upload to radio, no config given.";
     return false;
   }
@@ -165,7 +167,7 @@ OpenGD77::run() {
     _dev->close();
     _task = StatusIdle;
     emit downloadFinished(this, &_codeplug);
-    _config = nullptr;
+    _config.reset();
   } else if (StatusUpload == _task) {
     if ((nullptr==_dev) || (! _dev->isOpen())) {
       emit uploadError(this);
@@ -305,7 +307,7 @@ OpenGD77::upload()
   }
 
   // Encode config into codeplug
-  _codeplug.encode(_config);
+  _codeplug.encode(_config.data());
 
   if (! _dev->write_start(0,0, _errorStack)) {
     errMsg(_errorStack) << "Cannot start codeplug upload.";
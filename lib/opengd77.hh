@@ -5,6 +5,7 @@
 #ifndef OPENGD77_HH
 #define OPENGD77_HH
 
+#include <QSharedPointer>
 #include "radio.hh"
 #include "opengd77_interface.hh"
 #include "opengd77_codeplug.hh"
@@ -60,7 +61,7 @@ protected:
   /** The interface to the radio. */
   OpenGD77Interface *_dev;
   /** The generic configuration. */
-	Config *_config;
+	QSharedPointer<Config> _config;
   /** The actual binary codeplug representation. */
   OpenGD77Codeplug _codeplug;
   /** The actual binary callsign DB representation. */
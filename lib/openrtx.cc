@@ -8,7 +8,7 @@
 #define BSIZE 32
 
 OpenRTX::OpenRTX(OpenRTXInterface *device, QObject *parent)
-  : Radio(parent), _name("Open RTX"), _dev(device), _config(nullptr), _codeplug()
+  : Radio(parent), _name("Open RTX"), _dev(device), _config(), _codeplug()
 {
   if (! connect())
     return;
@@ -84,7 +84,9 @@ OpenRTX::startUpload(Config *config, bool blocking, const Codeplug::Flags &flags
     return false;
   }
 
-  if (! (_config = config)) {
+  // Encode from a frozen copy, the config may still be edited while uploading.
+  _config = QSharedPointer<Config>((config ? config->freeze(err) : nullptr), &QObject::deleteLater);
+  if (_config.isNull()) {
     errMsg(err) << "Cannot upload to radio, no config given.";
     return false;
   }
@@ -136,7 +138,7 @@ OpenRTX::run() {
     _dev->close();
     _task = StatusIdle;
     emit downloadFinished(this, &_codeplug);
-    _config = nullptr;
+    _config.reset();
   } else if (StatusUpload == _task) {
     if (! connect()) {
       emit uploadError(this);
@@ -281,7 +283,7 @@ OpenRTX::upload(const ErrorStack &err)
   }
 
   // Encode config into codeplug
-  _codeplug.encode(_config, Codeplug::Flags(), err);
+  _codeplug.encode(_config.data(), Codeplug::Flags(), err);
 
   if (! _dev->write_start(0,0, err)) {
     errMsg(err) << "Cannot start codeplug upload.";
@@ -5,6 +5,7 @@
 #ifndef OPENGRTX_HH
 #define OPENGRTX_HH
 
+#include <QSharedPointer>
 #include "radio.hh"
 //#include "openrtx_interface.hh"
 #include "openrtx_codeplug.hh"
@@ -62,7 +63,7 @@ protected:
   /** The interface to the radio. */
   OpenRTXInterface *_dev;
   /** The generic configuration. */
-	Config *_config;
+	QSharedPointer<Config> _config;
   /** The actual binary codeplug representation. */
   OpenRTXCodeplug _codeplug;
 };
@@ -203,7 +203,7 @@ OpenRTXCodeplug::ChannelElement::rxFrequency() const {
 
 void
 OpenRTXCodeplug::ChannelElement::setRXFrequency(double MHz) {
-  setUInt32_le(OffsetRXFrequency, (uint32_t)(MHz*1e6));
+  setUInt32_le(OffsetRXFrequency, uint32_t(Frequency::fromMHz(MHz).inHz()));
 }
 
 double
@@ -213,7 +213,7 @@ OpenRTXCodeplug::ChannelElement::txFrequency() const {
 
 void
 OpenRTXCodeplug::ChannelElement::setTXFrequency(double MHz) {
-  setUInt32_le(OffsetTXFrequency, (uint32_t)(MHz*1e6));
+  setUInt32_le(OffsetTXFrequency, uint32_t(Frequency::fromMHz(MHz).inHz()));
 }
 
 
@@ -1016,6 +1016,8 @@ OpenRTXCodeplug::encodeElements(const Flags &flags, Context &ctx, const ErrorSta
 
 bool
 OpenRTXCodeplug::decode(Config *config, const ErrorStack &err) {
+  // Notify about changes once decoding is complete
+  Config::Transaction transaction(config);
   // Clear config object
   config->clear();
 
@@ -18,6 +18,7 @@
 #include "dmr6x2uv.hh"
 
 #include "config.hh"
+#include "radiolimits.hh"
 #include "logger.hh"
 
 #include <QSet>
@@ -27,7 +28,7 @@
  * Implementation of Radio
  * ******************************************************************************************** */
 Radio::Radio(QObject *parent)
-  : QThread(parent), _task(StatusIdle)
+  : QThread(parent), _task(StatusIdle), _resume(false)
 {
   // pass...
 }
@@ -36,6 +37,22 @@ Radio::~Radio() {
   // pass...
 }
 
+RadioLimits *
+Radio::takeLimits(QObject *owner) {
+  // Some radios share static limits among all instances
+  if (this != limits().parent())
+    return nullptr;
+  // Otherwise, the limits are created by the radio itself as one of its children
+  RadioLimits *limits = const_cast<RadioLimits *>(&this->limits());
+  limits->setParent(owner);
+  return limits;
+}
+
+QString
+Radio::variant() const {
+  return QString();
+}
+
 const CallsignDB *
 Radio::callsignDB() const {
   return nullptr;
@@ -152,3 +169,13 @@ const ErrorStack &
 Radio::errorStack() const {
   return _errorStack;
 }
+
+bool
+Radio::resume() const {
+  return _resume;
+}
+
+void
+Radio::setResume(bool enable) {
+  _resume = enable;
+}
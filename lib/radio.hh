@@ -57,6 +57,18 @@ public:
    *
    * @since Version 0.10.2 */
   virtual const RadioLimits &limits() const = 0;
+  /** Passes the ownership of the limits to the given object. Hence the limits outlive the radio,
+   * e.g., to keep verifying a configuration once the connection to the radio was closed. The new
+   * owner must not delete the limits while the radio exists. Returns @c nullptr if the limits are
+   * not owned by this instance, i.e., if they are shared by all radios of the same model and
+   * therefore outlive the radio anyway.
+   * @since 0.11.3 */
+  RadioLimits *takeLimits(QObject *owner);
+  /** Returns an identifier of the hardware variant of the radio, e.g., its frequency bands and
+   * hardware revision. Radios with the same name and variant have the same limits. The default
+   * implementation returns an empty string.
+   * @since 0.11.3 */
+  virtual QString variant() const;
 
   /** Returns the codeplug instance. */
   virtual const Codeplug &codeplug() const = 0;
@@ -75,6 +87,12 @@ public:
    * @c startUploadCallsignDB. It contains the error messages from the upload/download process. */
   const ErrorStack &errorStack() const;
 
+  /** Returns @c true if interrupted transfers get resumed from their last checkpoint. */
+  bool resume() const;
+  /** If enabled, an interrupted transfer gets resumed from the last checkpoint recorded for this
+   * radio, if the device supports it. See @c TransferCheckpoint. */
+  void setResume(bool enable);
+
 public:
   /** Tries to detect the radio connected to the specified interface or constructs the specified
    * radio using the @c RadioInfo passed by @c force. */
@@ -121,6 +139,8 @@ protected:
   Status _task;
   /** The error stack. */
   ErrorStack _errorStack;
+  /** If @c true, interrupted transfers get resumed. */
+  bool _resume;
 };
 
 #endif // RADIO_HH
@@ -372,8 +372,8 @@ RadioddityCodeplug::ChannelElement::toChannelObj(Codeplug::Context &ctx) const {
 
   // Apply common settings
   ch->setName(name());
-  ch->setRXFrequency(double(rxFrequency())/1e6);
-  ch->setTXFrequency(double(txFrequency())/1e6);
+  ch->setRXFreq(Frequency::fromHz(rxFrequency()));
+  ch->setTXFreq(Frequency::fromHz(txFrequency()));
   ch->setPower(power());
   ch->setTimeout(txTimeOut());
   ch->setRXOnly(rxOnly());
@@ -407,8 +407,8 @@ RadioddityCodeplug::ChannelElement::fromChannelObj(const Channel *c, Context &ct
   clear();
 
   setName(c->name());
-  setRXFrequency(c->rxFrequency()*1e6);
-  setTXFrequency(c->txFrequency()*1e6);
+  setRXFrequency(c->rxFreq().inHz());
+  setTXFrequency(c->txFreq().inHz());
   if (c->defaultPower())
     setPower(ctx.config()->settings()->power());
   else
@@ -677,12 +677,27 @@ RadioddityCodeplug::ContactElement::setRingStyle(unsigned style) {
   setUInt8(0x0016, style);
 }
 
+RadioddityCodeplug::ContactElement::Record
+RadioddityCodeplug::ContactElement::toRecord() const {
+  Record record;
+  record.type = type();
+  record.name = name();
+  record.number = number();
+  record.ring = ring();
+  return record;
+}
+
+DMRContact *
+RadioddityCodeplug::ContactElement::createContact(const Record &record) {
+  return new DMRContact(record.type, record.name, record.number, record.ring);
+}
+
 DMRContact *
 RadioddityCodeplug::ContactElement::toContactObj(Context &ctx) const {
   Q_UNUSED(ctx)
   if (! isValid())
     return nullptr;
-  return new DMRContact(type(), name(), number(), ring());
+  return createContact(toRecord());
 }
 
 void
@@ -2690,41 +2705,53 @@ RadioddityCodeplug::encodeElements(const Flags &flags, Context &ctx, const Error
     return false;
   }
 
-  // Define Contacts
-  if (! this->encodeContacts(ctx.config(), flags, ctx, err)) {
-    errMsg(err) << "Cannot encode contacts.";
-    return false;
-  }
-
-  if (! this->encodeDTMFContacts(ctx.config(), flags, ctx, err)) {
-    errMsg(err) << "Cannot encode DTMF contacts.";
-    return false;
-  }
-
-  if (! this->encodeChannels(ctx.config(), flags, ctx, err)) {
-    errMsg(err) << "Cannot encode channels";
-    return false;
-  }
-
   if (! this->encodeBootText(ctx.config(), flags, ctx, err)) {
     errMsg(err) << "Cannot encode boot text.";
     return false;
   }
 
-  if (! this->encodeZones(ctx.config(), flags, ctx, err)) {
-    errMsg(err) << "Cannot encode zones.";
-    return false;
-  }
-
-  if (! this->encodeScanLists(ctx.config(), flags, ctx, err)) {
-    errMsg(err) << "Cannot encode scan lists.";
-    return false;
-  }
-
-  if (! this->encodeGroupLists(ctx.config(), flags, ctx, err)) {
-    errMsg(err) << "Cannot encode group lists.";
+  // Contacts, channels, zones, scan lists and group lists are encoded into disjoint memory,
+  // possibly concurrently.
+  QVector<Section> sections = {
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeContacts(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode contacts.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeDTMFContacts(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode DTMF contacts.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeChannels(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode channels";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeZones(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode zones.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeScanLists(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode scan lists.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeGroupLists(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode group lists.";
+      return false;
+    }
+  };
+  if (! this->encodeSections(sections, flags, ctx, err))
     return false;
-  }
 
   if (! this->encodeEncryption(ctx.config(), flags, ctx, err)) {
     errMsg(err) << "Cannot encode encryption keys.";
@@ -2736,6 +2763,8 @@ RadioddityCodeplug::encodeElements(const Flags &flags, Context &ctx, const Error
 
 bool
 RadioddityCodeplug::decode(Config *config, const ErrorStack &err) {
+  // Notify about changes once decoding is complete
+  Config::Transaction transaction(config);
   // Clear config object
   config->clear();
 
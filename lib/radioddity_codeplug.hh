@@ -348,6 +348,26 @@ public:
     /** Sets the ring tone style for this contact [0-10]. */
     virtual void setRingStyle(unsigned style);
 
+    /** The decoded settings of a contact. */
+    struct Record {
+      /** The call type. */
+      DMRContact::Type type;
+      /** The name of the contact. */
+      QString name;
+      /** The contact number. */
+      unsigned number;
+      /** If @c true, the ring tone is enabled. */
+      bool ring;
+    };
+
+    /** Decodes this contact into a record. No objects are created, hence several contacts may be
+     * decoded concurrently.
+     * @since 0.11.3 */
+    virtual Record toRecord() const;
+    /** Constructs a @c DigitalContact instance from a decoded contact.
+     * @since 0.11.3 */
+    static DMRContact *createContact(const Record &record);
+
     /** Constructs a @c DigitalContact instance from this codeplug contact. */
     virtual DMRContact *toContactObj(Context &ctx) const;
     /** Resets this codeplug contact from the given @c DigitalContact. */
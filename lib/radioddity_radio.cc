@@ -7,7 +7,7 @@
 
 
 RadioddityRadio::RadioddityRadio(RadioddityInterface *device, QObject *parent)
-  : Radio(parent), _dev(device), _codeplugFlags(), _config(nullptr)
+  : Radio(parent), _dev(device), _codeplugFlags(), _config()
 {
   // pass...
 }
@@ -46,7 +46,9 @@ RadioddityRadio::startUpload(Config *config, bool blocking, const Codeplug::Flag
   if (StatusIdle != _task)
     return false;
 
-  if (! (_config = config))
+  // Encode from a frozen copy, the config may still be edited while uploading.
+  _config = QSharedPointer<Config>((config ? config->freeze(err) : nullptr), &QObject::deleteLater);
+  if (_config.isNull())
     return false;
 
   _task = StatusUpload;
@@ -93,7 +95,7 @@ RadioddityRadio::run() {
     _dev->reboot();
     _dev->close();
     emit downloadFinished(this, &codeplug());
-    _config = nullptr;
+    _config.reset();
   } else if (StatusUpload == _task) {
     if ((nullptr==_dev) || (! _dev->isOpen())) {
       emit uploadError(this);
@@ -196,7 +198,7 @@ RadioddityRadio::upload() {
   }
 
   // Encode config into codeplug
-  if (! codeplug().encode(_config, _codeplugFlags, _errorStack)) {
+  if (! codeplug().encode(_config.data(), _codeplugFlags, _errorStack)) {
     errMsg(_errorStack) << "Codeplug upload failed.";
     return false;
   }
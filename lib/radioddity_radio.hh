@@ -5,6 +5,7 @@
 #ifndef RADIODDITY_RADIO_HH
 #define RADIODDITY_RADIO_HH
 
+#include <QSharedPointer>
 #include "radio.hh"
 #include "radioddity_interface.hh"
 
@@ -47,7 +48,7 @@ protected:
   /** Holds the flags to control assembly and upload of code-plugs. */
   Codeplug::Flags _codeplugFlags;
   /** The generic configuration. */
-	Config *_config;
+	QSharedPointer<Config> _config;
   /** A weak reference to the user-database. */
   UserDatabase *_userDB;
 };
@@ -1,6 +1,7 @@
 #include "radioid.hh"
 #include "logger.hh"
 #include "utils.hh"
+#include <QMutex>
 
 
 /* ********************************************************************************************* *
@@ -112,6 +113,9 @@ DefaultRadioID::DefaultRadioID(QObject *parent)
 
 DefaultRadioID *
 DefaultRadioID::get() {
+  // Encoders running concurrently may request the instance at the same time.
+  static QMutex mutex;
+  QMutexLocker locker(&mutex);
   if (nullptr == _instance)
     _instance = new DefaultRadioID();
   return _instance;
@@ -220,7 +224,7 @@ RadioIDList::setDefaultId(int idx) {
   if (_default) {
     disconnect(_default, SIGNAL(destroyed(QObject*)), this, SLOT(onDefaultIdDeleted()));
     if (0 <= indexOf(_default))
-      emit elementModified(indexOf(_default));
+      notifyModified(indexOf(_default));
   }
 
   if (0 > idx) {
@@ -232,7 +236,7 @@ RadioIDList::setDefaultId(int idx) {
   if (nullptr == _default)
     return false;
   connect(_default, SIGNAL(destroyed(QObject*)), this, SLOT(onDefaultIdDeleted()));
-  emit elementModified(idx);
+  notifyModified(idx);
   return true;
 }
 
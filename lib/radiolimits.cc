@@ -3,6 +3,8 @@
 #include "logger.hh"
 #include "config.hh"
 #include <QMetaProperty>
+#include <QThreadPool>
+#include <QRunnable>
 #include <ctype.h>
 
 // Utility function to check string content for ASCII encoding
@@ -81,7 +83,7 @@ RadioLimitContext::RadioLimitContext(bool ignoreFrequencyLimits)
 
 RadioLimitIssue &
 RadioLimitContext::newMessage(RadioLimitIssue::Severity severity) {
-  _messages.push_back(RadioLimitIssue(severity, _stack));
+  _messages.push_back(RadioLimitIssue(severity, formatStack()));
   if (severity > _maxSeverity)
     _maxSeverity = severity;
   return _messages.back();
@@ -97,9 +99,38 @@ RadioLimitContext::message(int n) const {
   return _messages.at(n);
 }
 
+RadioLimitContext
+RadioLimitContext::branch() const {
+  RadioLimitContext context(_ignoreFrequencyLimits);
+  context._stack = _stack;
+  return context;
+}
+
+void
+RadioLimitContext::merge(const RadioLimitContext &branch) {
+  _messages.append(branch._messages);
+  if (branch._maxSeverity > _maxSeverity)
+    _maxSeverity = branch._maxSeverity;
+}
+
 void
 RadioLimitContext::push(const QString &element) {
-  _stack.append(element);
+  _stack.append(Frame{Frame::Type::Text, element, nullptr, 0, nullptr});
+}
+
+void
+RadioLimitContext::pushProperty(const char *name) {
+  _stack.append(Frame{Frame::Type::Property, QString(), name, 0, nullptr});
+}
+
+void
+RadioLimitContext::pushList(const char *name) {
+  _stack.append(Frame{Frame::Type::List, QString(), name, 0, nullptr});
+}
+
+void
+RadioLimitContext::pushElement(int index, const ConfigObject *obj) {
+  _stack.append(Frame{Frame::Type::Element, QString(), nullptr, index, obj});
 }
 
 void
@@ -121,6 +152,22 @@ RadioLimitContext::maxSeverity() const {
   return _maxSeverity;
 }
 
+QStringList
+RadioLimitContext::formatStack() const {
+  QStringList stack;
+  foreach (const Frame &frame, _stack) {
+    switch (frame.type) {
+    case Frame::Type::Text: stack.append(frame.text); break;
+    case Frame::Type::Property: stack.append(QString("Property '%1'").arg(frame.name)); break;
+    case Frame::Type::List: stack.append(QString("List '%1'").arg(frame.name)); break;
+    case Frame::Type::Element:
+      stack.append(QString("Element %1 ('%2')").arg(frame.index).arg(frame.object->name()));
+      break;
+    }
+  }
+  return stack;
+}
+
 
 /* ********************************************************************************************* *
  * Implementation of RadioLimitElement
@@ -517,9 +564,17 @@ RadioLimitItem::add(const QString &prop, RadioLimitElement *structure) {
     return false;
   _elements.insert(prop, structure);
   structure->setParent(this);
+  // Invalidate plans
+  QWriteLocker locker(&_planLock);
+  _plans.clear();
   return true;
 }
 
+const RadioLimitElement *
+RadioLimitItem::element(const QString &prop) const {
+  return _elements.value(prop, nullptr);
+}
+
 bool
 RadioLimitItem::verify(const ConfigItem *item, const QMetaProperty &prop, RadioLimitContext &context) const {
   if (! prop.isReadable()) {
@@ -537,7 +592,7 @@ RadioLimitItem::verify(const ConfigItem *item, const QMetaProperty &prop, RadioL
   if (prop.read(item).isNull())
     return true;
 
-  context.push(QString("Property '%1'").arg(prop.name()));
+  context.pushProperty(prop.name());
   bool success = verifyItem(prop.read(item).value<ConfigItem*>(), context);
   context.pop();
   return success;
@@ -545,21 +600,37 @@ RadioLimitItem::verify(const ConfigItem *item, const QMetaProperty &prop, RadioL
 
 bool
 RadioLimitItem::verifyItem(const ConfigItem *item, RadioLimitContext &context) const {
-  const QMetaObject *meta = item->metaObject();
+  Plan steps = plan(item->metaObject());
+  for (int i=0; i<steps.size(); i++) {
+    if (! steps.at(i).second->verify(item, steps.at(i).first, context))
+      return false;
+  }
+
+  return true;
+}
+
+RadioLimitItem::Plan
+RadioLimitItem::plan(const QMetaObject *meta) const {
+  {
+    QReadLocker locker(&_planLock);
+    if (_plans.contains(meta))
+      return _plans.value(meta);
+  }
+
+  Plan plan;
   for (int p=QObject::staticMetaObject.propertyCount(); p<meta->propertyCount(); p++) {
     // This property
     QMetaProperty prop = meta->property(p);
     // Should never happen
     if (! prop.isValid())
       continue;
-    // Verify property
-    if (_elements.contains(prop.name())) {
-      if (! _elements[prop.name()]->verify(item, prop, context))
-        return false;
-    }
+    if (RadioLimitElement *limits = _elements.value(prop.name(), nullptr))
+      plan.append(QPair<QMetaProperty, RadioLimitElement *>(prop, limits));
   }
 
-  return true;
+  QWriteLocker locker(&_planLock);
+  _plans.insert(meta, plan);
+  return plan;
 }
 
 
@@ -601,13 +672,25 @@ RadioLimitObjects::RadioLimitObjects(const TypeList &list, QObject *parent)
 
 bool
 RadioLimitObjects::verifyItem(const ConfigItem *item, RadioLimitContext &context) const {
-  if (! _types.contains(item->metaObject()->className())) {
+  const QMetaObject *meta = item->metaObject();
+  RadioLimitObject *limits = nullptr;
+  {
+    QReadLocker locker(&_planLock);
+    limits = _dispatch.value(meta, nullptr);
+  }
+
+  if ((nullptr == limits) && (limits = _types.value(meta->className(), nullptr))) {
+    QWriteLocker locker(&_planLock);
+    _dispatch.insert(meta, limits);
+  }
+
+  if (nullptr == limits) {
     auto &msg = context.newMessage(RadioLimitIssue::Critical);
-    msg << "Cannot check item of type " << item->metaObject()->className()
+    msg << "Cannot check item of type " << meta->className()
         << ". Unexpected type. Expected one of " << QStringList(_types.keys()).join(", ") << ".";
     return false;
   }
-  return _types[item->metaObject()->className()]->verifyItem(item, context);
+  return limits->verifyItem(item, context);
 }
 
 
@@ -725,34 +808,51 @@ RadioLimitList::verify(const ConfigItem *item, const QMetaProperty &prop, RadioL
 
   const ConfigObjectList *plist = prop.read(item).value<ConfigObjectList*>();
 
-  QHash<QString, unsigned> counts;
-  foreach (QString type, _elements.keys())
-    counts.insert(type,0);
-
-  context.push(QString("List '%1'").arg(prop.name()));
+  context.pushList(prop.name());
 
   // Check type and structure
   for (int i=0; i<plist->count(); i++) {
-    // Check type
-    ConfigObject *obj = plist->get(i);
-    QString className = findClassName(*(obj->metaObject()));
-    if (className.isEmpty()) {
-      auto &msg = context.newMessage(RadioLimitIssue::Critical);
-      msg << "Unexpected element type '" << obj->metaObject()->className()
-          << "'. Expected one of " << _elements.keys().join(", ") << ".";
+    if (! verifyElement(i, plist->get(i), context)) {
       context.pop();
       return false;
     }
+  }
 
-    counts[className]++;
+  verifyCounts(plist, context);
 
-    context.push(QString("Element %1 ('%2')").arg(i).arg(obj->name()));
-    if (! _elements[className]->verifyObject(obj, context)) {
-      context.pop();
-      context.pop();
-      return false;
-    }
-    context.pop();
+  context.pop();
+
+  return true;
+}
+
+bool
+RadioLimitList::verifyElement(int index, const ConfigObject *obj, RadioLimitContext &context) const {
+  // Check type
+  QString className = findClassName(*(obj->metaObject()));
+  if (className.isEmpty()) {
+    auto &msg = context.newMessage(RadioLimitIssue::Critical);
+    msg << "Unexpected element type '" << obj->metaObject()->className()
+        << "'. Expected one of " << _elements.keys().join(", ") << ".";
+    return false;
+  }
+
+  // Check structure
+  context.pushElement(index, obj);
+  bool success = _elements[className]->verifyObject(obj, context);
+  context.pop();
+  return success;
+}
+
+void
+RadioLimitList::verifyCounts(const ConfigObjectList *plist, RadioLimitContext &context) const {
+  QHash<QString, unsigned> counts;
+  foreach (QString type, _elements.keys())
+    counts.insert(type,0);
+
+  for (int i=0; i<plist->count(); i++) {
+    QString className = findClassName(*(plist->get(i)->metaObject()));
+    if (! className.isEmpty())
+      counts[className]++;
   }
 
   // Check counts
@@ -768,19 +868,25 @@ RadioLimitList::verify(const ConfigItem *item, const QMetaProperty &prop, RadioL
              << " is greater than the maximum count " << _maxCount[className] << ".";
     }
   }
-
-  context.pop();
-
-  return true;
 }
 
 QString
 RadioLimitList::findClassName(const QMetaObject &type) const {
-  if (_elements.contains(type.className()))
-    return type.className();
-  if (const QMetaObject *super = type.superClass())
-    return findClassName(*super);
-  return "";
+  {
+    QReadLocker locker(&_classNameLock);
+    if (_classNames.contains(&type))
+      return _classNames.value(&type);
+  }
+
+  QString className;
+  for (const QMetaObject *meta=&type; meta && className.isEmpty(); meta=meta->superClass()) {
+    if (_elements.contains(meta->className()))
+      className = meta->className();
+  }
+
+  QWriteLocker locker(&_classNameLock);
+  _classNames.insert(&type, className);
+  return className;
 }
 
 
@@ -927,6 +1033,37 @@ RadioLimitSingleZone::verifyItem(const ConfigItem *item, RadioLimitContext &cont
 }
 
 
+/** Verifies a single property of an item on a worker thread.
+ * @ingroup limits */
+class RadioLimitTask: public QRunnable
+{
+public:
+  /** Constructor. */
+  RadioLimitTask(const RadioLimitElement *limits, const ConfigItem *item, const QMetaProperty &prop,
+                 RadioLimitContext &context, char &success)
+    : QRunnable(), _limits(limits), _item(item), _prop(prop), _context(context), _success(success)
+  {
+    // pass...
+  }
+
+  void run() {
+    _success = _limits->verify(_item, _prop, _context);
+  }
+
+protected:
+  /** The limits of the property. */
+  const RadioLimitElement *_limits;
+  /** The item to verify. */
+  const ConfigItem *_item;
+  /** The property to verify. */
+  QMetaProperty _prop;
+  /** The branch of the context, collecting the issues. */
+  RadioLimitContext &_context;
+  /** The result of the verification. */
+  char &_success;
+};
+
+
 /* ********************************************************************************************* *
  * Implementation of RadioLimits
  * ********************************************************************************************* */
@@ -959,11 +1096,39 @@ RadioLimits::numCallSignDBEntries() const {
 
 bool
 RadioLimits::verifyConfig(const Config *config, RadioLimitContext &context) const {
+  verifyRadio(context);
+  return verifyItem(config, context);
+}
+
+void
+RadioLimits::verifyRadio(RadioLimitContext &context) const {
   if (_betaWarning) {
     auto &msg = context.newMessage(RadioLimitIssue::Warning);
     msg = tr("The support for this radio is still under development. Some features may sill be "
              "missing or are not well tested.");
   }
+}
 
-  return verifyItem(config, context);
+bool
+RadioLimits::verifyItem(const ConfigItem *item, RadioLimitContext &context) const {
+  Plan steps = plan(item->metaObject());
+  if (2 > steps.size())
+    return RadioLimitItem::verifyItem(item, context);
+
+  // Verify each property in its own branch of the context
+  QVector<RadioLimitContext> branches(steps.size(), context.branch());
+  QVector<char> success(steps.size(), 0);
+  QThreadPool pool;
+  for (int i=0; i<steps.size(); i++)
+    pool.start(new RadioLimitTask(steps.at(i).second, item, steps.at(i).first, branches[i], success[i]));
+  pool.waitForDone();
+
+  // Merge issues in order, stop at the first failed property like a sequential verification
+  for (int i=0; i<steps.size(); i++) {
+    context.merge(branches.at(i));
+    if (! success.at(i))
+      return false;
+  }
+
+  return true;
 }
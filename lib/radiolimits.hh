@@ -32,12 +32,17 @@
 #include <QObject>
 #include <QTextStream>
 #include <QMetaType>
+#include <QMetaProperty>
+#include <QReadWriteLock>
 #include <QSet>
+#include <QVector>
+#include <QPair>
 
 // Forward declaration
 class Config;
 class ConfigItem;
 class ConfigObject;
+class ConfigObjectList;
 class RadioLimits;
 
 
@@ -101,9 +106,22 @@ public:
   /** Returns the n-th issue. */
   const RadioLimitIssue &message(int n) const;
 
+  /** Returns an empty context with the same settings and item stack. Allows to verify parts of a
+   * configuration independently. The issues are collected later using @c merge. */
+  RadioLimitContext branch() const;
+  /** Appends all issues of the given branch. */
+  void merge(const RadioLimitContext &branch);
+
   /** Push a property name/element index onto the stack.
    * This method is used to track the origin of an issue. */
   void push(const QString &element);
+  /** Pushes a property onto the stack. The name must remain valid, e.g., the name of a
+   * @c QMetaProperty. Like all other levels, it gets only formatted if an issue is raised. */
+  void pushProperty(const char *name);
+  /** Pushes a list property onto the stack. */
+  void pushList(const char *name);
+  /** Pushes a list element onto the stack. */
+  void pushElement(int index, const ConfigObject *obj);
   /** Pops the top-most property name/element index from the stack. */
   void pop();
 
@@ -116,8 +134,30 @@ public:
   RadioLimitIssue::Severity maxSeverity() const;
 
 protected:
+  /** Formats the current item stack. */
+  QStringList formatStack() const;
+
+protected:
+  /** A single level of the item stack. */
+  struct Frame {
+    /** Possible levels. */
+    enum class Type {
+      Text, Property, List, Element
+    };
+    /** The type of the level. */
+    Type type;
+    /** The preformatted text of @c Type::Text levels. */
+    QString text;
+    /** The property name of @c Type::Property and @c Type::List levels. */
+    const char *name;
+    /** The index of @c Type::Element levels. */
+    int index;
+    /** The object of @c Type::Element levels. */
+    const ConfigObject *object;
+  };
+
   /** The current item stack. */
-  QStringList _stack;
+  QVector<Frame> _stack;
   /** The list of issues found. */
   QList<RadioLimitIssue> _messages;
   /** If @c true, any frequency range voilation is a warning. */
@@ -417,14 +457,30 @@ public:
    * @param structure Specifies the structure declaration of the property value.
    * @returns @c false If a property with the same name is already defined. */
   bool add(const QString &prop, RadioLimitElement *structure);
+  /** Returns the limits of the specified property or @c nullptr if the property is not limited. */
+  const RadioLimitElement *element(const QString &prop) const;
 
   virtual bool verify(const ConfigItem *item, const QMetaProperty &prop, RadioLimitContext &context) const;
   /** Verifies the properties of the given item. */
   virtual bool verifyItem(const ConfigItem *item, RadioLimitContext &context) const;
 
+protected:
+  /** A verification plan. The limited properties of a class in declaration order together with
+   * their limits. */
+  typedef QVector<QPair<QMetaProperty, RadioLimitElement *>> Plan;
+
+  /** Returns the verification plan for the given class. Plans are resolved once per class on
+   * first use and cached. This avoids the look-up of every property by name for every verified
+   * item. */
+  Plan plan(const QMetaObject *meta) const;
+
 protected:
   /** Holds the property <-> limits map. */
   QHash<QString, RadioLimitElement *> _elements;
+  /** The cached verification plans per class. */
+  mutable QHash<const QMetaObject *, Plan> _plans;
+  /** Guards the cached plans and look-ups, as verification may run concurrently. */
+  mutable QReadWriteLock _planLock;
 };
 
 
@@ -510,6 +566,8 @@ public:
 protected:
   /** Maps class-names to object limits. */
   QHash<QString,  RadioLimitObject *> _types;
+  /** Caches the object limits per class, guarded by @c _planLock. */
+  mutable QHash<const QMetaObject *, RadioLimitObject *> _dispatch;
 };
 
 
@@ -593,6 +651,11 @@ public:
   RadioLimitList(const std::initializer_list<ElementLimits> &elements, QObject *parent=nullptr);
 
   bool verify(const ConfigItem *item, const QMetaProperty &prop, RadioLimitContext &context) const;
+  /** Verifies the type and structure of a single element of the list. This allows to verify
+   * the elements of a list independently. */
+  bool verifyElement(int index, const ConfigObject *obj, RadioLimitContext &context) const;
+  /** Verifies the number of elements of each type in the given list. */
+  void verifyCounts(const ConfigObjectList *list, RadioLimitContext &context) const;
 
 protected:
   /** Searches for the specified type or one of its super-clsases in the set of allowed types. */
@@ -605,6 +668,10 @@ protected:
   QHash<QString, qint64> _minCount;
   /** Maps typename to maximum count. */
   QHash<QString, qint64> _maxCount;
+  /** Caches the result of @c findClassName per class. */
+  mutable QHash<const QMetaObject *, QString> _classNames;
+  /** Guards the cached class names, as verification may run concurrently. */
+  mutable QReadWriteLock _classNameLock;
 };
 
 
@@ -700,6 +767,13 @@ public:
 
   /** Verifies the given configuration. */
   virtual bool verifyConfig(const Config *config, RadioLimitContext &context) const;
+  /** Adds the issues of the radio itself, that do not depend on the configuration. E.g., that
+   * the support for the radio is still under development. */
+  virtual void verifyRadio(RadioLimitContext &context) const;
+  /** Verifies the top-level properties of the given configuration concurrently. The lists of
+   * a configuration (channels, contacts, zones, etc.) are checked independently. The issues are
+   * merged in the order of the properties, hence the result equals a sequential verification. */
+  bool verifyItem(const ConfigItem *item, RadioLimitContext &context) const;
 
   /** Returns @c true if the radio supports a call-sign DB. */
   bool hasCallSignDB() const;
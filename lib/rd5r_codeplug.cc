@@ -301,14 +301,21 @@ RD5RCodeplug::encodeContacts(Config *config, const Flags &flags, Context &ctx, c
 bool
 RD5RCodeplug::createContacts(Config *config, Context &ctx, const ErrorStack &err) {
   Q_UNUSED(err)
-  /* Unpack Contacts */
-  for (int i=0; i<NUM_CONTACTS; i++) {
-    ContactElement el(data(ADDR_CONTACTS + i*CONTACT_SIZE));
+  /* Decode contacts concurrently, only reading the codeplug */
+  const RD5RCodeplug *self = this;
+  auto records = decodeRecords<ContactElement::Record>(
+        NUM_CONTACTS, [self](unsigned i, ContactElement::Record &record) {
+    ContactElement el(const_cast<uint8_t *>(self->data(ADDR_CONTACTS + i*CONTACT_SIZE)));
     if (!el.isValid())
-      continue;
+      return false;
+    record = el.toRecord();
+    return true;
+  });
 
-    DMRContact *cont = el.toContactObj(ctx);
-    ctx.add(cont, i+1); config->contacts()->add(cont);
+  /* Unpack Contacts */
+  for (int i=0; i<records.size(); i++) {
+    DMRContact *cont = ContactElement::createContact(records[i].second);
+    ctx.add(cont, records[i].first+1); config->contacts()->add(cont);
   }
   return true;
 }
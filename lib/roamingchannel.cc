@@ -4,7 +4,7 @@
  * Implementation of RoamingChannel
  * ********************************************************************************************* */
 RoamingChannel::RoamingChannel(QObject *parent)
-  : ConfigObject(parent), _rxFrequency(0), _txFrequency(0), _overrideColorCode(false),
+  : ConfigObject(parent), _rxFrequency(), _txFrequency(), _overrideColorCode(false),
     _colorCode(0), _overrideTimeSlot(false), _timeSlot(DMRChannel::TimeSlot::TS1)
 {
   // pass...
@@ -19,7 +19,7 @@ RoamingChannel::RoamingChannel(const RoamingChannel &other, QObject *parent)
 void
 RoamingChannel::clear() {
   ConfigObject::clear();
-  _rxFrequency = _txFrequency = 0;
+  _rxFrequency = _txFrequency = Frequency();
   _overrideColorCode = false; _colorCode = 0;
   _overrideTimeSlot = false; _timeSlot = DMRChannel::TimeSlot::TS1;
 }
@@ -36,22 +36,40 @@ RoamingChannel::clone() const {
 
 double
 RoamingChannel::rxFrequency() const {
-  return _rxFrequency;
+  return _rxFrequency.inMHz();
 }
 void
 RoamingChannel::setRXFrequency(double f) {
+  setRXFreq(Frequency::fromMHz(f));
+}
+
+double
+RoamingChannel::txFrequency() const {
+  return _txFrequency.inMHz();
+}
+void
+RoamingChannel::setTXFrequency(double f) {
+  setTXFreq(Frequency::fromMHz(f));
+}
+
+Frequency
+RoamingChannel::rxFreq() const {
+  return _rxFrequency;
+}
+void
+RoamingChannel::setRXFreq(Frequency f) {
   if (f == _rxFrequency)
     return;
   _rxFrequency = f;
   emit modified(this);
 }
 
-double
-RoamingChannel::txFrequency() const {
+Frequency
+RoamingChannel::txFreq() const {
   return _txFrequency;
 }
 void
-RoamingChannel::setTXFrequency(double f) {
+RoamingChannel::setTXFreq(Frequency f) {
   if (f == _txFrequency)
     return;
   _txFrequency = f;
@@ -109,8 +127,8 @@ RoamingChannel *
 RoamingChannel::fromDMRChannel(DMRChannel *ch, DMRChannel* ref) {
   RoamingChannel *rch = new RoamingChannel();
   rch->setName(QString("R %1").arg(ch->name()));
-  rch->setRXFrequency(ch->rxFrequency());
-  rch->setTXFrequency(ch->txFrequency());
+  rch->setRXFreq(ch->rxFreq());
+  rch->setTXFreq(ch->txFreq());
   rch->overrideColorCode(true);
   rch->setColorCode(ch->colorCode());
   rch->overrideTimeSlot(true);
@@ -48,6 +48,19 @@ public:
   /** Sets the TX frquency in MHz. */
   void setTXFrequency(double f);
 
+  /** Returns the exact RX frequency.
+   * @since 0.11.3 */
+  Frequency rxFreq() const;
+  /** Sets the RX frequency.
+   * @since 0.11.3 */
+  void setRXFreq(Frequency f);
+  /** Returns the exact TX frequency.
+   * @since 0.11.3 */
+  Frequency txFreq() const;
+  /** Sets the TX frequency.
+   * @since 0.11.3 */
+  void setTXFreq(Frequency f);
+
   /** Returns @c true, if the color code of the channel gets overridden. */
   bool colorCodeOverridden() const;
   /** Enables/disables overriding the color code of the channel. */
@@ -77,10 +90,10 @@ protected:
   bool populate(YAML::Node &node, const Context &context, const ErrorStack &err);
 
 protected:
-  /** Holds the RX frequency in MHz. */
-  double _rxFrequency;
-  /** Holds the TX frequency in MHz. */
-  double _txFrequency;
+  /** Holds the RX frequency. */
+  Frequency _rxFrequency;
+  /** Holds the TX frequency. */
+  Frequency _txFrequency;
   /** If @c true, the color code of the channel gets overridden by the one specified in @c _colorCode. */
   bool _overrideColorCode;
   /** If @c _overrideColorCode is @c true, specifies the color code. */
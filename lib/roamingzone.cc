@@ -1,6 +1,7 @@
 #include "roamingzone.hh"
 #include "channel.hh"
 #include <QSet>
+#include <QMutex>
 #include "config.hh"
 
 /* ********************************************************************************************* *
@@ -163,6 +164,9 @@ DefaultRoamingZone::DefaultRoamingZone(QObject *parent)
 
 DefaultRoamingZone *
 DefaultRoamingZone::get() {
+  // Encoders running concurrently may request the instance at the same time.
+  static QMutex mutex;
+  QMutexLocker locker(&mutex);
   if (nullptr == _instance)
     _instance = new DefaultRoamingZone();
   return _instance;
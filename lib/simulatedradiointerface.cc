@@ -0,0 +1,244 @@
+#include "simulatedradiointerface.hh"
+#include <QThread>
+#include <cstring>
+
+
+/* ********************************************************************************************* *
+ * Implementation of SimulatedRadioInterface::Link
+ * ********************************************************************************************* */
+SimulatedRadioInterface::Link::Link()
+  : latency(0), jitter(0), bandwidth(0), errorRate(0), realtime(false)
+{
+  // pass...
+}
+
+
+/* ********************************************************************************************* *
+ * Implementation of SimulatedRadioInterface::Statistics
+ * ********************************************************************************************* */
+SimulatedRadioInterface::Statistics::Statistics()
+  : reads(0), writes(0), bytesRead(0), bytesWritten(0), errors(0), elapsed(0)
+{
+  // pass...
+}
+
+
+/* ********************************************************************************************* *
+ * Implementation of SimulatedRadioInterface
+ * ********************************************************************************************* */
+SimulatedRadioInterface::SimulatedRadioInterface(const RadioInfo &info, const Memory &memory, QObject *parent)
+  : QObject(parent), RadioInterface(), _info(info), _open(true), _memory(memory), _fill(0x00),
+    _link(), _failAt(-1), _random(), _statistics()
+{
+  // pass...
+}
+
+SimulatedRadioInterface::~SimulatedRadioInterface() {
+  // pass...
+}
+
+bool
+SimulatedRadioInterface::isOpen() const {
+  return _open;
+}
+
+void
+SimulatedRadioInterface::close() {
+  _open = false;
+}
+
+void
+SimulatedRadioInterface::open() {
+  _open = true;
+}
+
+RadioInfo
+SimulatedRadioInterface::identifier(const ErrorStack &err) {
+  if (! _open) {
+    errMsg(err) << "Cannot identify radio: Simulated interface is closed.";
+    return RadioInfo();
+  }
+  return _info;
+}
+
+bool
+SimulatedRadioInterface::read_start(uint32_t bank, uint32_t addr, const ErrorStack &err) {
+  Q_UNUSED(bank); Q_UNUSED(addr);
+  if (! _open) {
+    errMsg(err) << "Cannot start read: Simulated interface is closed.";
+    return false;
+  }
+  return true;
+}
+
+bool
+SimulatedRadioInterface::read(uint32_t bank, uint32_t addr, uint8_t *data, int nbytes, const ErrorStack &err) {
+  if (! _open) {
+    errMsg(err) << "Cannot read from simulated radio: Interface is closed.";
+    return false;
+  }
+  if (! transfer(nbytes, err)) {
+    errMsg(err) << "Cannot read " << nbytes << "b from 0x" << QString::number(addr, 16)
+                << " (bank " << bank << ").";
+    return false;
+  }
+  load(bank, addr, data, nbytes);
+  _statistics.reads++;
+  _statistics.bytesRead += nbytes;
+  return true;
+}
+
+bool
+SimulatedRadioInterface::read_finish(const ErrorStack &err) {
+  Q_UNUSED(err);
+  return true;
+}
+
+bool
+SimulatedRadioInterface::write_start(uint32_t bank, uint32_t addr, const ErrorStack &err) {
+  Q_UNUSED(bank); Q_UNUSED(addr);
+  if (! _open) {
+    errMsg(err) << "Cannot start write: Simulated interface is closed.";
+    return false;
+  }
+  return true;
+}
+
+bool
+SimulatedRadioInterface::write(uint32_t bank, uint32_t addr, uint8_t *data, int nbytes, const ErrorStack &err) {
+  if (! _open) {
+    errMsg(err) << "Cannot write to simulated radio: Interface is closed.";
+    return false;
+  }
+  if (! transfer(nbytes, err)) {
+    errMsg(err) << "Cannot write " << nbytes << "b to 0x" << QString::number(addr, 16)
+                << " (bank " << bank << ").";
+    return false;
+  }
+  store(bank, addr, data, nbytes);
+  _statistics.writes++;
+  _statistics.bytesWritten += nbytes;
+  return true;
+}
+
+bool
+SimulatedRadioInterface::write_finish(const ErrorStack &err) {
+  Q_UNUSED(err);
+  return true;
+}
+
+bool
+SimulatedRadioInterface::erase(uint32_t bank, uint32_t addr, uint32_t size, const ErrorStack &err) {
+  if (! _open) {
+    errMsg(err) << "Cannot erase simulated radio memory: Interface is closed.";
+    return false;
+  }
+  QByteArray blank(size, char(_fill));
+  store(bank, addr, (const uint8_t *)blank.constData(), size);
+  return true;
+}
+
+const SimulatedRadioInterface::Link &
+SimulatedRadioInterface::link() const {
+  return _link;
+}
+
+void
+SimulatedRadioInterface::setLink(const Link &link) {
+  _link = link;
+}
+
+void
+SimulatedRadioInterface::seed(quint32 value) {
+  _random.seed(value);
+}
+
+void
+SimulatedRadioInterface::failAt(unsigned n) {
+  _failAt = n;
+}
+
+uint8_t
+SimulatedRadioInterface::fillValue() const {
+  return _fill;
+}
+
+void
+SimulatedRadioInterface::setFillValue(uint8_t value) {
+  _fill = value;
+}
+
+const SimulatedRadioInterface::Memory &
+SimulatedRadioInterface::memory() const {
+  return _memory;
+}
+
+void
+SimulatedRadioInterface::setMemory(const Memory &memory) {
+  _memory = memory;
+}
+
+const SimulatedRadioInterface::Statistics &
+SimulatedRadioInterface::statistics() const {
+  return _statistics;
+}
+
+void
+SimulatedRadioInterface::resetStatistics() {
+  _statistics = Statistics();
+}
+
+bool
+SimulatedRadioInterface::transfer(int nbytes, const ErrorStack &err) {
+  // Compute time spent on the link
+  quint64 dt = _link.latency;
+  if (_link.jitter)
+    dt += _random.bounded(_link.jitter+1);
+  if (_link.bandwidth)
+    dt += (quint64(nbytes)*1000000ULL)/_link.bandwidth;
+  _statistics.elapsed += dt;
+  if (_link.realtime && dt)
+    QThread::usleep(dt);
+
+  // Check for injected errors
+  bool failed = (0 == _failAt);
+  if (0 <= _failAt)
+    _failAt--;
+  if ((! failed) && (0 < _link.errorRate))
+    failed = (_random.generateDouble() < _link.errorRate);
+  if (failed) {
+    _statistics.errors++;
+    errMsg(err) << "Simulated transfer error.";
+    return false;
+  }
+
+  return true;
+}
+
+void
+SimulatedRadioInterface::load(uint32_t bank, uint32_t addr, uint8_t *data, int nbytes) const {
+  while (0 < nbytes) {
+    uint32_t page = addr - (addr % PageSize), offset = addr - page;
+    int n = std::min(nbytes, int(PageSize-offset));
+    quint64 key = (quint64(bank)<<32) | page;
+    Memory::const_iterator item = _memory.constFind(key);
+    if (_memory.constEnd() == item)
+      memset(data, _fill, n);
+    else
+      memcpy(data, item->constData()+offset, n);
+    data += n; addr += n; nbytes -= n;
+  }
+}
+
+void
+SimulatedRadioInterface::store(uint32_t bank, uint32_t addr, const uint8_t *data, int nbytes) {
+  while (0 < nbytes) {
+    uint32_t page = addr - (addr % PageSize), offset = addr - page;
+    int n = std::min(nbytes, int(PageSize-offset));
+    quint64 key = (quint64(bank)<<32) | page;
+    if (! _memory.contains(key))
+      _memory.insert(key, QByteArray(PageSize, char(_fill)));
+    memcpy(_memory[key].data()+offset, data, n);
+    data += n; addr += n; nbytes -= n;
+  }
+}
@@ -0,0 +1,162 @@
+#ifndef SIMULATEDRADIOINTERFACE_HH
+#define SIMULATEDRADIOINTERFACE_HH
+
+#include <QObject>
+#include <QHash>
+#include <QByteArray>
+#include <QRandomGenerator>
+
+#include "radiointerface.hh"
+
+/** Implements a loop-back radio interface backed by an in-memory flash image.
+ *
+ * This interface does not talk to any device. Instead, all read and write requests are served
+ * from and stored into a sparse memory image held by the interface itself. This allows to run
+ * complete codeplug down- and uploads as well as callsign DB uploads without any radio attached,
+ * e.g., within unit tests or benchmarks.
+ *
+ * To make this interface useful for performance testing, the link to the simulated device can be
+ * configured using @c Link. That is, a per-request latency, some random jitter, a limited
+ * bandwidth and a probability for failed requests. The time spent on the link is accumulated in
+ * the transfer statistics (see @c Statistics). If @c Link::realtime is set, the interface will
+ * also actually block for that time.
+ *
+ * Deterministic errors can be injected using @c failAt.
+ *
+ * @ingroup rif */
+class SimulatedRadioInterface : public QObject, public RadioInterface
+{
+  Q_OBJECT
+
+public:
+  /** Size of a single memory page of the sparse flash image. */
+  static const unsigned PageSize = 0x1000;
+
+  /** The sparse memory image. Maps the bank and page address to the page content.
+   * The key is composed as <tt>(bank << 32) | pageAddress</tt>. */
+  typedef QHash<quint64, QByteArray> Memory;
+
+  /** Describes the properties of the simulated link to the device. */
+  class Link
+  {
+  public:
+    /** Default constructor. Describes an ideal link: No latency, infinite bandwidth and no
+     * errors. */
+    Link();
+
+  public:
+    /** Per request latency in micro seconds. */
+    unsigned latency;
+    /** Maximum additional random latency per request in micro seconds. */
+    unsigned jitter;
+    /** Bandwidth in bytes per second. If 0, the bandwidth is infinite. */
+    unsigned bandwidth;
+    /** Probability of a failing request [0,1]. */
+    double errorRate;
+    /** If @c true, the interface blocks for the simulated transfer time. */
+    bool realtime;
+  };
+
+  /** Collects some statistics about the transfers made. */
+  class Statistics
+  {
+  public:
+    /** Empty constructor. */
+    Statistics();
+
+  public:
+    /** Number of read requests. */
+    unsigned reads;
+    /** Number of write requests. */
+    unsigned writes;
+    /** Number of bytes read. */
+    size_t bytesRead;
+    /** Number of bytes written. */
+    size_t bytesWritten;
+    /** Number of failed requests. */
+    unsigned errors;
+    /** Accumulated (simulated) transfer time in micro seconds. */
+    quint64 elapsed;
+  };
+
+public:
+  /** Constructs a new simulated interface identifying itself as @c info.
+   * @param info Specifies the radio info, the interface identifies as.
+   * @param memory Specifies the initial memory image.
+   * @param parent Specifies the QObject parent. */
+  explicit SimulatedRadioInterface(const RadioInfo &info, const Memory &memory=Memory(),
+                                   QObject *parent=nullptr);
+  /** Destructor. */
+  virtual ~SimulatedRadioInterface();
+
+  bool isOpen() const;
+  void close();
+  /** (Re-)Opens the interface. The memory image is kept. */
+  void open();
+
+  RadioInfo identifier(const ErrorStack &err=ErrorStack());
+
+  bool read_start(uint32_t bank, uint32_t addr, const ErrorStack &err=ErrorStack());
+  bool read(uint32_t bank, uint32_t addr, uint8_t *data, int nbytes, const ErrorStack &err=ErrorStack());
+  bool read_finish(const ErrorStack &err=ErrorStack());
+
+  bool write_start(uint32_t bank, uint32_t addr, const ErrorStack &err=ErrorStack());
+  bool write(uint32_t bank, uint32_t addr, uint8_t *data, int nbytes, const ErrorStack &err=ErrorStack());
+  bool write_finish(const ErrorStack &err=ErrorStack());
+
+  /** Erases the specified memory region, that is, fills it with the erase value. */
+  bool erase(uint32_t bank, uint32_t addr, uint32_t size, const ErrorStack &err=ErrorStack());
+
+  /** Returns the link properties. */
+  const Link &link() const;
+  /** Sets the link properties. */
+  void setLink(const Link &link);
+  /** Seeds the random number generator used for jitter and error injection. */
+  void seed(quint32 value);
+
+  /** Lets the @c n-th request (counting from the next one, starting at 0) fail. */
+  void failAt(unsigned n);
+
+  /** Returns the value, unwritten memory reads as. */
+  uint8_t fillValue() const;
+  /** Sets the value, unwritten memory reads as. Default 0x00. */
+  void setFillValue(uint8_t value);
+
+  /** Returns the memory image. */
+  const Memory &memory() const;
+  /** Replaces the memory image. */
+  void setMemory(const Memory &memory);
+
+  /** Returns the transfer statistics. */
+  const Statistics &statistics() const;
+  /** Resets the transfer statistics. */
+  void resetStatistics();
+
+protected:
+  /** Simulates the transfer of @c nbytes over the link. Returns @c false if the request fails. */
+  bool transfer(int nbytes, const ErrorStack &err);
+  /** Copies @c nbytes from the memory image at the given address into @c data. */
+  void load(uint32_t bank, uint32_t addr, uint8_t *data, int nbytes) const;
+  /** Copies @c nbytes from @c data into the memory image at the given address. */
+  void store(uint32_t bank, uint32_t addr, const uint8_t *data, int nbytes);
+
+protected:
+  /** The radio info, the interface identifies as. */
+  RadioInfo _info;
+  /** If @c true, the interface is open. */
+  bool _open;
+  /** The memory image. */
+  Memory _memory;
+  /** The value of unwritten memory. */
+  uint8_t _fill;
+  /** The link properties. */
+  Link _link;
+  /** Number of requests until an injected failure, -1 if none. */
+  int _failAt;
+  /** The random number generator for jitter and error injection. */
+  QRandomGenerator _random;
+  /** The transfer statistics. */
+  Statistics _statistics;
+};
+
+#endif // SIMULATEDRADIOINTERFACE_HH
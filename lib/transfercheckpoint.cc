@@ -0,0 +1,203 @@
+#include "transfercheckpoint.hh"
+#include "dfufile.hh"
+#include "logger.hh"
+
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+#include <QRegExp>
+#include <QFile>
+#include <QDir>
+
+
+/* ********************************************************************************************* *
+ * Implementation of TransferCheckpoint
+ * ********************************************************************************************* */
+TransferCheckpoint::TransferCheckpoint(const QString &radio, Operation operation, const DFUFile &image, bool content)
+  : _radio(radio), _operation(operation), _image(image), _content(content), _hash(),
+    _element(0), _offset(0)
+{
+  // pass...
+}
+
+bool
+TransferCheckpoint::isValid() const {
+  return (0 != _element) || (0 != _offset);
+}
+
+const QString &
+TransferCheckpoint::radio() const {
+  return _radio;
+}
+
+TransferCheckpoint::Operation
+TransferCheckpoint::operation() const {
+  return _operation;
+}
+
+const QByteArray &
+TransferCheckpoint::hash() const {
+  if (_hash.isEmpty())
+    _hash = hash(_image, _content);
+  return _hash;
+}
+
+unsigned
+TransferCheckpoint::element() const {
+  return _element;
+}
+
+unsigned
+TransferCheckpoint::offset() const {
+  return _offset;
+}
+
+void
+TransferCheckpoint::update(unsigned element, unsigned offset) {
+  _element = element;
+  _offset = offset;
+}
+
+bool
+TransferCheckpoint::save(const ErrorStack &err) const {
+  QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/checkpoints";
+  QDir directory;
+  if ((! directory.exists(path)) && (! directory.mkpath(path))) {
+    errMsg(err) << "Cannot create path '" << path << "'.";
+    return false;
+  }
+
+  QFile file(filename(".json"));
+  if (! file.open(QIODevice::WriteOnly)) {
+    errMsg(err) << "Cannot save transfer checkpoint at '" << file.fileName()
+                << "': " << file.errorString() << ".";
+    return false;
+  }
+
+  QJsonObject obj;
+  obj.insert("radio", _radio);
+  obj.insert("hash", QString::fromLatin1(hash().toHex()));
+  obj.insert("element", int(_element));
+  obj.insert("offset", int(_offset));
+  file.write(QJsonDocument(obj).toJson());
+  file.close();
+
+  logDebug() << "Saved transfer checkpoint at element " << _element << ", offset 0x"
+             << QString::number(_offset, 16) << " to '" << file.fileName() << "'.";
+  return true;
+}
+
+bool
+TransferCheckpoint::save(DFUFile &image, const ErrorStack &err) const {
+  if (! save(err))
+    return false;
+  if (! image.write(filename(".dfu"), err)) {
+    errMsg(err) << "Cannot save partial image for transfer checkpoint.";
+    remove();
+    return false;
+  }
+  return true;
+}
+
+bool
+TransferCheckpoint::restore(const ErrorStack &err) {
+  QFile file(filename(".json"));
+  if (! file.exists())
+    return false;
+  if (! file.open(QIODevice::ReadOnly)) {
+    errMsg(err) << "Cannot open transfer checkpoint '" << file.fileName()
+                << "': " << file.errorString() << ".";
+    return false;
+  }
+
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+  file.close();
+  if (! doc.isObject()) {
+    errMsg(err) << "Cannot parse transfer checkpoint '" << file.fileName() << "'.";
+    return false;
+  }
+
+  QJsonObject obj = doc.object();
+  if ((_radio != obj.value("radio").toString())
+      || (hash() != QByteArray::fromHex(obj.value("hash").toString().toLatin1()))) {
+    logInfo() << "Ignore transfer checkpoint '" << file.fileName()
+              << "': Radio or image does not match.";
+    return false;
+  }
+
+  int element = obj.value("element").toInt(-1), offset = obj.value("offset").toInt(-1);
+  if ((0 > element) || (0 > offset)) {
+    errMsg(err) << "Invalid position in transfer checkpoint '" << file.fileName() << "'.";
+    return false;
+  }
+
+  update(element, offset);
+  logDebug() << "Restored transfer checkpoint at element " << _element << ", offset 0x"
+             << QString::number(_offset, 16) << ".";
+  return true;
+}
+
+bool
+TransferCheckpoint::restore(DFUFile &image, const ErrorStack &err) {
+  if (! restore(err))
+    return false;
+
+  // Read partial image into a temporary file first, to keep the given one intact on error
+  DFUFile partial;
+  if (! partial.read(filename(".dfu"), err)) {
+    errMsg(err) << "Cannot restore partial image for transfer checkpoint.";
+    update(0, 0);
+    return false;
+  }
+  if (hash(partial, false) != hash(image, false)) {
+    logInfo() << "Ignore transfer checkpoint: Image layout does not match.";
+    update(0, 0);
+    return false;
+  }
+
+  for (int i=0; i<image.numImages(); i++) {
+    for (int j=0; j<image.image(i).numElements(); j++)
+      image.image(i).element(j).data() = partial.image(i).element(j).data();
+  }
+
+  return true;
+}
+
+void
+TransferCheckpoint::remove() const {
+  QFile::remove(filename(".json"));
+  QFile::remove(filename(".dfu"));
+}
+
+QByteArray
+TransferCheckpoint::hash(const DFUFile &image, bool content) {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  for (int i=0; i<image.numImages(); i++) {
+    for (int j=0; j<image.image(i).numElements(); j++) {
+      const DFUFile::Element &el = image.image(i).element(j);
+      uint32_t header[2] = { qToLittleEndian(el.address()), qToLittleEndian(uint32_t(el.data().size())) };
+      hash.addData((const char *)header, sizeof(header));
+      if (content)
+        hash.addData(el.data());
+    }
+  }
+  return hash.result();
+}
+
+QString
+TransferCheckpoint::filename(const QString &ext) const {
+  QString op;
+  switch (_operation) {
+  case Operation::Download: op = "download"; break;
+  case Operation::Upload: op = "upload"; break;
+  case Operation::UploadCallsigns: op = "callsigns"; break;
+  }
+
+  QString radio = _radio.toLower();
+  radio.replace(QRegExp("[^a-z0-9]+"), "_");
+
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+      + "/checkpoints/" + radio + "-" + op + ext;
+}
@@ -0,0 +1,97 @@
+#ifndef TRANSFERCHECKPOINT_HH
+#define TRANSFERCHECKPOINT_HH
+
+#include <QString>
+#include <QByteArray>
+
+#include "errorstack.hh"
+
+class DFUFile;
+
+
+/** Records the progress of an interrupted transfer to or from a radio.
+ *
+ * Long running transfers (e.g., callsign DB uploads) may fail in the middle, for example due to a
+ * flaky USB cable. A checkpoint records the element index and the byte offset within that element
+ * up to which the transfer was verified by the device. It is stored together with the name of the
+ * radio, the kind of transfer and a hash of the transferred image. On the next attempt, the
+ * transfer can then be resumed at that block if the radio and image hash match. The hash is
+ * computed only when the checkpoint is saved or restored, hence successful transfers do not pay
+ * for hashing the image.
+ *
+ * Checkpoints are stored within the application data directory, one per radio and operation.
+ * For downloads, the partially downloaded image is stored alongside the checkpoint.
+ *
+ * @ingroup rif */
+class TransferCheckpoint
+{
+public:
+  /** Possible transfer operations. */
+  enum class Operation {
+    Download,          ///< Codeplug download.
+    Upload,            ///< Codeplug upload.
+    UploadCallsigns    ///< Callsign DB upload.
+  };
+
+public:
+  /** Constructs a checkpoint for the specified radio, operation and image. If @c content is
+   * @c false, only the layout of the image is hashed (see @c hash). */
+  TransferCheckpoint(const QString &radio, Operation operation, const DFUFile &image,
+                     bool content=true);
+
+  /** Returns @c true if the checkpoint points to a position within the transfer. */
+  bool isValid() const;
+  /** Returns the name of the radio. */
+  const QString &radio() const;
+  /** Returns the transfer operation. */
+  Operation operation() const;
+  /** Returns the hash of the transferred image. The hash gets computed on first use. */
+  const QByteArray &hash() const;
+  /** Returns the index of the element, the transfer stopped at. */
+  unsigned element() const;
+  /** Returns the offset within the element, the transfer stopped at. */
+  unsigned offset() const;
+
+  /** Updates the position of the checkpoint. That is, all data before the given element and
+   * offset was verified by the device. */
+  void update(unsigned element, unsigned offset);
+
+  /** Stores the checkpoint. */
+  bool save(const ErrorStack &err=ErrorStack()) const;
+  /** Stores the checkpoint together with the partially transferred image. */
+  bool save(DFUFile &image, const ErrorStack &err=ErrorStack()) const;
+  /** Loads a stored checkpoint for the same radio and operation. Returns @c true if a checkpoint
+   * exists and its hash matches the hash of this one. In this case, the position is updated. */
+  bool restore(const ErrorStack &err=ErrorStack());
+  /** Like @c restore but also loads the partially transferred image into @c image. */
+  bool restore(DFUFile &image, const ErrorStack &err=ErrorStack());
+  /** Deletes any stored checkpoint for this radio and operation. */
+  void remove() const;
+
+public:
+  /** Computes the hash of the given image. If @c content is @c false, only the layout (addresses
+   * and sizes of all elements) is hashed. */
+  static QByteArray hash(const DFUFile &image, bool content=true);
+
+protected:
+  /** Returns the path of the checkpoint file with the given extension. */
+  QString filename(const QString &ext) const;
+
+protected:
+  /** The radio name. */
+  QString _radio;
+  /** The transfer operation. */
+  Operation _operation;
+  /** The transferred image. */
+  const DFUFile &_image;
+  /** If @c true, the content of the image is hashed, otherwise only its layout. */
+  bool _content;
+  /** The image hash, empty until computed. */
+  mutable QByteArray _hash;
+  /** Index of the element. */
+  unsigned _element;
+  /** Offset within the element. */
+  unsigned _offset;
+};
+
+#endif // TRANSFERCHECKPOINT_HH
@@ -475,8 +475,8 @@ TyTCodeplug::ChannelElement::toChannelObj(const ErrorStack &err) const {
 
   // Common settings
   ch->setName(name());
-  ch->setRXFrequency(double(rxFrequency())/1e6);
-  ch->setTXFrequency(double(txFrequency())/1e6);
+  ch->setRXFreq(Frequency::fromHz(rxFrequency()));
+  ch->setTXFreq(Frequency::fromHz(txFrequency()));
   ch->setTimeout(txTimeOut());
   ch->setRXOnly(rxOnly());
   // Power setting must be overridden by specialized class
@@ -562,8 +562,8 @@ TyTCodeplug::ChannelElement::linkChannelObj(Channel *c, Context &ctx, const Erro
 void
 TyTCodeplug::ChannelElement::fromChannelObj(const Channel *chan, Context &ctx) {
   setName(chan->name());
-  setRXFrequency(chan->rxFrequency()*1e6);
-  setTXFrequency(chan->txFrequency()*1e6);
+  setRXFrequency(chan->rxFreq().inHz());
+  setTXFrequency(chan->txFreq().inHz());
   enableRXOnly(chan->rxOnly());
   if (chan->defaultTimeout())
     setTXTimeOut(ctx.config()->settings()->tot());
@@ -738,9 +738,24 @@ TyTCodeplug::ContactElement::setName(const QString &nm) {
   writeUnicode(4, nm, 16, 0x0000);
 }
 
+TyTCodeplug::ContactElement::Record
+TyTCodeplug::ContactElement::toRecord() const {
+  Record record;
+  record.type = callType();
+  record.name = name();
+  record.dmrId = dmrId();
+  record.ringTone = ringTone();
+  return record;
+}
+
+DMRContact *
+TyTCodeplug::ContactElement::createContact(const Record &record) {
+  return new DMRContact(record.type, record.name, record.dmrId, record.ringTone);
+}
+
 DMRContact *
 TyTCodeplug::ContactElement::toContactObj() const {
-  return new DMRContact(callType(), name(), dmrId(), ringTone());
+  return createContact(toRecord());
 }
 
 bool
@@ -2838,11 +2853,13 @@ TyTCodeplug::encode(Config *config, const Flags &flags, const ErrorStack &err) {
   if (! index(config, ctx))
     return false;
 
-  return this->encodeElements(flags, ctx);
+  return this->encodeElements(flags, ctx, err);
 }
 
 bool
 TyTCodeplug::decode(Config *config, const ErrorStack &err) {
+  // Notify about changes once decoding is complete
+  Config::Transaction transaction(config);
   // Create index<->object table.
   Context ctx(config);
 
@@ -2866,41 +2883,48 @@ TyTCodeplug::encodeElements(const Flags &flags, Context &ctx, const ErrorStack &
     return false;
   }
 
-  // Define Contacts
-  if (! this->encodeContacts(ctx.config(), flags, ctx)) {
-    errMsg(err) << "Cannot encode contacts.";
-    return false;
-  }
-
-  // Define RX GroupLists
-  if (! this->encodeGroupLists(ctx.config(), flags, ctx)) {
-    errMsg(err) << "Cannot encode group lists.";
-    return false;
-  }
-
   // Define encryption keys
   if (! this->encodePrivacyKeys(ctx.config(), flags, ctx)) {
     errMsg(err) << "Cannot encode encryption keys.";
     return false;
   }
 
-  // Define Channels
-  if (! this->encodeChannels(ctx.config(), flags, ctx)) {
-    errMsg(err) << "Cannot encode channels.";
-    return false;
-  }
-
-  // Define Zones
-  if (! this->encodeZones(ctx.config(), flags, ctx)) {
-    errMsg(err) << "Cannot encode zones.";
-    return false;
-  }
-
-  // Define Scanlists
-  if (! this->encodeScanLists(ctx.config(), flags, ctx)) {
-    errMsg(err) << "Cannot encode scan lists.";
+  // Define contacts, group lists, channels, zones and scan lists. These sections are encoded into
+  // disjoint memory, possibly concurrently.
+  QVector<Section> sections = {
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeContacts(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode contacts.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeGroupLists(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode group lists.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeChannels(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode channels.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeZones(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode zones.";
+      return false;
+    },
+    [this, &flags, &ctx](const ErrorStack &err) {
+      if (this->encodeScanLists(ctx.config(), flags, ctx, err))
+        return true;
+      errMsg(err) << "Cannot encode scan lists.";
+      return false;
+    }
+  };
+  if (! this->encodeSections(sections, flags, ctx, err))
     return false;
-  }
 
   // Define GPS systems
   if (! this->encodePositioningSystems(ctx.config(), flags, ctx)) {
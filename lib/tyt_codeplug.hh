@@ -290,6 +290,26 @@ public:
     /** Sets the name of the contact. */
     virtual void setName(const QString &nm);
 
+    /** The decoded settings of a contact. */
+    struct Record {
+      /** The call type. */
+      DMRContact::Type type;
+      /** The name of the contact. */
+      QString name;
+      /** The DMR ID of the contact. */
+      uint32_t dmrId;
+      /** If @c true, the ring tone is enabled. */
+      bool ringTone;
+    };
+
+    /** Decodes this contact into a record. No objects are created, hence several contacts may be
+     * decoded concurrently.
+     * @since 0.11.3 */
+    virtual Record toRecord() const;
+    /** Creates a contact from a decoded contact.
+     * @since 0.11.3 */
+    static DMRContact *createContact(const Record &record);
+
     /** Encodes the give contact. */
     virtual bool fromContactObj(const DMRContact *contact);
     /** Creates a contact. */
@@ -2,12 +2,17 @@
 #include "config.hh"
 #include "logger.hh"
 #include "utils.hh"
+#include "transfercheckpoint.hh"
+#include "codeplugcache.hh"
+#include <cstring>
 
 #define BSIZE 1024
+// Number of blocks to verify the codeplug cache against the device
+#define CACHE_SAMPLES 32
 
 
 TyTRadio::TyTRadio(TyTInterface *device, QObject *parent)
-  : Radio(parent), _dev(device), _codeplugFlags(), _config(nullptr)
+  : Radio(parent), _dev(device), _codeplugFlags(), _config()
 {
   // pass...
 }
@@ -48,7 +53,9 @@ TyTRadio::startUpload(Config *config, bool blocking, const Codeplug::Flags &flag
   if (StatusIdle != _task)
     return false;
 
-  if (! (_config = config))
+  // Encode from a frozen copy, the config may still be edited while uploading.
+  _config = QSharedPointer<Config>((config ? config->freeze(err) : nullptr), &QObject::deleteLater);
+  if (_config.isNull())
     return false;
 
   _task = StatusUpload;
@@ -107,7 +114,7 @@ TyTRadio::run() {
     _dev->reboot();
     _dev->close();
     emit downloadFinished(this, &codeplug());
-    _config = nullptr;
+    _config.reset();
   } else if (StatusUpload == _task) {
     if ((nullptr==_dev) || (! _dev->isOpen())) {
       emit uploadError(this);
@@ -166,21 +173,69 @@ TyTRadio::download() {
     totb += codeplug().image(0).element(n).data().size()/BSIZE;
   }
 
-  // Then download codeplug
+  // Resume from the last verified block, if there is a checkpoint for this radio
+  int n0 = 0; unsigned s0 = 0;
   size_t bcount = 0;
-  for (int n=0; n<codeplug().image(0).numElements(); n++) {
+  TransferCheckpoint checkpoint(name(), TransferCheckpoint::Operation::Download, codeplug(), false);
+  if (_resume && checkpoint.restore(codeplug()) && resumeDownload(checkpoint)) {
+    n0 = checkpoint.element(); s0 = checkpoint.offset()/BSIZE;
+    for (int n=0; n<n0; n++)
+      bcount += codeplug().image(0).element(n).data().size()/BSIZE;
+    bcount += s0;
+    logInfo() << "Resume codeplug download at element " << n0 << ", block " << s0 << ".";
+  }
+
+  // Then download codeplug
+  for (int n=n0; n<codeplug().image(0).numElements(); n++, s0=0) {
     unsigned addr = codeplug().image(0).element(n).address();
     unsigned size = codeplug().image(0).element(n).data().size();
     unsigned b0 = addr/BSIZE, nb = size/BSIZE;
-    for (unsigned b=0; b<nb; b++, bcount++) {
+    for (unsigned b=s0; b<nb; b++, bcount++) {
       if (! _dev->read(0, (b0+b)*BSIZE, codeplug().data((b0+b)*BSIZE), BSIZE, _errorStack)) {
         errMsg(_errorStack) << "Cannot download codeplug.";
+        checkpoint.update(n, b*BSIZE);
+        if (checkpoint.isValid() && checkpoint.save(codeplug(), _errorStack))
+          errMsg(_errorStack) << "Download can be resumed at element " << n << ", block " << b << ".";
         return false;
       }
       emit downloadProgress(float(bcount*100)/totb);
     }
   }
 
+  checkpoint.remove();
+
+  // Remember what was read from the device
+  ErrorStack err;
+  if (! CodeplugCache(name()).store(codeplug(), err))
+    logWarn() << "Cannot update codeplug cache: " << err.format();
+
+  return true;
+}
+
+bool
+TyTRadio::resumeDownload(const TransferCheckpoint &checkpoint) {
+  // Find the last block downloaded before the checkpoint
+  int n = checkpoint.element(); unsigned offset = checkpoint.offset();
+  if (n >= codeplug().image(0).numElements())
+    return false;
+  while ((0 == offset) && (0 < n))
+    offset = codeplug().image(0).element(--n).data().size();
+  if (0 == offset)
+    return false;
+
+  // Re-read that block and compare it with the restored one. This ensures that the checkpoint
+  // was made with the same device and that the codeplug was not changed meanwhile.
+  unsigned addr = codeplug().image(0).element(n).address() + offset - BSIZE;
+  QByteArray block(BSIZE, 0); ErrorStack err;
+  if (! _dev->read(0, addr, (uint8_t *)block.data(), BSIZE, err)) {
+    logWarn() << "Cannot verify transfer checkpoint: " << err.format();
+    return false;
+  }
+  if (0 != memcmp(block.constData(), codeplug().data(addr), BSIZE)) {
+    logInfo() << "Ignore transfer checkpoint: Codeplug on device does not match.";
+    return false;
+  }
+
   return true;
 }
 
@@ -198,8 +253,13 @@ TyTRadio::upload() {
   size_t totb = codeplug().memSize();
 
   size_t bcount = 0;
-  // If codeplug gets updated, download codeplug from device first:
-  if (_codeplugFlags.updateCodePlug) {
+  // If codeplug gets updated, download codeplug from device first. If some samples of the device
+  // memory match the codeplug cached during the last transfer, use the cached one instead.
+  CodeplugCache cache(name());
+  if (_codeplugFlags.updateCodePlug && cache.verify(_dev, codeplug(), 0, CACHE_SAMPLES, BSIZE)
+      && cache.restore(codeplug())) {
+    logInfo() << "Use cached codeplug for update.";
+  } else if (_codeplugFlags.updateCodePlug) {
     for (int n=0; n<codeplug().image(0).numElements(); n++) {
       unsigned addr = codeplug().image(0).element(n).address();
       unsigned size = codeplug().image(0).element(n).data().size();
@@ -216,7 +276,7 @@ TyTRadio::upload() {
 
   // Encode config into codeplug
   logDebug() << "Encode codeplug.";
-  codeplug().encode(_config, _codeplugFlags);
+  codeplug().encode(_config.data(), _codeplugFlags);
 
   // then erase memory
   for (int i=0; i<codeplug().image(0).numElements(); i++)
@@ -239,6 +299,11 @@ TyTRadio::upload() {
     }
   }
 
+  // Remember what was written to the device
+  ErrorStack err;
+  if (! cache.store(codeplug(), err))
+    logWarn() << "Cannot update codeplug cache: " << err.format();
+
   return true;
 }
 
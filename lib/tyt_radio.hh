@@ -5,9 +5,12 @@
 #ifndef TYT_RADIO_HH
 #define TYT_RADIO_HH
 
+#include <QSharedPointer>
 #include "radio.hh"
 #include "tyt_interface.hh"
 
+class TransferCheckpoint;
+
 /** Implements an USB interface to TYT & Retevis radios.
  *
  * @ingroup tyt */
@@ -42,6 +45,9 @@ private:
   virtual bool download();
   virtual bool upload();
   virtual bool uploadCallsigns();
+  /** Checks if the download can be resumed from the given, restored checkpoint. That is, the last
+   * block downloaded before the checkpoint matches the one on the device. */
+  bool resumeDownload(const TransferCheckpoint &checkpoint);
 
 protected:
   /** The interface to the radio. */
@@ -49,7 +55,7 @@ protected:
   /** Holds the flags to control assembly and upload of code-plugs. */
   Codeplug::Flags _codeplugFlags;
   /** The generic configuration. */
-	Config *_config;
+	QSharedPointer<Config> _config;
   /** A weak reference to the user-database. */
   UserDatabase *_userDB;
 };
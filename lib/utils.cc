@@ -1,8 +1,11 @@
 #include "utils.hh"
+#include "frequency.hh"
 #include <QRegExp>
 #include <QVector>
 #include <QHash>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 
 // Maps APRS icon number to code-char
 static QVector<char> aprsIconCodeTable{
@@ -103,83 +106,97 @@ static QHash<unsigned, QString> aprsIconNameTable{
   {(unsigned)APRSSystem::Icon::Yagi, "Yagi"},
   {(unsigned)APRSSystem::Icon::Shelter, "Shelter"}};
 
+size_t
+find_eos8(const uint8_t *data, size_t size, uint8_t eos) {
+  // Check 8 bytes at once for a 0x00 or eos byte (see "Bit Twiddling Hacks", haszero)
+  const uint64_t ones = 0x0101010101010101ULL, highs = 0x8080808080808080ULL;
+  const uint64_t pattern = ones*eos;
+  size_t i = 0;
+  for (; (i+8)<=size; i+=8) {
+    uint64_t word, other; memcpy(&word, data+i, 8); other = word ^ pattern;
+    if (((word-ones) & ~word & highs) | ((other-ones) & ~other & highs))
+      break;
+  }
+  // Locate the terminator within the last word
+  for (; (i<size) && (0x00 != data[i]) && (eos != data[i]); i++) ;
+  return i;
+}
+
+size_t
+find_eos16(const uint16_t *data, size_t size, uint16_t eos) {
+  // Check 4 words at once for an eos word
+  const uint64_t ones = 0x0001000100010001ULL, highs = 0x8000800080008000ULL;
+  const uint64_t pattern = ones*eos;
+  size_t i = 0;
+  for (; (i+4)<=size; i+=4) {
+    uint64_t word; memcpy(&word, data+i, 8); word ^= pattern;
+    if ((word-ones) & ~word & highs)
+      break;
+  }
+  for (; (i<size) && (eos != data[i]); i++) ;
+  return i;
+}
+
 QString
 decode_unicode(const uint16_t *data, size_t size, uint16_t fill) {
-  QString res; res.reserve(size);
-  for (size_t i=0; (i<size) && (fill!=data[i]); i++) {
-    res.append(QChar(data[i]));
-  }
+  size_t n = find_eos16(data, size, fill);
+  QString res(int(n), Qt::Uninitialized);
+  memcpy(res.data(), data, 2*n);
   return res;
 }
 
 void
 encode_unicode(uint16_t *data, const QString &text, size_t size, uint16_t fill) {
-  for (size_t i=0; (i<size); i++) {
-    if (i<size_t(text.size()))
-      data[i] = text.at(i).unicode();
-    else
-      data[i] = fill;
-  }
+  size_t n = std::min(size, size_t(text.size()));
+  memcpy(data, text.utf16(), 2*n);
+  std::fill(data+n, data+size, fill);
 }
 
 QString
 decode_ascii(const uint8_t *data, size_t size, uint16_t fill) {
-  QString res; res.reserve(size);
-  for (size_t i=0; (i<size) && (0!=data[i]) && (fill!=data[i]); i++)
-    res.append(QChar(data[i]));
-  return res;
+  // A fill word outside of the 8bit range never matches, only 0x00 terminates the string then
+  uint8_t eos = (0xff < fill) ? 0x00 : fill;
+  return QString::fromLatin1((const char *)data, int(find_eos8(data, size, eos)));
 }
 
 void
 encode_ascii(uint8_t *data, const QString &text, size_t size, uint16_t fill) {
-  for (size_t i=0; (i<size); i++) {
-    if (i<size_t(text.size()))
-      data[i] = text.at(i).toLatin1();
-    else
-      data[i] = fill;
-  }
+  size_t n = std::min(size, size_t(text.size()));
+  const ushort *src = text.utf16();
+  // Like QChar::toLatin1, chars outside of Latin-1 are encoded as 0x00. Branch-free, hence the
+  // compiler may vectorize this loop.
+  for (size_t i=0; i<n; i++)
+    data[i] = (0x100 > src[i]) ? src[i] : 0x00;
+  memset(data+n, fill, size-n);
 }
 
 QString
 decode_utf8(const uint8_t *data, size_t size, uint16_t fill) {
-  Q_UNUSED(fill)
-  return QString::fromUtf8((const char *)data, size);
+  uint8_t eos = (0xff < fill) ? 0x00 : fill;
+  return QString::fromUtf8((const char *)data, int(find_eos8(data, size, eos)));
 }
 
 void
 encode_utf8(uint8_t *data, const QString &text, size_t size, uint16_t fill) {
   QByteArray buffer = text.toUtf8();
-  memset(data, fill, size);
-  memcpy(data, buffer.data(), std::min(size_t(buffer.size()), size));
+  size_t n = std::min(size_t(buffer.size()), size);
+  // Do not split a multi-byte sequence if the string gets truncated
+  if (n < size_t(buffer.size())) {
+    while ((0 < n) && (0x80 == (uint8_t(buffer.at(n)) & 0xc0)))
+      n--;
+  }
+  memcpy(data, buffer.constData(), n);
+  memset(data+n, fill, size-n);
 }
 
 double
 decode_frequency(uint32_t bcd) {
-  double freq =
-      1e2  * ((bcd >> 28) & 0xf) +
-      1e1  * ((bcd >> 24) & 0xf) +
-      1.0  * ((bcd >> 20) & 0xf) +
-      1e-1 * ((bcd >> 16) & 0xf) +
-      1e-2 * ((bcd >> 12) & 0xf) +
-      1e-3 * ((bcd >>  8) & 0xf) +
-      1e-4 * ((bcd >>  4) & 0xf) +
-      1e-5 * ((bcd >>  0) & 0xf);
-  return freq;
+  return Frequency::fromBCD8(bcd).inMHz();
 }
 
 uint32_t
 encode_frequency(double freq) {
-  uint32_t hz = std::round(freq * 1e6);
-  uint32_t a  = (hz / 100000000) % 10;
-  uint32_t b  = (hz /  10000000) % 10;
-  uint32_t c  = (hz /   1000000) % 10;
-  uint32_t d  = (hz /    100000) % 10;
-  uint32_t e  = (hz /     10000) % 10;
-  uint32_t f  = (hz /      1000) % 10;
-  uint32_t g  = (hz /       100) % 10;
-  uint32_t h  = (hz /        10) % 10;
-
-  return (a << 28) + (b << 24) + (c << 20) + (d << 16) + (e << 12) + (f << 8) + (g << 4) + h;
+  return Frequency::fromMHz(freq).toBCD8();
 }
 
 
@@ -13,6 +13,13 @@
 #include "gpssystem.hh"
 #include <QGeoCoordinate>
 
+/** Returns the length of the 8bit string in @c data of at most @c size bytes, terminated by either
+ * 0x00 or @c eos. The string is scanned 8 bytes at a time. */
+size_t find_eos8(const uint8_t *data, size_t size, uint8_t eos=0x00);
+/** Returns the length of the 16bit string in @c data of at most @c size words, terminated by
+ * @c eos. The string is scanned 4 words at a time. */
+size_t find_eos16(const uint16_t *data, size_t size, uint16_t eos=0x0000);
+
 /** Decodes the unicode string stored in @c data of size @c size. The @c fill code also defines the
  * end-of-string symbol.
  * @returns The decoded string. */
@@ -21,18 +28,19 @@ QString decode_unicode(const uint16_t *data, size_t size, uint16_t fill=0x0000);
  * 16bit words in data. The @c fill word specifies the fill and end-of-string word. */
 void encode_unicode(uint16_t *data, const QString &text, size_t size, uint16_t fill=0x0000);
 
-/** Decodes the ascii string in @c data into a @c QString of up-to size length. The @c fill word
- * specifies the fill and end-of-string word. */
+/** Decodes the ascii (Latin-1) string in @c data into a @c QString of up-to size length. The
+ * @c fill word specifies the fill and end-of-string word. */
 QString decode_ascii(const uint8_t *data, size_t size, uint16_t fill=0x00);
-/** Encodes the given QString @c text of up-to size length as ASCII into @c data using the
- * @c fill word as fill and end-of-string word. */
+/** Encodes the given QString @c text of up-to size length as ASCII (Latin-1) into @c data using
+ * the @c fill word as fill and end-of-string word. */
 void encode_ascii(uint8_t *data, const QString &text, size_t size, uint16_t fill=0x00);
 
 /** Decodes the UTF-8 string in @c data into a @c QString of up-to size length. The @c fill word
  * specifies the fill and end-of-string word. */
 QString decode_utf8(const uint8_t *data, size_t size, uint16_t fill=0x00);
 /** Encodes the given QString @c text of up-to size length as UTF-8 into @c data using the
- * @c fill word as fill and end-of-string word. */
+ * @c fill word as fill and end-of-string word. A truncated string is cut at a character
+ * boundary. */
 void encode_utf8(uint8_t *data, const QString &text, size_t size, uint16_t fill=0x00);
 
 /** Decodes an 8 digit BCD encoded frequency (in MHz). */
@@ -8,6 +8,9 @@
 #include "logger.hh"
 #include "radio.hh"
 #include "codeplug.hh"
+#include "configsnapshot.hh"
+#include "confighistory.hh"
+#include "configverifier.hh"
 #include "config.h"
 #include "settings.hh"
 #include "radiolimits.hh"
@@ -54,8 +57,9 @@ inline QString getLocalePath(const QString &language) {
 }
 
 Application::Application(int &argc, char *argv[])
-  : QApplication(argc, argv), _config(nullptr), _mainWindow(nullptr), _translator(nullptr),
-    _repeater(nullptr), _lastDevice()
+  : QApplication(argc, argv), _config(nullptr), _history(nullptr), _verifier(nullptr), _mainWindow(nullptr), _translator(nullptr),
+    _repeater(nullptr), _lastDevice(), _resumeTransfer(false), _autosaveTimer(),
+    _autosavePending(false)
 {
   setApplicationName("qdmr");
   setOrganizationName("DM3MAT");
@@ -112,6 +116,13 @@ Application::Application(int &argc, char *argv[])
                    << "': " << err.format();
         return;
       }
+    } else if (ConfigSnapshot::isSnapshot(argv[1])) {
+      ErrorStack err;
+      if (! _config->readSnapshot(argv[1], err)) {
+        logError() << "Cannot read codeplug snapshot '" << argv[1]
+                   << "': " << err.format();
+        return;
+      }
     }
   }
 
@@ -132,6 +143,13 @@ Application::Application(int &argc, char *argv[])
 
   logDebug() << "Last known position: " << _currentPosition.toString();
   connect(_config, SIGNAL(modified(ConfigItem*)), this, SLOT(onConfigModifed()));
+  _history = new ConfigHistory(_config, this);
+  _verifier = new ConfigVerifier(_config, this);
+
+  // Auto-save snapshot of modified codeplug every minute
+  _autosaveTimer.setInterval(60000);
+  connect(&_autosaveTimer, SIGNAL(timeout()), this, SLOT(onAutosave()));
+  _autosaveTimer.start();
 }
 
 Application::~Application() {
@@ -199,6 +217,8 @@ Application::createMainWindow() {
   QAction *newCP   = _mainWindow->findChild<QAction*>("actionNewCodeplug");
   QAction *loadCP  = _mainWindow->findChild<QAction*>("actionOpenCodeplug");
   QAction *saveCP  = _mainWindow->findChild<QAction*>("actionSaveCodeplug");
+  QAction *undoCP  = _mainWindow->findChild<QAction*>("actionUndo");
+  QAction *redoCP  = _mainWindow->findChild<QAction*>("actionRedo");
 
   QAction *findDev = _mainWindow->findChild<QAction*>("actionDetectDevice");
   QAction *verCP   = _mainWindow->findChild<QAction*>("actionVerifyCodeplug");
@@ -217,6 +237,10 @@ Application::createMainWindow() {
   connect(newCP, SIGNAL(triggered()), this, SLOT(newCodeplug()));
   connect(loadCP, SIGNAL(triggered()), this, SLOT(loadCodeplug()));
   connect(saveCP, SIGNAL(triggered()), this, SLOT(saveCodeplug()));
+  connect(undoCP, SIGNAL(triggered()), this, SLOT(undo()));
+  connect(redoCP, SIGNAL(triggered()), this, SLOT(redo()));
+  connect(_history, SIGNAL(undoAvailable(bool)), undoCP, SLOT(setEnabled(bool)));
+  connect(_history, SIGNAL(redoAvailable(bool)), redoCP, SLOT(setEnabled(bool)));
   connect(quit, SIGNAL(triggered()), this, SLOT(quitApplication()));
   connect(about, SIGNAL(triggered()), this, SLOT(showAbout()));
   connect(sett, SIGNAL(triggered()), this, SLOT(showSettings()));
@@ -298,6 +322,29 @@ Application::createMainWindow() {
   }
 
   _mainWindow->restoreGeometry(settings.mainWindowState());
+
+  // Offer to recover codeplug from auto-save, if qdmr was not closed properly
+  if (QFile::exists(autosaveFilename())) {
+    bool recovered = false;
+    if (QMessageBox::Yes == QMessageBox::question(
+          nullptr, tr("Recover codeplug?"),
+          tr("qdmr was not closed properly. Do you want to recover the unsaved codeplug?"),
+          QMessageBox::Yes|QMessageBox::No)) {
+      ErrorStack err;
+      if ((recovered = _config->readSnapshot(autosaveFilename(), err))) {
+        _mainWindow->setWindowModified(true);
+      } else {
+        QMessageBox::critical(nullptr, tr("Cannot recover codeplug."),
+                              tr("Cannot recover codeplug: %1").arg(err.format()));
+        _config->clear();
+      }
+    }
+    removeAutosave();
+    // Keep recovered codeplug in auto-save until it gets saved
+    _autosavePending = recovered;
+    _history->reset();
+  }
+
   return _mainWindow;
 }
 
@@ -312,8 +359,12 @@ Application::newCodeplug() {
       return;
   }
 
+  _config->beginTransaction();
   _config->clear();
+  _config->commitTransaction();
   _config->setModified(false);
+  _history->reset();
+  removeAutosave();
 }
 
 
@@ -333,7 +384,8 @@ Application::loadCodeplug() {
   QString filename = QFileDialog::getOpenFileName(
         nullptr, tr("Open codeplug"),
         settings.lastDirectory().absolutePath(),
-        tr("Codeplug Files (*.yaml);;Codeplug Files, old format (*.conf *.csv *.txt);;All Files (*)"));
+        tr("Codeplug Files (*.yaml);;Codeplug Snapshots (*.qdmr);;"
+           "Codeplug Files, old format (*.conf *.csv *.txt);;All Files (*)"));
   if (filename.isEmpty())
     return;
   QFile file(filename);
@@ -352,6 +404,18 @@ Application::loadCodeplug() {
     ErrorStack err;
     if (_config->readYAML(filename, err)) {
       _mainWindow->setWindowModified(false);
+      removeAutosave();
+    } else {
+      QMessageBox::critical(nullptr, tr("Cannot read codeplug."),
+                            tr("Cannot read codeplug from file '%1': %2")
+                            .arg(filename).arg(err.format()));
+      _config->clear();
+    }
+  } else if (ConfigSnapshot::isSnapshot(filename)) {
+    ErrorStack err;
+    if (_config->readSnapshot(filename, err)) {
+      _mainWindow->setWindowModified(false);
+      removeAutosave();
     } else {
       QMessageBox::critical(nullptr, tr("Cannot read codeplug."),
                             tr("Cannot read codeplug from file '%1': %2")
@@ -370,6 +434,8 @@ Application::loadCodeplug() {
       _config->clear();
     }
   }
+
+  _history->reset();
 }
 
 
@@ -381,11 +447,25 @@ Application::saveCodeplug() {
   Settings settings;
   QString filename = QFileDialog::getSaveFileName(
         nullptr, tr("Save codeplug"), settings.lastDirectory().absolutePath(),
-        tr("Codeplug Files (*.yaml *.yml)"));
+        tr("Codeplug Files (*.yaml *.yml);;Codeplug Snapshots (*.qdmr)"));
 
   if (filename.isEmpty())
     return;
 
+  // Save as binary snapshot
+  if (filename.endsWith(".qdmr")) {
+    ErrorStack err;
+    if (_config->writeSnapshot(filename, err)) {
+      _mainWindow->setWindowModified(false);
+      removeAutosave();
+    } else {
+      QMessageBox::critical(nullptr, tr("Cannot save codeplug"),
+                            tr("Cannot save codeplug to file '%1': %2").arg(filename).arg(err.format()));
+    }
+    settings.setLastDirectoryDir(QFileInfo(filename).absoluteDir());
+    return;
+  }
+
   if (filename.endsWith(".conf") || filename.endsWith("csv")){
     QMessageBox::critical(nullptr, tr("Please use new YAML format."),
                           tr("Saving in the old table-based conf format was disabled with 0.9.0. "
@@ -408,6 +488,7 @@ Application::saveCodeplug() {
   QFileInfo info(filename);
   if (_config->toYAML(stream)) {
     _mainWindow->setWindowModified(false);
+    removeAutosave();
   } else {
     QMessageBox::critical(nullptr, tr("Cannot save codeplug"),
                           tr("Cannot save codeplug to file '%1'.").arg(filename));
@@ -434,10 +515,30 @@ Application::quitApplication() {
   if (_mainWindow)
     settings.setMainWindowState(_mainWindow->saveGeometry());
 
+  removeAutosave();
   quit();
 }
 
 
+void
+Application::undo() {
+  ErrorStack err;
+  if (! _history->undo(err)) {
+    if (! err.isEmpty())
+      ErrorMessageView(err).show();
+  }
+}
+
+void
+Application::redo() {
+  ErrorStack err;
+  if (! _history->redo(err)) {
+    if (! err.isEmpty())
+      ErrorMessageView(err).show();
+  }
+}
+
+
 Radio *
 Application::autoDetect(const ErrorStack &err) {
   // If the last detected device is still valid
@@ -478,6 +579,9 @@ Application::autoDetect(const ErrorStack &err) {
     return nullptr;
   }
 
+  // Verify the codeplug against the limits of the last detected radio in the background
+  _verifier->setRadio(radio, Settings().ignoreFrequencyLimits());
+
   return radio;
 }
 
@@ -509,8 +613,10 @@ Application::verifyCodeplug(Radio *radio, bool showSuccess) {
     return false;
   }
   Settings settings;
-  RadioLimitContext ctx(settings.ignoreFrequencyLimits());
-  myRadio->limits().verifyConfig(_config, ctx);
+  // Only elements modified since the last verification against radios of the same model and
+  // variant get verified
+  _verifier->setRadio(myRadio, settings.ignoreFrequencyLimits());
+  RadioLimitContext ctx = _verifier->issues();
   bool verified = true;
   if ( (settings.ignoreVerificationWarning() && (ctx.maxSeverity()>RadioLimitIssue::Warning)) ||
        ((!settings.ignoreVerificationWarning()) && (ctx.maxSeverity()>=RadioLimitIssue::Warning)) ) {
@@ -551,6 +657,10 @@ Application::downloadCodeplug() {
     return;
   }
 
+  // Resume download if retried
+  radio->setResume(_resumeTransfer);
+  _resumeTransfer = false;
+
   QProgressBar *progress = _mainWindow->findChild<QProgressBar *>("progress");
   progress->setValue(0); progress->setMaximum(100); progress->setVisible(true);
   connect(radio, SIGNAL(downloadProgress(int)), progress, SLOT(setValue(int)));
@@ -578,15 +688,30 @@ Application::onCodeplugDownloadError(Radio *radio) {
     radio->deleteLater();
 
   _mainWindow->setWindowModified(false);
+
+  if (QMessageBox::Retry == QMessageBox::question(
+        nullptr, tr("Read error"),
+        tr("The codeplug download was interrupted. Reconnect the radio and retry? If possible, "
+           "the download will be resumed where it was interrupted."),
+        QMessageBox::Cancel|QMessageBox::Retry)) {
+    _resumeTransfer = true;
+    downloadCodeplug();
+  }
 }
 
 
 void
 Application::onCodeplugDownloaded(Radio *radio, Codeplug *codeplug) {
+  ErrorStack err;
+  // Replace config at once
+  _config->beginTransaction();
   _config->clear();
+  bool decoded = codeplug->decode(_config, err);
+  _config->commitTransaction();
+  _history->reset();
+
   _mainWindow->setWindowModified(false);
-  ErrorStack err;
-  if (codeplug->decode(_config, err)) {
+  if (decoded) {
     _mainWindow->statusBar()->showMessage(tr("Read complete"));
     _mainWindow->findChild<QProgressBar *>("progress")->setVisible(false);
     _config->setModified(false);
@@ -688,6 +813,10 @@ Application::uploadCallsignDB() {
     _users->sortUsers(ids);
   }
 
+  // Resume upload if retried
+  radio->setResume(_resumeTransfer);
+  _resumeTransfer = false;
+
   // Assemble flags for callsign DB encoding
   CallsignDB::Selection css;
   if (settings.limitCallSignDBEntries()) {
@@ -700,7 +829,7 @@ Application::uploadCallsignDB() {
   progress->setVisible(true);
 
   connect(radio, SIGNAL(uploadProgress(int)), progress, SLOT(setValue(int)));
-  connect(radio, SIGNAL(uploadError(Radio *)), this, SLOT(onCodeplugUploadError(Radio *)));
+  connect(radio, SIGNAL(uploadError(Radio *)), this, SLOT(onCallsignDBUploadError(Radio *)));
   connect(radio, SIGNAL(uploadComplete(Radio *)), this, SLOT(onCodeplugUploaded(Radio *)));
 
   ErrorStack err;
@@ -726,6 +855,20 @@ Application::onCodeplugUploadError(Radio *radio) {
     radio->deleteLater();
 }
 
+void
+Application::onCallsignDBUploadError(Radio *radio) {
+  onCodeplugUploadError(radio);
+
+  if (QMessageBox::Retry == QMessageBox::question(
+        nullptr, tr("Write error"),
+        tr("The call-sign DB upload was interrupted. Reconnect the radio and retry? If possible, "
+           "the upload will be resumed where it was interrupted."),
+        QMessageBox::Cancel|QMessageBox::Retry)) {
+    _resumeTransfer = true;
+    uploadCallsignDB();
+  }
+}
+
 
 void
 Application::onCodeplugUploaded(Radio *radio) {
@@ -834,6 +977,36 @@ Application::onConfigModifed() {
     return;
 
   _mainWindow->setWindowModified(true);
+  _autosavePending = true;
+}
+
+void
+Application::onAutosave() {
+  if (! _autosavePending)
+    return;
+  _autosavePending = false;
+
+  QDir directory;
+  QString path = QFileInfo(autosaveFilename()).absolutePath();
+  if ((! directory.exists(path)) && (! directory.mkpath(path))) {
+    logWarn() << "Cannot create auto-save path '" << path << "'.";
+    return;
+  }
+
+  ErrorStack err;
+  if (! _config->writeSnapshot(autosaveFilename(), err))
+    logWarn() << "Cannot auto-save codeplug: " << err.format();
+}
+
+QString
+Application::autosaveFilename() const {
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/autosave.qdmr";
+}
+
+void
+Application::removeAutosave() {
+  _autosavePending = false;
+  QFile::remove(autosaveFilename());
 }
 
 void
@@ -4,6 +4,7 @@
 #include <QApplication>
 #include <QGroupBox>
 #include <QIcon>
+#include <QTimer>
 #include "config.hh"
 #include <QGeoPositionInfoSource>
 #include "releasenotes.hh"
@@ -25,6 +26,8 @@ class PositioningSystemListView;
 class RoamingChannelListView;
 class RoamingZoneListView;
 class ExtensionView;
+class ConfigHistory;
+class ConfigVerifier;
 
 class Application : public QApplication
 {
@@ -54,6 +57,9 @@ public slots:
   void saveCodeplug();
   void quitApplication();
 
+  void undo();
+  void redo();
+
   void detectRadio();
   bool verifyCodeplug(Radio *radio=nullptr, bool showSuccess=true);
 
@@ -72,16 +78,26 @@ private slots:
   void onCodeplugDownloaded(Radio *radio, Codeplug *codeplug);
 
   void onCodeplugUploadError(Radio *radio);
+  void onCallsignDBUploadError(Radio *radio);
   void onCodeplugUploaded(Radio *radio);
 
   void onConfigModifed();
+  void onAutosave();
 
   void positionUpdated(const QGeoPositionInfo &info);
 
   void onPaletteChanged(const QPalette &palette);
 
+protected:
+  QString autosaveFilename() const;
+  void removeAutosave();
+
 protected:
   Config *_config;
+  // Records the edits of the codeplug for undo & redo:
+  ConfigHistory *_history;
+  // Keeps the verification of the codeplug up to date:
+  ConfigVerifier *_verifier;
   QMainWindow *_mainWindow;
   QTranslator *_translator;
 
@@ -108,6 +124,11 @@ protected:
 
   // Last detected device:
   USBDeviceDescriptor _lastDevice;
+  // If set, the next transfer gets resumed from its last checkpoint:
+  bool _resumeTransfer;
+  // Periodically saves a snapshot of the modified codeplug for crash recovery:
+  QTimer _autosaveTimer;
+  bool _autosavePending;
 };
 
 #endif // APPLICATION_HH
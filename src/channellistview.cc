@@ -133,6 +133,7 @@ ChannelListView::onRemChannel() {
   QList<Channel *> channels; channels.reserve(rowcount);
   for(int row=rows.first; row<=rows.second; row++)
     channels.push_back(_config->channelList()->channel(row));
+  Config::Transaction transaction(_config);
   // remove channels
   foreach (Channel *channel, channels)
     _config->channelList()->del(channel);
@@ -19,6 +19,8 @@ GenericListWrapper::GenericListWrapper(AbstractConfigObjectList *list, QObject *
   connect(_list, SIGNAL(elementAdded(int)), this, SLOT(onItemAdded(int)));
   connect(_list, SIGNAL(elementModified(int)), this, SLOT(onItemModified(int)));
   connect(_list, SIGNAL(elementRemoved(int)), this, SLOT(onItemRemoved(int)));
+  connect(_list, SIGNAL(elementsModified(int,int)), this, SLOT(onItemsModified(int,int)));
+  connect(_list, SIGNAL(elementsReset()), this, SLOT(onItemsReset()));
 }
 
 int
@@ -107,6 +109,17 @@ GenericListWrapper::onItemModified(int idx) {
   emit dataChanged(index(idx),index(idx));
 }
 
+void
+GenericListWrapper::onItemsModified(int first, int last) {
+  emit dataChanged(index(first),index(last));
+}
+
+void
+GenericListWrapper::onItemsReset() {
+  beginResetModel();
+  endResetModel();
+}
+
 
 /* ********************************************************************************************* *
  * Implementation of GenericTableWrapper
@@ -121,6 +134,8 @@ GenericTableWrapper::GenericTableWrapper(AbstractConfigObjectList *list, QObject
   connect(_list, SIGNAL(elementAdded(int)), this, SLOT(onItemAdded(int)));
   connect(_list, SIGNAL(elementModified(int)), this, SLOT(onItemModified(int)));
   connect(_list, SIGNAL(elementRemoved(int)), this, SLOT(onItemRemoved(int)));
+  connect(_list, SIGNAL(elementsModified(int,int)), this, SLOT(onItemsModified(int,int)));
+  connect(_list, SIGNAL(elementsReset()), this, SLOT(onItemsReset()));
 }
 
 int
@@ -200,6 +215,17 @@ GenericTableWrapper::onItemModified(int idx) {
   emit dataChanged(index(idx,0),index(idx,columnCount()-1));
 }
 
+void
+GenericTableWrapper::onItemsModified(int first, int last) {
+  emit dataChanged(index(first,0),index(last,columnCount()-1));
+}
+
+void
+GenericTableWrapper::onItemsReset() {
+  beginResetModel();
+  endResetModel();
+}
+
 
 /* ********************************************************************************************* *
  * Implementation of ChannelListWrapper
@@ -40,6 +40,10 @@ protected slots:
   void onItemRemoved(int idx);
   /** Internal callback on modified channels. */
   void onItemModified(int idx);
+  /** Internal callback on a range of modified items after a batch update. */
+  void onItemsModified(int first, int last);
+  /** Internal callback on added or removed items after a batch update. */
+  void onItemsReset();
 
 protected:
   /** Holds a weak reference to the list object. */
@@ -81,6 +85,10 @@ protected slots:
   void onItemRemoved(int idx);
   /** Internal callback on modified channels. */
   void onItemModified(int idx);
+  /** Internal callback on a range of modified items after a batch update. */
+  void onItemsModified(int first, int last);
+  /** Internal callback on added or removed items after a batch update. */
+  void onItemsReset();
 
 protected:
   /** Holds a weak reference to the list object. */
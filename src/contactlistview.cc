@@ -84,6 +84,7 @@ ContactListView::onRemContact() {
   QList<Contact *> contacts; contacts.reserve(numrows);
   for (int i=rows.first; i<=rows.second; i++)
     contacts.push_back(_config->contacts()->contact(i));
+  Config::Transaction transaction(_config);
   // remove contacts
   foreach (Contact *contact, contacts)
     _config->contacts()->del(contact);
@@ -65,6 +65,7 @@ GroupListsView::onRemRxGroup() {
   QList<RXGroupList *> lists; lists.reserve(rowcount);
   for (int row=rows.first; row<=rows.second; row++)
     lists.push_back(_config->rxGroupLists()->list(row));
+  Config::Transaction transaction(_config);
   // remove list
   foreach (RXGroupList *list, lists)
     _config->rxGroupLists()->del(list);
@@ -93,6 +93,7 @@ PositioningSystemListView::onRemGPS() {
   QList<PositioningSystem *> systems; systems.reserve(rowcount);
   for(int row=rows.first; row<=rows.second; row++)
     systems.push_back(_config->posSystems()->system(row));
+  Config::Transaction transaction(_config);
   // remove systems
   foreach (PositioningSystem *system, systems)
     _config->posSystems()->del(system);
@@ -80,6 +80,7 @@ RadioIDListView::onDeleteID() {
   QList<DMRRadioID *> ids; ids.reserve(numrows);
   for(int i=rows.first; i<=rows.second; i++)
     ids.push_back(_config->radioIDs()->getId(i));
+  Config::Transaction transaction(_config);
   // remove
   foreach (DMRRadioID *id, ids)
     _config->radioIDs()->del(id);
@@ -42,7 +42,7 @@ inline QString bandName(double rx, double tx) {
  * RepeaterBookEntry
  * ********************************************************************************************* */
 RepeaterBookEntry::RepeaterBookEntry(QObject *parent)
-  : QObject(parent), _id(), _call(), _location(), _qth(), _rxFrequency(0), _txFrequency(0),
+  : QObject(parent), _id(), _call(), _location(), _qth(), _rxFrequency(), _txFrequency(),
     _isFM(false), _isDMR(false), _rxTone(Signaling::SIGNALING_NONE),
     _txTone(Signaling::SIGNALING_NONE), _colorCode(0), _timestamp(QDateTime::currentDateTime())
 {
@@ -76,7 +76,7 @@ RepeaterBookEntry::operator =(const RepeaterBookEntry &other) {
 
 bool
 RepeaterBookEntry::isValid() const {
-  return (!_call.isEmpty()) && (0!=_rxFrequency) && (0!=_txFrequency);
+  return (!_call.isEmpty()) && (! _rxFrequency.isNull()) && (! _txFrequency.isNull());
 }
 
 const QString &
@@ -106,11 +106,11 @@ RepeaterBookEntry::qth() const {
 
 double
 RepeaterBookEntry::rxFrequency() const {
-  return _rxFrequency;
+  return _rxFrequency.inMHz();
 }
 double
 RepeaterBookEntry::txFrequency() const {
-  return _txFrequency;
+  return _txFrequency.inMHz();
 }
 
 bool
@@ -151,8 +151,8 @@ RepeaterBookEntry::fromRepeaterBook(const QJsonObject &obj) {
 
   // Handle basic properties
   _call = obj["Callsign"].toString();
-  _rxFrequency = obj["Frequency"].toString().toDouble();
-  _txFrequency = obj["Input Freq"].toString().toDouble();
+  _rxFrequency = Frequency::fromMHz(obj["Frequency"].toString().toDouble());
+  _txFrequency = Frequency::fromMHz(obj["Input Freq"].toString().toDouble());
   _location = QGeoCoordinate(obj["Lat"].toString().toDouble(), obj["Long"].toString().toDouble());
   _qth = obj["Nearest City"].toString();
 
@@ -182,8 +182,8 @@ RepeaterBookEntry::fromCache(const QJsonObject &obj) {
   _id = obj["id"].toString();
   // Handle basic properties
   _call = obj["Callsign"].toString();
-  _rxFrequency = obj["Frequency"].toDouble();
-  _txFrequency = obj["Input Freq"].toDouble();
+  _rxFrequency = Frequency::fromMHz(obj["Frequency"].toDouble());
+  _txFrequency = Frequency::fromMHz(obj["Input Freq"].toDouble());
   _location = QGeoCoordinate(obj["Lat"].toDouble(), obj["Long"].toDouble());
   _qth = obj["Nearest City"].toString();
   _isFM = obj["FM Analog"].toBool();
@@ -209,8 +209,8 @@ RepeaterBookEntry::toCache() const {
   QJsonObject obj;
   obj.insert("id", _id);
   obj.insert("Callsign", _call);
-  obj.insert("Frequency", _rxFrequency);
-  obj.insert("Input Freq", _txFrequency);
+  obj.insert("Frequency", _rxFrequency.inMHz());
+  obj.insert("Input Freq", _txFrequency.inMHz());
   obj.insert("Lat", _location.latitude());
   obj.insert("Long", _location.longitude());
   obj.insert("Nearest City", _qth);
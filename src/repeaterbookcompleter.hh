@@ -45,8 +45,8 @@ protected:
   QString _call;
   QGeoCoordinate _location;
   QString _qth;
-  double _rxFrequency;
-  double _txFrequency;
+  Frequency _rxFrequency;
+  Frequency _txFrequency;
   bool _isFM;
   bool _isDMR;
   Signaling::Code _rxTone;
@@ -83,6 +83,7 @@ RoamingChannelListView::onRemChannel() {
   QList<RoamingChannel *> lists; lists.reserve(rowcount);
   for (int row=rows.first; row<=rows.second; row++)
     lists.push_back(_config->roamingChannels()->channel(row));
+  Config::Transaction transaction(_config);
   // remove
   foreach (RoamingChannel *channel, lists)
     _config->roamingChannels()->del(channel);
@@ -107,6 +107,7 @@ RoamingZoneListView::onRemRoamingZone() {
   QList<RoamingZone *> lists; lists.reserve(rowcount);
   for (int row=rows.first; row<=rows.second; row++)
     lists.push_back(_config->roamingZones()->zone(row));
+  Config::Transaction transaction(_config);
   // remove
   foreach (RoamingZone *zone, lists)
     _config->roamingZones()->del(zone);
@@ -63,6 +63,7 @@ ScanListsView::onRemScanList() {
   QList<ScanList *> lists; lists.reserve(rowcount);
   for (int row=rows.first; row<=rows.second; row++)
     lists.push_back(_config->scanlists()->scanlist(row));
+  Config::Transaction transaction(_config);
   // remove
   foreach (ScanList *list, lists)
     _config->scanlists()->del(list);
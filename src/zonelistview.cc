@@ -62,6 +62,7 @@ ZoneListView::onRemZone() {
   QList<Zone *> lists; lists.reserve(rowcount);
   for(int row=rows.first; row<=rows.second; row++)
     lists.push_back(_config->zones()->zone(row));
+  Config::Transaction transaction(_config);
   // remove
   foreach (Zone *zone, lists)
     _config->zones()->del(zone);
@@ -0,0 +1,265 @@
+#include "codeplugtest.hh"
+#include "config.hh"
+#include "radioinfo.hh"
+#include "rd5r_codeplug.hh"
+#include "gd77_codeplug.hh"
+#include "opengd77_codeplug.hh"
+#include "md390_codeplug.hh"
+#include "uv390_codeplug.hh"
+#include "md2017_codeplug.hh"
+#include "dm1701_codeplug.hh"
+#include "d868uv_codeplug.hh"
+#include "d878uv_codeplug.hh"
+#include "d878uv2_codeplug.hh"
+#include "d578uv_codeplug.hh"
+#include "dmr6x2uv_codeplug.hh"
+#include "errorstack.hh"
+#include "encodingcache.hh"
+#include <QtEndian>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QScopedPointer>
+#include <QTest>
+
+/** Creates an empty codeplug for the given radio. */
+static Codeplug *
+createCodeplug(int radio) {
+  switch (radio) {
+  case RadioInfo::OpenGD77: return new OpenGD77Codeplug();
+  case RadioInfo::RD5R: return new RD5RCodeplug();
+  case RadioInfo::GD77: return new GD77Codeplug();
+  case RadioInfo::MD390: return new MD390Codeplug();
+  case RadioInfo::UV390: return new UV390Codeplug();
+  case RadioInfo::MD2017: return new MD2017Codeplug();
+  case RadioInfo::DM1701: return new DM1701Codeplug();
+  case RadioInfo::D868UVE: return new D868UVCodeplug();
+  case RadioInfo::DMR6X2UV: return new DMR6X2UVCodeplug();
+  case RadioInfo::D878UV: return new D878UVCodeplug();
+  case RadioInfo::D878UVII: return new D878UV2Codeplug();
+  case RadioInfo::D578UV: return new D578UVCodeplug();
+  }
+  return nullptr;
+}
+
+/** Encodes the given configuration and returns all elements of all images as a single array. */
+static bool
+encode(int radio, Config *config, bool concurrent, QByteArray &result, const ErrorStack &err) {
+  Codeplug::Flags flags;
+  flags.updateCodePlug = false;
+  flags.concurrentEncoding = concurrent;
+
+  Codeplug *codeplug = createCodeplug(radio);
+  codeplug->clear();
+  if (! codeplug->encode(config, flags, err)) {
+    delete codeplug;
+    return false;
+  }
+
+  result.clear();
+  for (int i=0; i<codeplug->numImages(); i++) {
+    const DFUFile::Image &image = codeplug->image(i);
+    for (int j=0; j<image.numElements(); j++) {
+      uint32_t addr = qToLittleEndian(image.element(j).address());
+      result.append((const char *)&addr, sizeof(uint32_t));
+      result.append(image.element(j).data());
+    }
+  }
+
+  delete codeplug;
+  return true;
+}
+
+
+CodeplugTest::CodeplugTest(QObject *parent)
+  : QObject(parent)
+{
+  // pass...
+}
+
+void
+CodeplugTest::initTestCase() {
+  ErrorStack err;
+  if (! _basicConfig.readYAML(":/data/config_test.yaml", err)) {
+    QFAIL(QString("Cannot open codeplug file: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+}
+
+void
+CodeplugTest::cleanupTestCase() {
+  // clear codeplug
+  _basicConfig.clear();
+}
+
+void
+CodeplugTest::testConcurrentEncoding_data() {
+  QTest::addColumn<int>("radio");
+  QTest::newRow("RD5R") << int(RadioInfo::RD5R);
+  QTest::newRow("GD77") << int(RadioInfo::GD77);
+  QTest::newRow("OpenGD77") << int(RadioInfo::OpenGD77);
+  QTest::newRow("MD390") << int(RadioInfo::MD390);
+  QTest::newRow("UV390") << int(RadioInfo::UV390);
+  QTest::newRow("MD2017") << int(RadioInfo::MD2017);
+  QTest::newRow("DM1701") << int(RadioInfo::DM1701);
+  QTest::newRow("D868UVE") << int(RadioInfo::D868UVE);
+  QTest::newRow("D878UV") << int(RadioInfo::D878UV);
+  QTest::newRow("D878UVII") << int(RadioInfo::D878UVII);
+  QTest::newRow("D578UV") << int(RadioInfo::D578UV);
+  QTest::newRow("DMR6X2UV") << int(RadioInfo::DMR6X2UV);
+}
+
+void
+CodeplugTest::testConcurrentEncoding() {
+  QFETCH(int, radio);
+
+  // Some codeplugs contain a time-stamp. Hence the concurrent encoding is framed by two
+  // sequential ones, that must be identical.
+  QByteArray before, concurrent, after;
+  for (int attempt=0; attempt<3; attempt++) {
+    ErrorStack err;
+    if ((! encode(radio, &_basicConfig, false, before, err)) ||
+        (! encode(radio, &_basicConfig, true, concurrent, err)) ||
+        (! encode(radio, &_basicConfig, false, after, err))) {
+      QFAIL(QString("Cannot encode codeplug: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+    if (before == after)
+      break;
+  }
+
+  QVERIFY(before == after);
+  QVERIFY(concurrent == before);
+}
+
+void
+CodeplugTest::testEncodingCache() {
+  ErrorStack err;
+
+  // Same config yields the same hash, keys differ by radio and flags
+  QByteArray hash1, hash2;
+  QVERIFY(EncodingCache::hashConfig(&_basicConfig, hash1, err));
+  QVERIFY(EncodingCache::hashConfig(&_basicConfig, hash2, err));
+  QCOMPARE(hash1, hash2);
+
+  Codeplug::Flags flags, gpsFlags;
+  gpsFlags.autoEnableGPS = true;
+  QString key = EncodingCache::key(hash1, "d878uv", flags);
+  QCOMPARE(EncodingCache::key(hash2, "d878uv", flags), key);
+  QVERIFY(EncodingCache::key(hash1, "uv390", flags) != key);
+  QVERIFY(EncodingCache::key(hash1, "d878uv", gpsFlags) != key);
+
+  // A modified config yields a different hash
+  Config config;
+  QVERIFY(config.copy(_basicConfig));
+  config.channelList()->channel(0)->setName("Changed");
+  QByteArray hash3;
+  QVERIFY(EncodingCache::hashConfig(&config, hash3, err));
+  QVERIFY(hash3 != hash1);
+
+  // Store, lookup and evict
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  EncodingCache cache(dir.filePath("cache"), 1);
+  QFile file(dir.filePath("codeplug.dfu"));
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("codeplug");
+  file.close();
+
+  QVERIFY(! cache.contains(key));
+  QVERIFY(! cache.lookup(key, dir.filePath("output.dfu"), err));
+  QVERIFY(cache.store(key, file.fileName(), err));
+  QVERIFY(cache.lookup(key, dir.filePath("output.dfu"), err));
+  QFile output(dir.filePath("output.dfu"));
+  QVERIFY(output.open(QIODevice::ReadOnly));
+  QCOMPARE(output.readAll(), QByteArray("codeplug"));
+  output.close();
+
+  QString other = EncodingCache::key(hash3, "d878uv", flags);
+  QVERIFY(cache.store(other, file.fileName(), err));
+  QCOMPARE(cache.evict(), 1);
+  QVERIFY(cache.contains(key) != cache.contains(other));
+}
+
+QTEST_GUILESS_MAIN(CodeplugTest)
+
+void
+CodeplugTest::testIncrementalEncoding_data() {
+  QTest::addColumn<int>("radio");
+  QTest::newRow("D868UVE") << int(RadioInfo::D868UVE);
+  QTest::newRow("D878UV") << int(RadioInfo::D878UV);
+  QTest::newRow("D878UVII") << int(RadioInfo::D878UVII);
+  QTest::newRow("D578UV") << int(RadioInfo::D578UV);
+  QTest::newRow("DMR6X2UV") << int(RadioInfo::DMR6X2UV);
+}
+
+void
+CodeplugTest::testIncrementalEncoding() {
+  QFETCH(int, radio);
+
+  // Element of the first channel, same for all AnyTone codeplugs
+  const uint32_t channelAddr = 0x00800000, channelSize = 0x40;
+
+  ErrorStack err;
+  Config config;
+  if (! config.readYAML(":/data/config_test.yaml", err)) {
+    QFAIL(QString("Cannot open codeplug file: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+
+  Codeplug::Flags flags;
+  flags.updateCodePlug = false;
+
+  QScopedPointer<Codeplug> codeplug(createCodeplug(radio));
+  codeplug->enableIncrementalEncoding(true);
+  codeplug->clear();
+  if (! codeplug->encode(&config, flags, err)) {
+    QFAIL(QString("Cannot encode codeplug: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+
+  // Mark the entire memory except for the element of the first channel, then modify that channel
+  for (int i=0; i<codeplug->numImages(); i++) {
+    for (int j=0; j<codeplug->image(i).numElements(); j++) {
+      DFUFile::Element &element = codeplug->image(i).element(j);
+      for (int k=0; k<element.data().size(); k++) {
+        uint32_t addr = element.address() + k;
+        if ((addr < channelAddr) || (addr >= (channelAddr+channelSize)))
+          element.data()[k] = char(0xaa);
+      }
+    }
+  }
+  config.channelList()->channel(0)->setName("Changed");
+  if (! codeplug->encode(&config, flags, err)) {
+    QFAIL(QString("Cannot encode modified channel: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+
+  // Only the element of the channel must be rewritten and equal the complete encoding
+  QScopedPointer<Codeplug> reference(createCodeplug(radio));
+  reference->clear();
+  if (! reference->encode(&config, flags, err)) {
+    QFAIL(QString("Cannot encode codeplug: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+  for (int i=0; i<codeplug->numImages(); i++) {
+    for (int j=0; j<codeplug->image(i).numElements(); j++) {
+      const DFUFile::Element &element = codeplug->image(i).element(j);
+      for (int k=0; k<element.data().size(); k++) {
+        uint32_t addr = element.address() + k;
+        if ((addr >= channelAddr) && (addr < (channelAddr+channelSize)))
+          QCOMPARE(uint8_t(element.data().at(k)), reference->data(addr, i)[0]);
+        else
+          QCOMPARE(uint8_t(element.data().at(k)), uint8_t(0xaa));
+      }
+    }
+  }
+
+  // Adding a channel shifts indices, hence the next encoding is complete
+  config.channelList()->add(config.channelList()->channel(0)->clone()->as<Channel>());
+  if (! codeplug->encode(&config, flags, err)) {
+    QFAIL(QString("Cannot encode codeplug: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+  QByteArray marked(channelSize, char(0xaa));
+  QVERIFY(0 != memcmp(codeplug->data(channelAddr+channelSize), marked.constData(), channelSize));
+}
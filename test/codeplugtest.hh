@@ -0,0 +1,29 @@
+#ifndef CODEPLUGTEST_HH
+#define CODEPLUGTEST_HH
+
+
+#include <QObject>
+#include "config.hh"
+
+class CodeplugTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit CodeplugTest(QObject *parent = nullptr);
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+
+  void testConcurrentEncoding_data();
+  void testConcurrentEncoding();
+  void testEncodingCache();
+  void testIncrementalEncoding_data();
+  void testIncrementalEncoding();
+
+protected:
+  Config _basicConfig;
+};
+
+#endif // CODEPLUGTEST_HH
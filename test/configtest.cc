@@ -1,8 +1,85 @@
 #include "configtest.hh"
 #include "config.hh"
 #include "errorstack.hh"
+#include "configsnapshot.hh"
+#include "confighistory.hh"
+#include "configreference.hh"
 #include <iostream>
 #include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QMetaProperty>
+
+
+/* Compares all properties of the given objects recursively. Elements of lists get mapped to their
+ * copies, references are collected and checked against this mapping, once all elements are
+ * known. */
+static bool
+compareProperties(const QObject *a, const QObject *b, QHash<const QObject *, const QObject *> &map,
+                  QList<QPair<const QObject *, const QObject *>> &refs, QString &msg)
+{
+  const QMetaObject *meta = a->metaObject();
+  if (meta != b->metaObject()) {
+    msg = QString("Expected %1, got %2.").arg(meta->className()).arg(b->metaObject()->className());
+    return false;
+  }
+  if (map.contains(a))
+    return true;
+  map.insert(a, b);
+
+  for (int i=QObject::staticMetaObject.propertyCount(); i<meta->propertyCount(); i++) {
+    QMetaProperty prop = meta->property(i);
+    QString path = QString("%1.%2").arg(meta->className()).arg(prop.name());
+    QVariant va = prop.read(a), vb = prop.read(b);
+    if (prop.isEnumType()) {
+      if (va.toInt() != vb.toInt()) {
+        msg = QString("%1: Expected %2, got %3.").arg(path).arg(va.toInt()).arg(vb.toInt());
+        return false;
+      }
+    } else if (QMetaType::typeFlags(prop.userType()) & QMetaType::PointerToQObject) {
+      QObject *oa = va.value<QObject *>(), *ob = vb.value<QObject *>();
+      if ((nullptr == oa) != (nullptr == ob)) {
+        msg = QString("%1: Only one of both is set.").arg(path);
+        return false;
+      }
+      if (nullptr == oa)
+        continue;
+      if (ConfigObjectList *la = qobject_cast<ConfigObjectList *>(oa)) {
+        ConfigObjectList *lb = qobject_cast<ConfigObjectList *>(ob);
+        if (la->count() != lb->count()) {
+          msg = QString("%1: Expected %2 elements, got %3.").arg(path).arg(la->count()).arg(lb->count());
+          return false;
+        }
+        for (int j=0; j<la->count(); j++) {
+          if (! compareProperties(la->get(j), lb->get(j), map, refs, msg)) {
+            msg = QString("%1[%2]: %3").arg(path).arg(j).arg(msg);
+            return false;
+          }
+        }
+      } else if (ConfigObjectRefList *la = qobject_cast<ConfigObjectRefList *>(oa)) {
+        ConfigObjectRefList *lb = qobject_cast<ConfigObjectRefList *>(ob);
+        if (la->count() != lb->count()) {
+          msg = QString("%1: Expected %2 references, got %3.").arg(path).arg(la->count()).arg(lb->count());
+          return false;
+        }
+        for (int j=0; j<la->count(); j++)
+          refs.append(QPair<const QObject *, const QObject *>(la->get(j), lb->get(j)));
+      } else if (ConfigObjectReference *ra = qobject_cast<ConfigObjectReference *>(oa)) {
+        ConfigObjectReference *rb = qobject_cast<ConfigObjectReference *>(ob);
+        refs.append(QPair<const QObject *, const QObject *>(
+                      ra->as<ConfigObject>(), rb->as<ConfigObject>()));
+      } else if (! compareProperties(oa, ob, map, refs, msg)) {
+        msg = QString("%1: %2").arg(path).arg(msg);
+        return false;
+      }
+    } else if (va != vb) {
+      msg = QString("%1: Expected '%2', got '%3'.").arg(path).arg(va.toString()).arg(vb.toString());
+      return false;
+    }
+  }
+
+  return true;
+}
 
 
 ConfigTest::ConfigTest(QObject *parent) : QObject(parent)
@@ -33,6 +110,286 @@ ConfigTest::testCloneChannelBasic() {
   QCOMPARE(clone->compare(*_config.channelList()->channel(0)), 0);
 }
 
+void
+ConfigTest::testListIndex() {
+  ContactList list;
+  QVector<DMRContact *> contacts;
+  for (unsigned i=0; i<10; i++) {
+    contacts.append(new DMRContact(DMRContact::PrivateCall, QString("Contact %1").arg(i), i+1));
+    list.add(contacts.back());
+  }
+
+  // Insert at front, the index must match the list position right away
+  DMRContact *first = new DMRContact(DMRContact::GroupCall, "First", 100);
+  QCOMPARE(list.add(first, 0), 0);
+  for (int i=0; i<list.count(); i++)
+    QCOMPARE(list.indexOf(list.get(i)), i);
+  QVERIFY(list.take(contacts.at(0)));
+  QCOMPARE(list.indexOf(first), 0);
+  QCOMPARE(list.add(contacts.at(0), 1), 1);
+  for (int i=0; i<list.count(); i++)
+    QCOMPARE(list.indexOf(list.get(i)), i);
+
+  // Move and remove elements
+  QVERIFY(list.moveDown(0));
+  QVERIFY(list.moveUp(5, 7));
+  QVERIFY(list.del(contacts.at(2)));
+  QVERIFY(! list.has(contacts.at(2)));
+  QCOMPARE(list.add(first), -1);
+
+  // Index must match list position
+  for (int i=0; i<list.count(); i++)
+    QCOMPARE(list.indexOf(list.get(i)), i);
+
+  // Modification must be signaled with the correct index
+  QSignalSpy spy(&list, SIGNAL(elementModified(int)));
+  contacts.at(9)->setName("Modified");
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(spy.at(0).at(0).toInt(), list.indexOf(contacts.at(9)));
+
+  // Deleting an element must remove it from the list
+  delete contacts.at(5);
+  QCOMPARE(list.count(), 9);
+  for (int i=0; i<list.count(); i++)
+    QCOMPARE(list.indexOf(list.get(i)), i);
+}
+
+void
+ConfigTest::testLookupIndex() {
+  ChannelList channels;
+  DMRChannel *dmr = new DMRChannel();
+  dmr->setRXFrequency(439.5625); dmr->setTXFrequency(431.9625);
+  dmr->setTimeSlot(DMRChannel::TimeSlot::TS2); dmr->setColorCode(1);
+  channels.add(dmr);
+  FMChannel *fm = new FMChannel();
+  fm->setRXFrequency(145.6); fm->setTXFrequency(145.0);
+  channels.add(fm);
+
+  QCOMPARE(channels.findDMRChannel(439.5625, 431.9625, DMRChannel::TimeSlot::TS2, 1), dmr);
+  QVERIFY(nullptr == channels.findDMRChannel(439.5625, 431.9625, DMRChannel::TimeSlot::TS1, 1));
+  QCOMPARE(channels.findFMChannelByTxFreq(145.0), fm);
+
+  // Modified channels must be found by their new key only
+  dmr->setColorCode(2);
+  QVERIFY(nullptr == channels.findDMRChannel(439.5625, 431.9625, DMRChannel::TimeSlot::TS2, 1));
+  QCOMPARE(channels.findDMRChannel(439.5625, 431.9625, DMRChannel::TimeSlot::TS2, 2), dmr);
+
+  // The first of several matching channels must be found
+  FMChannel *other = new FMChannel();
+  other->setTXFrequency(145.0);
+  channels.add(other, 0);
+  QCOMPARE(channels.findFMChannelByTxFreq(145.0), other);
+  QVERIFY(channels.moveDown(0, 1));
+  QCOMPARE(channels.findFMChannelByTxFreq(145.0), fm);
+
+  // Removed and deleted channels must not be found
+  QVERIFY(channels.take(fm));
+  QCOMPARE(channels.findFMChannelByTxFreq(145.0), other);
+  delete other;
+  QVERIFY(nullptr == channels.findFMChannelByTxFreq(145.0));
+  delete fm;
+
+  ContactList contacts;
+  DMRContact *contact = new DMRContact(DMRContact::PrivateCall, "Contact", 1234567);
+  contacts.add(contact);
+  QCOMPARE(contacts.findDigitalContact(1234567), contact);
+  contact->setNumber(7654321);
+  QVERIFY(nullptr == contacts.findDigitalContact(1234567));
+  QCOMPARE(contacts.findDigitalContact(7654321), contact);
+  contacts.clear();
+  QVERIFY(nullptr == contacts.findDigitalContact(7654321));
+}
+
+void
+ConfigTest::testTransaction() {
+  Config config;
+  config.contacts()->add(new DMRContact(DMRContact::GroupCall, "Group", 1));
+
+  QSignalSpy added(config.contacts(), SIGNAL(elementAdded(int)));
+  QSignalSpy modified(config.contacts(), SIGNAL(elementModified(int)));
+  QSignalSpy reset(config.contacts(), SIGNAL(elementsReset()));
+  QSignalSpy rangeModified(config.contacts(), SIGNAL(elementsModified(int,int)));
+  QSignalSpy configModified(&config, SIGNAL(modified(ConfigItem*)));
+
+  // Added elements are signaled as reset
+  {
+    Config::Transaction transaction(&config);
+    for (unsigned i=0; i<10; i++)
+      config.contacts()->add(new DMRContact(DMRContact::PrivateCall, QString("Contact %1").arg(i), i+2));
+    QVERIFY(config.inTransaction());
+    QCOMPARE(added.count(), 0);
+    QCOMPARE(configModified.count(), 0);
+  }
+  QVERIFY(! config.inTransaction());
+  QCOMPARE(reset.count(), 1);
+  QCOMPARE(configModified.count(), 1);
+
+  // Modifications are coalesced into a single range
+  config.beginTransaction();
+  config.contacts()->contact(3)->setName("Modified 3");
+  config.contacts()->contact(7)->setName("Modified 7");
+  config.commitTransaction();
+  QCOMPARE(modified.count(), 0);
+  QCOMPARE(rangeModified.count(), 1);
+  QCOMPARE(rangeModified.at(0).at(0).toInt(), 3);
+  QCOMPARE(rangeModified.at(0).at(1).toInt(), 7);
+  QCOMPARE(configModified.count(), 2);
+}
+
+void
+ConfigTest::testNextId() {
+  DMRContact a(DMRContact::PrivateCall, "A", 1), b(DMRContact::PrivateCall, "B", 2),
+      c(DMRContact::PrivateCall, "C", 3);
+
+  // Existing IDs (e.g., from a parsed file) must be skipped
+  ConfigItem::Context context;
+  QVERIFY(context.add("cont2", &a));
+  QCOMPARE(context.nextId("cont"), QString("cont1"));
+  QVERIFY(context.add(context.nextId("cont"), &b));
+  QCOMPARE(context.nextId("cont"), QString("cont3"));
+  QVERIFY(context.add(context.nextId("cont"), &c));
+  QCOMPARE(context.nextId("cont"), QString("cont4"));
+  // Counters are kept per prefix
+  QCOMPARE(context.nextId("ch"), QString("ch1"));
+}
+
+void
+ConfigTest::testSnapshot() {
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  QString filename = dir.filePath("test.qdmr");
+
+  ErrorStack err;
+  if (! _config.writeSnapshot(filename, err))
+    QFAIL(QString("Cannot write snapshot: %1").arg(err.format()).toStdString().c_str());
+  QVERIFY(ConfigSnapshot::isSnapshot(filename));
+
+  Config copy;
+  if (! copy.readSnapshot(filename, err))
+    QFAIL(QString("Cannot read snapshot: %1").arg(err.format()).toStdString().c_str());
+
+  // Snapshot must reproduce the same YAML document
+  QString original, restored;
+  QTextStream originalStream(&original), restoredStream(&restored);
+  QVERIFY(_config.toYAML(originalStream));
+  QVERIFY(copy.toYAML(restoredStream));
+  originalStream.flush(); restoredStream.flush();
+  QCOMPARE(restored, original);
+
+  // Corrupted snapshots must be rejected
+  QByteArray data;
+  QVERIFY(ConfigSnapshot::encode(&_config, data));
+  Config decoded;
+  QVERIFY(ConfigSnapshot::decode(data.constData(), data.size(), &decoded));
+  QVERIFY(! ConfigSnapshot::decode(data.constData(), data.size()-1, &decoded));
+}
+
+void
+ConfigTest::testSnapshotProperties() {
+  QByteArray data;
+  Config copy;
+  ErrorStack err;
+  if ((! ConfigSnapshot::encode(&_config, data, err)) ||
+      (! ConfigSnapshot::decode(data.constData(), data.size(), &copy, err)))
+    QFAIL(QString("Cannot copy codeplug: %1").arg(err.format()).toStdString().c_str());
+
+  // Every property of every element must be restored
+  QString msg;
+  QHash<const QObject *, const QObject *> map;
+  QList<QPair<const QObject *, const QObject *>> refs;
+  QVERIFY2(compareProperties(&_config, &copy, map, refs, msg), msg.toStdString().c_str());
+
+  // References must point to the copies of the referenced elements, singletons to themselves
+  typedef QPair<const QObject *, const QObject *> Ref;
+  foreach (Ref ref, refs) {
+    QVERIFY((nullptr == ref.first) == (nullptr == ref.second));
+    if (nullptr == ref.first)
+      continue;
+    QVERIFY(map.value(ref.first, ref.first) == ref.second);
+  }
+}
+
+void
+ConfigTest::testHistory() {
+  ErrorStack err;
+  Config config;
+  if (! config.readYAML(":/data/config_test.yaml", err))
+    QFAIL(QString("Cannot open codeplug file: %1").arg(err.format()).toStdString().c_str());
+  ConfigHistory history(&config);
+  QVERIFY(! history.canUndo());
+
+  QString original, modified, current;
+  QTextStream originalStream(&original), modifiedStream(&modified);
+  QVERIFY(config.toYAML(originalStream));
+  originalStream.flush();
+
+  // Modify a channel
+  config.channelList()->channel(0)->setName("Modified");
+  history.commit();
+  // Delete a contact, referenced by channels and group lists
+  config.contacts()->del(config.contacts()->contact(0));
+  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+  history.commit();
+
+  QVERIFY(config.toYAML(modifiedStream));
+  modifiedStream.flush();
+  QVERIFY(modified != original);
+
+  // Undo must restore the deleted contact and all references to it
+  if ((! history.undo(err)) || (! history.undo(err)))
+    QFAIL(QString("Cannot undo: %1").arg(err.format()).toStdString().c_str());
+  QVERIFY(! history.canUndo());
+  QTextStream undoStream(&current);
+  QVERIFY(config.toYAML(undoStream));
+  undoStream.flush();
+  QCOMPARE(current, original);
+
+  // Redo must reproduce the modified config
+  if ((! history.redo(err)) || (! history.redo(err)))
+    QFAIL(QString("Cannot redo: %1").arg(err.format()).toStdString().c_str());
+  QVERIFY(! history.canRedo());
+  current.clear();
+  QTextStream redoStream(&current);
+  QVERIFY(config.toYAML(redoStream));
+  redoStream.flush();
+  QCOMPARE(current, modified);
+}
+
+void
+ConfigTest::testFreeze() {
+  ErrorStack err;
+  Config config;
+  if (! config.readYAML(":/data/config_test.yaml", err))
+    QFAIL(QString("Cannot open codeplug file: %1").arg(err.format()).toStdString().c_str());
+
+  Config *frozen = config.freeze(err);
+  if (nullptr == frozen)
+    QFAIL(QString("Cannot freeze codeplug: %1").arg(err.format()).toStdString().c_str());
+  QVERIFY(frozen->isFrozen());
+  QVERIFY(! frozen->isModified());
+
+  QString original, copy;
+  QTextStream originalStream(&original), copyStream(&copy);
+  QVERIFY(config.toYAML(originalStream));
+  originalStream.flush();
+  QVERIFY(frozen->toYAML(copyStream));
+  copyStream.flush();
+  QCOMPARE(copy, original);
+
+  // The frozen copy must not share any objects with the config
+  DMRChannel *channel = config.channelList()->channel(0)->as<DMRChannel>();
+  DMRChannel *frozenChannel = frozen->channelList()->channel(0)->as<DMRChannel>();
+  QVERIFY(channel && frozenChannel);
+  QVERIFY(frozen->contacts()->has(frozenChannel->txContactObj()));
+  QVERIFY(! config.contacts()->has(frozenChannel->txContactObj()));
+
+  // Modifying the config must not affect the frozen copy
+  channel->setName("Modified");
+  QVERIFY(frozenChannel->name() != "Modified");
+
+  delete frozen;
+}
+
 
 QTEST_GUILESS_MAIN(ConfigTest)
 
@@ -17,6 +17,14 @@ private slots:
   void cleanupTestCase();
 
   void testCloneChannelBasic();
+  void testListIndex();
+  void testLookupIndex();
+  void testTransaction();
+  void testNextId();
+  void testSnapshot();
+  void testSnapshotProperties();
+  void testHistory();
+  void testFreeze();
 
 protected:
   Config _config;
@@ -55,5 +55,136 @@ D868UVETest::testBasicConfigDecoding() {
   }
 }
 
+void
+D868UVETest::testManyContactsDecoding() {
+  ErrorStack err;
+  Config config;
+  if (! config.readYAML(":/data/config_test.yaml", err)) {
+    QFAIL(QString("Cannot open codeplug file: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+  // Enough contacts to get decoded concurrently
+  for (int i=0; i<2000; i++)
+    config.contacts()->add(new DMRContact(DMRContact::PrivateCall, QString("Contact %1").arg(i), 1000000+i));
+
+  Codeplug::Flags flags; flags.updateCodePlug=false;
+  D868UVCodeplug codeplug;
+  if (! codeplug.encode(&config, flags, err)) {
+    QFAIL(QString("Cannot encode codeplug for AnyTone AT-D868UVE: {}")
+          .arg(err.format()).toStdString().c_str());
+  }
+
+  Config decoded;
+  if (! codeplug.decode(&decoded, err)) {
+    QFAIL(QString("Cannot decode codeplug for AnyTone AT-D868UVE: {}")
+          .arg(err.format()).toStdString().c_str());
+  }
+
+  // Contacts must be decoded in order
+  QCOMPARE(decoded.contacts()->digitalCount(), config.contacts()->digitalCount());
+  for (int i=0; i<config.contacts()->digitalCount(); i++) {
+    QCOMPARE(decoded.contacts()->digitalContact(i)->name(), config.contacts()->digitalContact(i)->name());
+    QCOMPARE(decoded.contacts()->digitalContact(i)->number(), config.contacts()->digitalContact(i)->number());
+    QCOMPARE(decoded.contacts()->digitalContact(i)->type(), config.contacts()->digitalContact(i)->type());
+  }
+}
+
+void
+D868UVETest::testChannelElementFields() {
+  uint8_t data[0x40];
+  memset(data, 0x00, sizeof(data));
+  D868UVCodeplug::ChannelElement ch(data);
+
+  ch.enableRanging(true);
+  ch.enableDataACK(false);
+  ch.setDigitalAPRSSystemIndex(7);
+  ch.enableMultipleKeyEncryption(true);
+  ch.enableSMS(true);
+  QCOMPARE(data[0x34], uint8_t(0b101));
+  QCOMPARE(data[0x36], uint8_t(7));
+  QCOMPARE(data[0x3b], uint8_t(0b001));
+
+  // Fields must agree with the generic accessors
+  QCOMPARE(ch.ranging(), ch.getBit(0x0034, 0));
+  QCOMPARE(ch.dataACK(), !ch.getBit(0x0034, 2));
+  QCOMPARE(ch.digitalAPRSSystemIndex(), unsigned(ch.getUInt8(0x0036)));
+  QCOMPARE(ch.multipleKeyEncryption(), ch.getBit(0x003b, 0));
+  QCOMPARE(ch.sms(), !ch.getBit(0x003b, 2));
+
+  // Enabling SMS must not touch multiple key encryption
+  ch.enableSMS(false);
+  QCOMPARE(ch.multipleKeyEncryption(), true);
+  QCOMPARE(ch.sms(), false);
+
+  // Frequencies are stored as BCD in 10Hz
+  ch.setRXFrequency(439125000);
+  ch.setTXFrequency(431525000);
+  QCOMPARE(ch.getBCD8_be(0x0000), uint32_t(43912500));
+  QCOMPARE(ch.getBCD8_be(0x0004), uint32_t(760000));
+  QCOMPARE(data[0x00], uint8_t(0x43)); QCOMPARE(data[0x03], uint8_t(0x00));
+  QCOMPARE(ch.rxFrequency(), 439125000U);
+  QCOMPARE(ch.txFrequency(), 431525000U);
+  QVERIFY(AnytoneCodeplug::ChannelElement::RepeaterMode::Negative == ch.repeaterMode());
+  QCOMPARE(unsigned(ch.getUInt2(0x0008, 6)), unsigned(AnytoneCodeplug::ChannelElement::RepeaterMode::Negative));
+  ch.setTimeSlot(DMRChannel::TimeSlot::TS2);
+  ch.setContactIndex(0x12345);
+  QCOMPARE(ch.getBit(0x0021, 0), true);
+  QCOMPARE(ch.getUInt32_le(0x0014), uint32_t(0x12345));
+
+  // BCD codec
+  QCOMPARE(CodeplugField::fromBCD(CodeplugField::toBCD(43912500)), 43912500U);
+}
+
+void
+D868UVETest::benchmarkChannelElementFields_data() {
+  QTest::addColumn<bool>("descriptors");
+  QTest::newRow("generic") << false;
+  QTest::newRow("descriptors") << true;
+}
+
+void
+D868UVETest::benchmarkChannelElementFields() {
+  // Writes and reads back the frequencies and some other fields of 4000 channel elements
+  typedef D868UVCodeplug::ChannelElement::Fields Fields;
+  QFETCH(bool, descriptors);
+  const int n = 4000;
+  QByteArray buffer(n*0x40, 0x00);
+  uint32_t sum = 0;
+
+  QBENCHMARK {
+    for (int i=0; i<n; i++) {
+      D868UVCodeplug::ChannelElement ch((uint8_t *)buffer.data()+i*0x40);
+      uint32_t rx = 43000000+i*125;
+      if (descriptors) {
+        ch.set<Fields::RXFrequency>(rx);
+        ch.set<Fields::TXOffset>(760000);
+        ch.set<Fields::OffsetDirection>(2);
+        ch.set<Fields::ColorCode>(i%16);
+        ch.set<Fields::TimeSlot2>(i&1);
+        ch.set<Fields::ContactIndex>(i);
+        sum += ch.get<Fields::RXFrequency>() + ch.get<Fields::TXOffset>()
+            + ch.get<Fields::OffsetDirection>() + ch.get<Fields::ColorCode>()
+            + ch.get<Fields::TimeSlot2>() + ch.get<Fields::ContactIndex>();
+      } else {
+        ch.setBCD8_be(0x0000, rx);
+        ch.setBCD8_be(0x0004, 760000);
+        ch.setUInt2(0x0008, 6, 2);
+        ch.setUInt8(0x0020, i%16);
+        ch.setBit(0x0021, 0, i&1);
+        ch.setUInt32_le(0x0014, i);
+        sum += ch.getBCD8_be(0x0000) + ch.getBCD8_be(0x0004)
+            + ch.getUInt2(0x0008, 6) + ch.getUInt8(0x0020)
+            + ch.getBit(0x0021, 0) + ch.getUInt32_le(0x0014);
+      }
+    }
+  }
+
+  // Both variants must produce the same elements
+  D868UVCodeplug::ChannelElement last((uint8_t *)buffer.data()+(n-1)*0x40);
+  QCOMPARE(last.rxFrequency(), unsigned(43000000+(n-1)*125)*10);
+  QCOMPARE(last.colorCode(), unsigned((n-1)%16));
+  QVERIFY(0 != sum);
+}
+
 QTEST_GUILESS_MAIN(D868UVETest)
 
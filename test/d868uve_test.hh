@@ -18,6 +18,10 @@ private slots:
 
   void testBasicConfigEncoding();
   void testBasicConfigDecoding();
+  void testManyContactsDecoding();
+  void testChannelElementFields();
+  void benchmarkChannelElementFields_data();
+  void benchmarkChannelElementFields();
 
 protected:
   Config _basicConfig;
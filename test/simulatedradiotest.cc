@@ -0,0 +1,271 @@
+#include "simulatedradiotest.hh"
+#include "config.hh"
+#include "d868uv.hh"
+#include "simulatedradiointerface.hh"
+#include "errorstack.hh"
+#include "codeplugcache.hh"
+#include "dfufile.hh"
+#include "configverifier.hh"
+#include "userdatabase.hh"
+#include "callsigndb.hh"
+#include <QTest>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QDir>
+
+SimulatedRadioTest::SimulatedRadioTest(QObject *parent)
+  : QObject(parent)
+{
+  // pass...
+}
+
+void
+SimulatedRadioTest::initTestCase() {
+  // Keep codeplug caches and checkpoints away from the user data
+  QStandardPaths::setTestModeEnabled(true);
+
+  ErrorStack err;
+  if (! _basicConfig.readYAML(":/data/config_test.yaml", err)) {
+    QFAIL(QString("Cannot open codeplug file: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+}
+
+void
+SimulatedRadioTest::cleanupTestCase() {
+  // clear codeplug
+  _basicConfig.clear();
+}
+
+void
+SimulatedRadioTest::testAnytoneUploadDownload() {
+  ErrorStack err;
+  SimulatedRadioInterface::Memory memory;
+
+  // Upload codeplug into simulated device
+  {
+    SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE));
+    D868UV radio(dev);
+    Codeplug::Flags flags; flags.updateCodePlug = false;
+    if (! radio.startUpload(&_basicConfig, true, flags, err)) {
+      QFAIL(QString("Cannot upload codeplug to simulated AnyTone AT-D868UVE: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+    QVERIFY(0 < dev->statistics().bytesWritten);
+    memory = dev->memory();
+  }
+
+  // Download codeplug from simulated device
+  SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE), memory);
+  D868UV radio(dev);
+  if (! radio.startDownload(true, err)) {
+    QFAIL(QString("Cannot download codeplug from simulated AnyTone AT-D868UVE: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+
+  Config config;
+  if (! radio.codeplug().decode(&config, err)) {
+    QFAIL(QString("Cannot decode codeplug from simulated AnyTone AT-D868UVE: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+  QCOMPARE(config.channelList()->count(), _basicConfig.channelList()->count());
+  QCOMPARE(config.contacts()->count(), _basicConfig.contacts()->count());
+}
+
+void
+SimulatedRadioTest::testTransferError() {
+  ErrorStack err;
+  SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE));
+  dev->failAt(0);
+  D868UV radio(dev);
+  QVERIFY(! radio.startDownload(true, err));
+  QCOMPARE(radio.status(), Radio::StatusError);
+  QCOMPARE(dev->statistics().errors, 1U);
+}
+
+void
+SimulatedRadioTest::testResumeCallsignUpload() {
+  ErrorStack err;
+
+  // Provide a local user DB, this prevents the download
+  QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+  QVERIFY(QDir().mkpath(path));
+  QJsonArray users;
+  for (unsigned i=0; i<1000; i++) {
+    QJsonObject user;
+    user.insert("id", int(2621000+i));
+    user.insert("callsign", QString("DM%1ABC").arg(i%10));
+    user.insert("fname", QString("User %1").arg(i));
+    users.append(user);
+  }
+  QJsonObject doc; doc.insert("users", users);
+  QFile file(path + "/user.json");
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write(QJsonDocument(doc).toJson());
+  file.close();
+  UserDatabase db;
+  QCOMPARE(db.count(), qint64(1000));
+
+  // Reference upload, without interruption
+  SimulatedRadioInterface::Memory expected;
+  unsigned totalWrites = 0;
+  {
+    SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE));
+    D868UV radio(dev);
+    if (! radio.startUploadCallsignDB(&db, true, CallsignDB::Selection(), err)) {
+      QFAIL(QString("Cannot upload callsign DB to simulated AnyTone AT-D868UVE: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+    expected = dev->memory();
+    totalWrites = dev->statistics().writes;
+  }
+  QVERIFY(100 < totalWrites);
+
+  // Interrupt upload halfway, this leaves a checkpoint
+  SimulatedRadioInterface::Memory memory;
+  unsigned writesBefore = 0;
+  {
+    SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE));
+    dev->failAt(totalWrites/2);
+    D868UV radio(dev);
+    radio.setResume(true);
+    QVERIFY(! radio.startUploadCallsignDB(&db, true, CallsignDB::Selection(), err));
+    QCOMPARE(radio.status(), Radio::StatusError);
+    memory = dev->memory();
+    writesBefore = dev->statistics().writes;
+  }
+  QCOMPARE(writesBefore, totalWrites/2);
+  QVERIFY(memory != expected);
+
+  // Resume upload, only the remaining blocks must be written
+  SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE), memory);
+  D868UV radio(dev);
+  radio.setResume(true);
+  if (! radio.startUploadCallsignDB(&db, true, CallsignDB::Selection(), err)) {
+    QFAIL(QString("Cannot resume callsign DB upload to simulated AnyTone AT-D868UVE: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+  QCOMPARE(dev->statistics().writes, totalWrites-writesBefore);
+  QVERIFY(dev->memory() == expected);
+}
+
+void
+SimulatedRadioTest::testCachedUpdate() {
+  ErrorStack err;
+  SimulatedRadioInterface::Memory memory;
+
+  // Initialize codeplug in simulated device, this also fills the cache
+  {
+    SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE));
+    D868UV radio(dev);
+    Codeplug::Flags flags; flags.updateCodePlug = false;
+    if (! radio.startUpload(&_basicConfig, true, flags, err)) {
+      QFAIL(QString("Cannot upload codeplug to simulated AnyTone AT-D868UVE: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+    memory = dev->memory();
+  }
+
+  // Update codeplug using the cache
+  size_t cachedBytes = 0;
+  {
+    SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE), memory);
+    D868UV radio(dev);
+    if (! radio.startUpload(&_basicConfig, true, Codeplug::Flags(), err)) {
+      QFAIL(QString("Cannot update codeplug on simulated AnyTone AT-D868UVE: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+    cachedBytes = dev->statistics().bytesRead;
+    // Invalidate cache for next update
+    CodeplugCache(radio.name()).clear();
+  }
+
+  // Update codeplug without cache
+  SimulatedRadioInterface *dev = new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE), memory);
+  D868UV radio(dev);
+  if (! radio.startUpload(&_basicConfig, true, Codeplug::Flags(), err)) {
+    QFAIL(QString("Cannot update codeplug on simulated AnyTone AT-D868UVE: %1")
+          .arg(err.format()).toStdString().c_str());
+  }
+  QVERIFY(cachedBytes < dev->statistics().bytesRead);
+}
+
+void
+SimulatedRadioTest::testCacheVerify() {
+  ErrorStack err;
+  // A single large element like the TyT codeplugs
+  DFUFile image; image.addImage("Image 0", 0);
+  image.image(0).addElement(0x00000000, 0x40000);
+  uint8_t *data = (uint8_t *)image.image(0).element(0).data().data();
+  for (int i=0; i<0x40000; i++)
+    data[i] = uint8_t(i*31);
+
+  CodeplugCache cache("Cache Verify Test");
+  if (! cache.store(image, err))
+    QFAIL(QString("Cannot store codeplug cache: %1").arg(err.format()).toStdString().c_str());
+
+  SimulatedRadioInterface dev(RadioInfo::byID(RadioInfo::MD390));
+  QVERIFY(dev.write(0, 0x00000000, data, 0x40000, err));
+  QVERIFY(CodeplugCache("Cache Verify Test").verify(&dev, image, 0, 32, 0x400, err));
+
+  // A change at the end of the element must be detected
+  uint8_t modified = data[0x3ff00]^0xff;
+  QVERIFY(dev.write(0, 0x3ff00, &modified, 1, err));
+  QVERIFY(! CodeplugCache("Cache Verify Test").verify(&dev, image, 0, 32, 0x400, err));
+
+  CodeplugCache("Cache Verify Test").clear();
+}
+
+void
+SimulatedRadioTest::testVerifierCache() {
+  ErrorStack err;
+  ConfigVerifier verifier(&_basicConfig);
+  QSignalSpy updated(&verifier, SIGNAL(updated()));
+  Codeplug::Flags flags; flags.updateCodePlug = false;
+
+  // First upload, the complete configuration gets verified in the background
+  {
+    D868UV radio(new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE)));
+    verifier.setRadio(&radio);
+    QVERIFY(! verifier.isUpToDate());
+    QVERIFY(updated.wait());
+    verifier.issues();
+    if (! radio.startUpload(&_basicConfig, true, flags, err)) {
+      QFAIL(QString("Cannot upload codeplug to simulated AnyTone AT-D868UVE: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+  }
+
+  // Limits outlive the radio
+  const RadioLimits *limits = verifier.limits();
+  QVERIFY(nullptr != limits);
+  QVERIFY(verifier.isUpToDate());
+
+  // Second upload to a radio of the same model, cached results are kept
+  {
+    D868UV radio(new SimulatedRadioInterface(RadioInfo::byID(RadioInfo::D868UVE)));
+    verifier.setRadio(&radio);
+    QCOMPARE(verifier.limits(), limits);
+    QVERIFY(verifier.isUpToDate());
+    verifier.issues();
+    if (! radio.startUpload(&_basicConfig, true, flags, err)) {
+      QFAIL(QString("Cannot upload codeplug to simulated AnyTone AT-D868UVE: %1")
+            .arg(err.format()).toStdString().c_str());
+    }
+  }
+  QCOMPARE(updated.count(), 1);
+
+  // Only modified elements get verified again
+  Channel *channel = _basicConfig.channelList()->channel(0);
+  QString name = channel->name();
+  channel->setName("Modified");
+  QVERIFY(! verifier.isUpToDate());
+  QVERIFY(updated.wait());
+  channel->setName(name);
+}
+
+QTEST_GUILESS_MAIN(SimulatedRadioTest)
@@ -0,0 +1,29 @@
+#ifndef SIMULATEDRADIOTEST_HH
+#define SIMULATEDRADIOTEST_HH
+
+#include <QObject>
+#include "config.hh"
+
+class SimulatedRadioTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit SimulatedRadioTest(QObject *parent = nullptr);
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+
+  void testAnytoneUploadDownload();
+  void testTransferError();
+  void testResumeCallsignUpload();
+  void testCachedUpdate();
+  void testCacheVerify();
+  void testVerifierCache();
+
+protected:
+  Config _basicConfig;
+};
+
+#endif // SIMULATEDRADIOTEST_HH
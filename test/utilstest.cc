@@ -1,7 +1,11 @@
 #include "utilstest.hh"
 
 #include <QTest>
+#include <QVector>
+#include <cstring>
 #include "utils.hh"
+#include "frequency.hh"
+#include "bitmapiterator.hh"
 
 UtilsTest::UtilsTest(QObject *parent) : QObject(parent)
 {
@@ -39,6 +43,58 @@ UtilsTest::testDecodeASCII() {
   QCOMPARE(res, QString("abc"));
 }
 
+void
+UtilsTest::testDecodeUTF8() {
+  const char *testString = "abc\xc3\xa4\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00";
+  QCOMPARE(decode_utf8((const uint8_t *)testString, 16), QString("abcä"));
+}
+
+void
+UtilsTest::testEncodeUTF8() {
+  QByteArray bufferTrue("abc\xc3\xa4\xff\xff\xff", 8), bufferTest(8, 0x00);
+  encode_utf8((uint8_t *)bufferTest.data(), QString("abcä"), 8, 0xff);
+  QCOMPARE(bufferTest, bufferTrue);
+  // Truncated strings must not end within a multi-byte sequence
+  QByteArray truncTrue("abc\xff", 4), truncTest(4, 0x00);
+  encode_utf8((uint8_t *)truncTest.data(), QString("abcä"), 4, 0xff);
+  QCOMPARE(truncTest, truncTrue);
+}
+
+void
+UtilsTest::testFindEOS() {
+  // The word-wise search reads whole words, hence the buffer must cover the full size
+  uint8_t text[32];
+  memset(text, 0xff, sizeof(text));
+  memcpy(text, "0123456789abcdef", 16);
+  for (unsigned i=0; i<17; i++)
+    QCOMPARE(find_eos8(text, i, 0xff), size_t(i));
+  QCOMPARE(find_eos8(text, sizeof(text), 0xff), size_t(16));
+  QCOMPARE(find_eos8(text, sizeof(text), 'a'), size_t(10));
+
+  QString unicode("abcdefghi");
+  QCOMPARE(find_eos16((const uint16_t *)unicode.utf16(), 10, 0x0000), size_t(9));
+  QCOMPARE(find_eos16((const uint16_t *)unicode.utf16(), 9, 'f'), size_t(5));
+}
+
+void
+UtilsTest::benchmarkEncodeCallsigns() {
+  // Encodes and decodes name and city of 200k callsign DB entries
+  QVector<QString> names(200000);
+  for (int i=0; i<names.size(); i++)
+    names[i] = QString("DM%1ABC Someone from Somewhere").arg(i);
+  QByteArray buffer(names.size()*32, 0x00);
+
+  QBENCHMARK {
+    uint8_t *ptr = (uint8_t *)buffer.data();
+    for (int i=0; i<names.size(); i++, ptr+=32)
+      encode_ascii(ptr, names[i], 32, 0x00);
+    ptr = (uint8_t *)buffer.data();
+    for (int i=0; i<names.size(); i++, ptr+=32)
+      decode_ascii(ptr, 32, 0x00);
+  }
+  QCOMPARE(decode_ascii((const uint8_t *)buffer.data(), 32), names[0].left(32));
+}
+
 void
 UtilsTest::testDecodeFrequency() {
   uint32_t bcd = 0x12345678U;
@@ -55,6 +111,24 @@ UtilsTest::testEncodeFrequency() {
   QCOMPARE(decode_frequency(encode_frequency(439.5630)), 439.5630);
 }
 
+void
+UtilsTest::testFrequency() {
+  // Rounded to Hz, a plain truncation of 256.025*1e6 yields 256024999Hz
+  QCOMPARE(Frequency::fromMHz(256.025).inHz(), Q_INT64_C(256025000));
+  QCOMPARE(Frequency::fromMHz(256.025).toBCD8(), 0x25602500U);
+  QCOMPARE(Frequency::fromkHz(145612.5), Frequency::fromHz(145612500));
+
+  // BCD round trip
+  QCOMPARE(Frequency::fromBCD8(0x43956300U), Frequency::fromMHz(439.563));
+  QCOMPARE(Frequency::fromBCD8(0x43956300U).toBCD8(), 0x43956300U);
+
+  // Exact comparison and hashing
+  QVERIFY(Frequency::fromMHz(145.6125) == Frequency::fromHz(145612500));
+  QVERIFY(Frequency::fromMHz(145.6125) != Frequency::fromHz(145612510));
+  QCOMPARE(qHash(Frequency::fromMHz(145.6125)), qHash(Frequency::fromHz(145612500)));
+  QCOMPARE((Frequency::fromMHz(439.5) - Frequency::fromMHz(430.1)).inHz(), Q_INT64_C(9400000));
+}
+
 void
 UtilsTest::testDecodeDMRID_bcd() {
   uint8_t bcd[4] = {0x12, 0x34, 0x56, 0x78};
@@ -71,5 +145,24 @@ UtilsTest::testEncodeDMRID_bcd() {
   QCOMPARE(res, QByteArray(bcd, 4));
 }
 
+void
+UtilsTest::testBitmapIterator() {
+  // Entries 0, 9, 63, 64 and 129 of 130
+  uint8_t bitmap[17] = {0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00,
+                        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe};
+  QList<unsigned> indices;
+  for (BitmapIterator i(bitmap, 130); i.isValid(); i.next())
+    indices.append(i.index());
+  QCOMPARE(indices, QList<unsigned>({0, 9, 63, 64, 129}));
+  QCOMPARE(BitmapIterator::count(bitmap, 130), 5U);
+
+  // Inverted bitmap of 12 entries, cleared bits mark enabled entries
+  uint8_t inverted[2] = {0xfe, 0xf7};
+  indices.clear();
+  for (BitmapIterator i(inverted, 12, true); i.isValid(); i.next())
+    indices.append(i.index());
+  QCOMPARE(indices, QList<unsigned>({0, 11}));
+}
+
 
 QTEST_GUILESS_MAIN(UtilsTest)
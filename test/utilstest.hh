@@ -14,10 +14,16 @@ private slots:
   void testEncodeUnicode();
   void testDecodeASCII();
   void testEncodeASCII();
+  void testDecodeUTF8();
+  void testEncodeUTF8();
+  void testFindEOS();
+  void benchmarkEncodeCallsigns();
   void testDecodeFrequency();
   void testEncodeFrequency();
+  void testFrequency();
   void testDecodeDMRID_bcd();
   void testEncodeDMRID_bcd();
+  void testBitmapIterator();
 };
 
 #endif // UTILSTEST_HH